@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRRect.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/ganesh/SkImageGanesh.h"
 #include "src/base/SkRandom.h"
@@ -29,7 +30,8 @@ enum class ImageMode {
 enum class DrawMode {
     kBatch,  // Bulk API submission, one call to draw every rectangle
     kRef,    // One standard SkCanvas draw call per rectangle
-    kQuad    // One experimental draw call per rectangle, only for solid color draws
+    kQuad,   // One experimental draw call per rectangle, only for solid color draws
+    kRRectSet // SkCanvas rrect set API, one call for every rectangle, only for solid color draws
 };
 //   X
 enum class RectangleLayout {
@@ -43,6 +45,8 @@ class BulkRectBench : public Benchmark {
 public:
     static_assert(kImageMode == ImageMode::kNone || kDrawMode != DrawMode::kQuad,
                   "kQuad only supported for solid color draws");
+    static_assert(kImageMode == ImageMode::kNone || kDrawMode != DrawMode::kRRectSet,
+                  "kRRectSet only supported for solid color draws");
 
     inline static constexpr int kWidth      = 1024;
     inline static constexpr int kHeight     = 1024;
@@ -65,6 +69,7 @@ protected:
     SkRect         fRects[kRectCount];
     sk_sp<SkImage> fImages[kImageCount > 0 ? kImageCount : 1];
     SkColor4f      fColors[kRectCount];
+    SkRRect        fRRects[kRectCount];
     SkString       fName;
 
     void computeName()  {
@@ -86,8 +91,10 @@ protected:
             fName.append("_batch");
         } else if (kDrawMode == DrawMode::kRef) {
             fName.append("_ref");
-        } else {
+        } else if (kDrawMode == DrawMode::kQuad) {
             fName.append("_quad");
+        } else {
+            fName.append("_rrectset");
         }
     }
 
@@ -157,6 +164,15 @@ protected:
         sdc->drawQuadSet(nullptr, std::move(grPaint), view, batch, kRectCount);
     }
 
+    void drawSolidColorsRRectSet(SkCanvas* canvas) const {
+        SkASSERT(kImageMode == ImageMode::kNone);
+        SkASSERT(kDrawMode == DrawMode::kRRectSet);
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas->experimental_DrawRRectSet(fRRects, fColors, kRectCount, nullptr, paint);
+    }
+
     void drawSolidColorsRef(SkCanvas* canvas) const {
         SkASSERT(kImageMode == ImageMode::kNone);
         SkASSERT(kDrawMode == DrawMode::kRef || kDrawMode == DrawMode::kQuad);
@@ -213,6 +229,7 @@ protected:
             SkASSERT(SkRect::MakeWH(kWidth, kHeight).contains(fRects[i]));
 
             fColors[i] = {rand.nextF(), rand.nextF(), rand.nextF(), 1.f};
+            fRRects[i].setRect(fRects[i]);
         }
     }
 
@@ -249,6 +266,8 @@ protected:
             if (kImageMode == ImageMode::kNone) {
                 if (kDrawMode == DrawMode::kBatch) {
                     this->drawSolidColorsBatch(canvas);
+                } else if (kDrawMode == DrawMode::kRRectSet) {
+                    this->drawSolidColorsRRectSet(canvas);
                 } else {
                     this->drawSolidColorsRef(canvas);
                 }
@@ -280,7 +299,8 @@ protected:
     ADD_BENCH(n, layout, ImageMode::kUnique, DrawMode::kRef)                   \
     ADD_BENCH(n, layout, ImageMode::kNone,   DrawMode::kBatch)                 \
     ADD_BENCH(n, layout, ImageMode::kNone,   DrawMode::kRef)                   \
-    ADD_BENCH(n, layout, ImageMode::kNone,   DrawMode::kQuad)
+    ADD_BENCH(n, layout, ImageMode::kNone,   DrawMode::kQuad)                  \
+    ADD_BENCH(n, layout, ImageMode::kNone,   DrawMode::kRRectSet)
 
 ADD_BENCH_FAMILY(1000,  RectangleLayout::kRandom)
 ADD_BENCH_FAMILY(1000,  RectangleLayout::kGrid)
@@ -47,3 +47,44 @@ DEF_BENCH( return new CanvasSaveRestoreBench(8);)
 DEF_BENCH( return new CanvasSaveRestoreBench(32);)
 DEF_BENCH( return new CanvasSaveRestoreBench(128);)
 DEF_BENCH( return new CanvasSaveRestoreBench(512);)
+
+// Intersects a clip at each level, so that draws at the bottom sit under a deep clip stack.
+class CanvasSaveClipRestoreBench : public Benchmark {
+public:
+    CanvasSaveClipRestoreBench(int depth) : fDepth(depth) {
+        fName.printf("canvas_save_clip_restore_%d", fDepth);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return { 256, 256 }; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(SK_ColorCYAN);
+
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < fDepth; ++j) {
+                canvas->save();
+                const float inset = j * 0.25f;
+                canvas->clipRect(SkRect::MakeLTRB(inset, inset, 256 - inset, 256 - inset),
+                                 (j & 7) == 0);
+            }
+            for (int k = 0; k < 16; ++k) {
+                canvas->drawRect(SkRect::MakeXYWH(100 + k, 100, 8, 8), paint);
+            }
+            for (int j = 0; j < fDepth; ++j) {
+                canvas->restore();
+            }
+        }
+    }
+
+private:
+    const int fDepth;
+    SkString fName;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new CanvasSaveClipRestoreBench(8);)
+DEF_BENCH( return new CanvasSaveClipRestoreBench(128);)
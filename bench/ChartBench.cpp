@@ -9,9 +9,12 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
 #include "include/private/base/SkTDArray.h"
 #include "src/base/SkRandom.h"
 
+#include <vector>
+
 /**
  * This is a conversion of samplecode/SampleChart.cpp into a bench. It sure would be nice to be able
  * to write one subclass that can be a GM, bench, and/or Sample.
@@ -189,3 +192,72 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+
+// A scatter plot of many small circles, one color per series. Compares drawing every point with
+// its own drawCircle call against submitting the whole plot with experimental_DrawRRectSet.
+class ScatterChartBench : public Benchmark {
+public:
+    ScatterChartBench(bool batched) : fBatched(batched) {}
+
+protected:
+    const char* onGetName() override {
+        return fBatched ? "chart_scatter_batched" : "chart_scatter_ref";
+    }
+
+    SkISize onGetSize() override { return {kWidth, kHeight}; }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        SkColor4f seriesColors[kNumSeries];
+        for (SkColor4f& color : seriesColors) {
+            color = SkColor4f::FromColor(random.nextU() | 0xff000000);
+        }
+
+        fCircles.resize(kNumPoints);
+        fColors.resize(kNumPoints);
+        for (int i = 0; i < kNumPoints; ++i) {
+            // Each series is a noisy line across the plot.
+            int series = i % kNumSeries;
+            SkScalar x = random.nextRangeScalar(0, kWidth);
+            SkScalar y = (series + 1) * kHeight / (kNumSeries + 1.f) +
+                         random.nextRangeScalar(-kSpread, kSpread) + x * 0.1f;
+            fCircles[i].setOval(SkRect::MakeXYWH(x - kRadius, y - kRadius, 2 * kRadius,
+                                                 2 * kRadius));
+            fColors[i] = seriesColors[series];
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int frame = 0; frame < loops; ++frame) {
+            if (fBatched) {
+                canvas->experimental_DrawRRectSet(fCircles.data(), fColors.data(), kNumPoints,
+                                                  nullptr, paint);
+            } else {
+                for (int i = 0; i < kNumPoints; ++i) {
+                    paint.setColor(fColors[i]);
+                    const SkRect& r = fCircles[i].rect();
+                    canvas->drawCircle(r.centerX(), r.centerY(), kRadius, paint);
+                }
+            }
+        }
+    }
+
+private:
+    inline static constexpr int      kWidth = 1024;
+    inline static constexpr int      kHeight = 1024;
+    inline static constexpr int      kNumSeries = 8;
+    inline static constexpr int      kNumPoints = 100000;
+    inline static constexpr SkScalar kRadius = 1.5f;
+    inline static constexpr SkScalar kSpread = 40.f;
+
+    bool                   fBatched;
+    std::vector<SkRRect>   fCircles;
+    std::vector<SkColor4f> fColors;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new ScatterChartBench(true); )
+DEF_BENCH( return new ScatterChartBench(false); )
@@ -8,6 +8,8 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "src/core/SkClipStack.h"
 
 class ClipStrategyBench : public Benchmark {
 public:
@@ -88,3 +90,53 @@ DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 1  );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 5  );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 10 );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 100);)
+
+// Nests 'depth' rect and rrect clips, as a recorded UI tree does, and then makes the queries a
+// clip stack device makes for each draw under them.
+class DeepClipStackBench : public Benchmark {
+public:
+    explicit DeepClipStackBench(int depth) : fDepth(depth) {
+        fName.printf("clip_strategy_deep_stack_%d", depth);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr int kDraws = 100;
+        const SkRect draw = SkRect::MakeXYWH(fDepth + 10, fDepth + 10, 20, 20);
+
+        for (int i = 0; i < loops; ++i) {
+            SkClipStack stack;
+            for (int j = 0; j < fDepth; ++j) {
+                stack.save();
+                const SkRect r = SkRect::MakeLTRB(j, j, 1000 - j, 1000 - j);
+                if (j & 1) {
+                    stack.clipRRect(SkRRect::MakeRectXY(r, 4, 4), SkMatrix::I(),
+                                    SkClipOp::kIntersect, true);
+                } else {
+                    stack.clipRect(r, SkMatrix::I(), SkClipOp::kIntersect, false);
+                }
+            }
+
+            int contained = 0;
+            for (int k = 0; k < kDraws; ++k) {
+                SkRRect rrect;
+                contained += stack.quickContains(draw);
+                contained += stack.isAnyAA();
+                contained += stack.isRRect(SkRect::MakeWH(1000, 1000), &rrect, nullptr);
+            }
+            fContained = contained;
+        }
+    }
+
+private:
+    const int fDepth;
+    SkString  fName;
+    int       fContained = 0;
+};
+
+DEF_BENCH( return new DeepClipStackBench(8  );)
+DEF_BENCH( return new DeepClipStackBench(64 );)
+DEF_BENCH( return new DeepClipStackBench(512);)
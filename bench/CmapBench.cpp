@@ -15,6 +15,8 @@
 #include "src/utils/SkCharToGlyphCache.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
+
 enum {
     NGLYPHS = 100
 };
@@ -22,9 +24,12 @@ enum {
 namespace {
 struct Rec {
     const SkCharToGlyphCache&   fCache;
+    const SkCharToGlyphPages&   fPages;
     int                         fLoops;
     const SkFont&               fFont;
     const SkUnichar*            fText;
+    const char*                 fUTF8;
+    size_t                      fUTF8Length;
     int                         fCount;
 };
 }  // namespace
@@ -40,6 +45,15 @@ static void textToGlyphs_proc(const Rec& r) {
     }
 }
 
+static void textToGlyphsUTF8_proc(const Rec& r) {
+    uint16_t glyphs[NGLYPHS];
+    SkASSERT(r.fCount <= NGLYPHS);
+
+    for (int i = 0; i < r.fLoops; ++i) {
+        r.fFont.textToGlyphs(r.fUTF8, r.fUTF8Length, SkTextEncoding::kUTF8, glyphs, NGLYPHS);
+    }
+}
+
 static void charsToGlyphs_proc(const Rec& r) {
     uint16_t glyphs[NGLYPHS];
     SkASSERT(r.fCount <= NGLYPHS);
@@ -67,26 +81,45 @@ static void findcache_proc(const Rec& r) {
     }
 }
 
+static void findpages_proc(const Rec& r) {
+    SkGlyphID glyph;
+    for (int loop = 0; loop < r.fLoops; ++loop) {
+        for (int i = 0; i < r.fCount; ++i) {
+            r.fPages.find(r.fText[i], &glyph);
+        }
+    }
+}
+
 class CMAPBench : public Benchmark {
     TypefaceProc fProc;
     SkString     fName;
     SkUnichar    fText[NGLYPHS];
+    char         fUTF8[NGLYPHS * SkUTF::kMaxBytesInUTF8Sequence];
+    size_t       fUTF8Length;
     SkFont       fFont;
     SkCharToGlyphCache fCache;
+    SkCharToGlyphPages fPages;
     int          fCount;
 
 public:
-    CMAPBench(TypefaceProc proc, const char name[], int count) {
+    // With 'ascii', the text is printable ASCII, as most Latin text is, rather than random
+    // BMP characters.
+    CMAPBench(TypefaceProc proc, const char name[], int count, bool ascii = false) {
         SkASSERT(count <= NGLYPHS);
 
         fProc = proc;
-        fName.printf("%s_%d", name, count);
+        fName.printf("%s_%d%s", name, count, ascii ? "_ascii" : "");
         fCount = count;
 
         SkRandom rand;
+        fUTF8Length = 0;
         for (int i = 0; i < count; ++i) {
-            fText[i] = rand.nextU() & 0xFFFF;
+            fText[i] = ascii ? rand.nextRangeU(0x20, 0x7E) : rand.nextU() & 0xFFFF;
             fCache.addCharAndGlyph(fText[i], i);
+            fPages.loadPage(fText[i], [](SkUnichar, SkGlyphID glyphs[]) {
+                std::fill_n(glyphs, SkCharToGlyphPages::kPageSize, 0);
+            });
+            fUTF8Length += SkUTF::ToUTF8(fText[i], fUTF8 + fUTF8Length);
         }
         fFont.setTypeface(ToolUtils::DefaultPortableTypeface());
     }
@@ -101,7 +134,7 @@ protected:
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        fProc({fCache, loops, fFont, fText, fCount});
+        fProc({fCache, fPages, loops, fFont, fText, fUTF8, fUTF8Length, fCount});
     }
 
 private:
@@ -117,6 +150,8 @@ DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "font_charToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(addcache_proc, "addcache_charToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", SMALL); )
+DEF_BENCH( return new CMAPBench(findpages_proc, "findpages_charToGlyph", SMALL); )
+DEF_BENCH( return new CMAPBench(textToGlyphsUTF8_proc, "font_utf8ToGlyph", SMALL, true); )
 
 constexpr int BIG = 100;
 
@@ -124,3 +159,5 @@ DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "font_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(addcache_proc, "addcache_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", BIG); )
+DEF_BENCH( return new CMAPBench(findpages_proc, "findpages_charToGlyph", BIG); )
+DEF_BENCH( return new CMAPBench(textToGlyphsUTF8_proc, "font_utf8ToGlyph", BIG, true); )
@@ -9,12 +9,16 @@
 
 #include "bench/Benchmark.h"
 #include "bench/GpuTools.h"
+#include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkColorMatrix.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "tools/ToolUtils.h"
 
 using namespace skia_private;
 
@@ -367,3 +371,93 @@ DEF_BENCH(return new CompositingImages({512, 512}, {380, 380}, {5, 5}, ClampingM
 DEF_BENCH(return new CompositingImages({512, 512}, {380, 380}, {5, 5}, ClampingMode::kAlwaysStrict, TransformMode::kPerspective, 1));
 DEF_BENCH(return new CompositingImages({512, 512}, {380, 380}, {5, 5}, ClampingMode::kChromeTiling_RowMajor, TransformMode::kPerspective, 1));
 DEF_BENCH(return new CompositingImages({512, 512}, {380, 380}, {5, 5}, ClampingMode::kChromeTiling_Optimal, TransformMode::kPerspective, 1));
+
+/**
+ * Composites unscaled, integer-aligned raster layers, which take the sprite blitters, for each
+ * combination of layer and destination color type, blend mode, and paint alpha or color filter.
+ */
+class CompositingSprites : public Benchmark {
+public:
+    enum class PaintMode { kPlain, kAlpha, kColorFilter };
+
+    CompositingSprites(SkColorType srcCT, SkColorType dstCT, SkBlendMode mode, PaintMode paintMode)
+            : fSrcCT(srcCT), fDstCT(dstCT), fMode(mode), fPaintMode(paintMode) {
+        static const char* kPaintModeNames[] = {"", "_alpha", "_colorfilter"};
+        fName.printf("compositing_sprites_%s_on_%s_%s%s", ToolUtils::colortype_name(srcCT),
+                     ToolUtils::colortype_name(dstCT), SkBlendMode_Name(mode),
+                     kPaintModeNames[static_cast<int>(paintMode)]);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        fSurface = SkSurfaces::Raster(SkImageInfo::Make(kSize, kSize, fDstCT, kPremul_SkAlphaType));
+        fSurface->getCanvas()->clear(SkColors::kGray);
+
+        auto layer = SkSurfaces::Raster(SkImageInfo::Make(kSize, kSize, fSrcCT,
+                                                          kPremul_SkAlphaType));
+        layer->getCanvas()->clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setColor(0xC04080F0);
+        layer->getCanvas()->drawCircle(kSize / 2, kSize / 2, kSize / 3, paint);
+        fLayer = layer->makeImageSnapshot();
+
+        fPaint.setBlendMode(fMode);
+        if (fPaintMode == PaintMode::kAlpha) {
+            fPaint.setAlphaf(0.5f);
+        } else if (fPaintMode == PaintMode::kColorFilter) {
+            SkColorMatrix desaturate;
+            desaturate.setSaturation(0.2f);
+            fPaint.setColorFilter(SkColorFilters::Matrix(desaturate));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawImage(fLayer, 0, 0, SkSamplingOptions(), &fPaint);
+        }
+    }
+
+private:
+    static constexpr int kSize = 512;
+
+    SkColorType      fSrcCT;
+    SkColorType      fDstCT;
+    SkBlendMode      fMode;
+    PaintMode        fPaintMode;
+    SkString         fName;
+    sk_sp<SkSurface> fSurface;
+    sk_sp<SkImage>   fLayer;
+    SkPaint          fPaint;
+
+    using INHERITED = Benchmark;
+};
+
+#define DEF_SPRITE_BENCHES(src, dst)                                                        \
+    DEF_BENCH(return new CompositingSprites(src, dst, SkBlendMode::kSrcOver,                \
+                                            CompositingSprites::PaintMode::kPlain));        \
+    DEF_BENCH(return new CompositingSprites(src, dst, SkBlendMode::kSrcOver,                \
+                                            CompositingSprites::PaintMode::kAlpha));        \
+    DEF_BENCH(return new CompositingSprites(src, dst, SkBlendMode::kSrcOver,                \
+                                            CompositingSprites::PaintMode::kColorFilter));  \
+    DEF_BENCH(return new CompositingSprites(src, dst, SkBlendMode::kSrc,                    \
+                                            CompositingSprites::PaintMode::kPlain));        \
+    DEF_BENCH(return new CompositingSprites(src, dst, SkBlendMode::kModulate,               \
+                                            CompositingSprites::PaintMode::kPlain));
+
+DEF_SPRITE_BENCHES(kN32_SkColorType,          kN32_SkColorType)
+DEF_SPRITE_BENCHES(kN32_SkColorType,          kRGB_565_SkColorType)
+DEF_SPRITE_BENCHES(kN32_SkColorType,          kRGBA_1010102_SkColorType)
+DEF_SPRITE_BENCHES(kN32_SkColorType,          kRGBA_F16_SkColorType)
+DEF_SPRITE_BENCHES(kN32_SkColorType,          kAlpha_8_SkColorType)
+DEF_SPRITE_BENCHES(kRGB_565_SkColorType,      kN32_SkColorType)
+DEF_SPRITE_BENCHES(kRGB_565_SkColorType,      kRGB_565_SkColorType)
+DEF_SPRITE_BENCHES(kRGBA_1010102_SkColorType, kN32_SkColorType)
+DEF_SPRITE_BENCHES(kRGBA_1010102_SkColorType, kRGBA_1010102_SkColorType)
+DEF_SPRITE_BENCHES(kRGBA_F16_SkColorType,     kN32_SkColorType)
+DEF_SPRITE_BENCHES(kRGBA_F16_SkColorType,     kRGBA_F16_SkColorType)
+
+#undef DEF_SPRITE_BENCHES
@@ -159,11 +159,37 @@ private:
     using INHERITED = DisplacementBaseBench;
 };
 
+class DisplacementLargeScaleBench : public DisplacementBaseBench {
+public:
+    DisplacementLargeScaleBench(bool small) : INHERITED(small) { }
+
+protected:
+    const char* onGetName() override {
+        return isSmall() ? "displacement_largescale_small" : "displacement_largescale_large";
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        sk_sp<SkImageFilter> displ(SkImageFilters::Image(fCheckerboard, SkFilterMode::kLinear));
+        // Displacement far larger than the image, so neighboring pixels sample distant rows
+        paint.setImageFilter(SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kB,
+                                                             512.0f, std::move(displ), nullptr));
+        for (int i = 0; i < loops; ++i) {
+            this->drawClippedBitmap(canvas, 200, 0, paint);
+        }
+    }
+
+private:
+    using INHERITED = DisplacementBaseBench;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new DisplacementZeroBench(true); )
 DEF_BENCH( return new DisplacementAlphaBench(true); )
 DEF_BENCH( return new DisplacementFullBench(true); )
+DEF_BENCH( return new DisplacementLargeScaleBench(true); )
 DEF_BENCH( return new DisplacementZeroBench(false); )
 DEF_BENCH( return new DisplacementAlphaBench(false); )
 DEF_BENCH( return new DisplacementFullBench(false); )
+DEF_BENCH( return new DisplacementLargeScaleBench(false); )
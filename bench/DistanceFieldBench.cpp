@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "src/core/SkDistanceFieldGen.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#include <memory>
+#include <vector>
+
+#if !defined(SK_DISABLE_SDF_TEXT)
+
+static constexpr char kGlyphs[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+// Generates the distance fields for a page's worth of fresh glyph masks, as SDF text does the
+// first time it meets them.
+class DistanceFieldBench : public Benchmark {
+    std::vector<SkBitmap>                   fMasks;
+    std::vector<std::unique_ptr<uint8_t[]>> fFields;
+    float                                   fTextSize;
+    SkString                                fName;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        SkFont font = ToolUtils::DefaultPortableFont();
+        font.setSize(fTextSize);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLACK);
+
+        for (const char* c = kGlyphs; *c; ++c) {
+            SkRect bounds;
+            font.measureText(c, 1, SkTextEncoding::kUTF8, &bounds);
+            const SkIRect ibounds = bounds.roundOut();
+            if (ibounds.isEmpty()) {
+                continue;
+            }
+            SkBitmap mask;
+            mask.allocPixels(SkImageInfo::MakeA8(ibounds.width(), ibounds.height()));
+            mask.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(mask);
+            canvas.drawSimpleText(c, 1, SkTextEncoding::kUTF8,
+                                  -ibounds.fLeft, -ibounds.fTop, font, paint);
+            fMasks.push_back(mask);
+        }
+
+        for (const SkBitmap& mask : fMasks) {
+            fFields.emplace_back(new uint8_t[SkComputeDistanceFieldSize(mask.width(),
+                                                                        mask.height())]);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            for (size_t i = 0; i < fMasks.size(); ++i) {
+                SkGenerateDistanceFieldFromA8Image(fFields[i].get(), fMasks[i].getAddr8(0, 0),
+                                                   fMasks[i].width(), fMasks[i].height(),
+                                                   fMasks[i].rowBytes());
+            }
+        }
+    }
+
+public:
+    explicit DistanceFieldBench(float textSize) : fTextSize(textSize) {
+        fName.printf("distance_field_glyphs_%g", textSize);
+    }
+};
+
+DEF_BENCH( return new DistanceFieldBench(32); )
+DEF_BENCH( return new DistanceFieldBench(162); )
+
+#endif // !defined(SK_DISABLE_SDF_TEXT)
@@ -207,6 +207,34 @@ private:
     using INHERITED = LightingBaseBench;
 };
 
+class LightingMultiLightBench : public LightingBaseBench {
+public:
+    LightingMultiLightBench(bool small) : INHERITED(small) { }
+
+protected:
+    const char* onGetName() override {
+        return fIsSmall ? "lightingmultilight_small" : "lightingmultilight_large";
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        // As in SVG, where diffuse and specular lighting of the same alpha are merged together
+        sk_sp<SkImageFilter> lights[] = {
+            SkImageFilters::DistantLitDiffuse(
+                    GetDistantDirection(), GetWhite(), GetSurfaceScale(), GetKd(), nullptr),
+            SkImageFilters::PointLitSpecular(
+                    GetPointLocation(), GetWhite(), GetSurfaceScale(), GetKs(), GetShininess(),
+                    nullptr),
+            SkImageFilters::SpotLitSpecular(
+                    GetSpotLocation(), GetSpotTarget(), GetSpotExponent(), GetCutoffAngle(),
+                    GetWhite(), GetSurfaceScale(), GetKs(), GetShininess(), nullptr)
+        };
+        draw(loops, canvas, SkImageFilters::Merge(lights, std::size(lights)));
+    }
+
+private:
+    using INHERITED = LightingBaseBench;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
@@ -221,3 +249,5 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingMultiLightBench(true); )
+DEF_BENCH( return new LightingMultiLightBench(false); )
@@ -257,3 +257,34 @@ DEF_BENCH(return new M33_mapRectBench(MapMatrixType::kScaleTranslate);)
 DEF_BENCH(return new M33_mapRectBench(MapMatrixType::kRotate);)
 DEF_BENCH(return new M33_mapRectBench(MapMatrixType::kPerspective);)
 DEF_BENCH(return new M33_mapRectBench(MapMatrixType::kPerspectiveClipped);)
+
+// Maps the same number of rects as M4_mapRectBench, but 100 at a time with
+// SkMatrixPriv::MapRects().
+class M4_mapRectsBench : public MapRectBench {
+public:
+    M4_mapRectsBench(MapMatrixType type) : INHERITED(type, "m4batch") {
+        SkRandom rand;
+        for (SkRect& r : fSrc) {
+            r = fS.makeOffset(rand.nextF(), rand.nextF());
+        }
+    }
+
+protected:
+    void performTest() override {
+        for (int i = 0; i < 100000 / kCount; ++i) {
+            SkMatrixPriv::MapRects(fM, fDst, fSrc, kCount);
+        }
+    }
+
+private:
+    static constexpr int kCount = 100;
+    SkRect fSrc[kCount], fDst[kCount];
+
+    using INHERITED = MapRectBench;
+};
+
+DEF_BENCH(return new M4_mapRectsBench(MapMatrixType::kTranslateOnly);)
+DEF_BENCH(return new M4_mapRectsBench(MapMatrixType::kScaleTranslate);)
+DEF_BENCH(return new M4_mapRectsBench(MapMatrixType::kRotate);)
+DEF_BENCH(return new M4_mapRectsBench(MapMatrixType::kPerspective);)
+DEF_BENCH(return new M4_mapRectsBench(MapMatrixType::kPerspectiveClipped);)
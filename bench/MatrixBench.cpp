@@ -8,6 +8,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkMatrixPriv.h"
 #include "src/core/SkMatrixUtils.h"
 
 class MatrixBench : public Benchmark {
@@ -198,6 +199,12 @@ DEF_BENCH( return new InvertMapRectMatrixBench(
 static SkMatrix make_trans() { return SkMatrix::Translate(2, 3); }
 static SkMatrix make_scale() { SkMatrix m(make_trans()); m.postScale(1.5f, 0.5f); return m; }
 static SkMatrix make_afine() { SkMatrix m(make_trans()); m.postRotate(15); return m; }
+static SkMatrix make_persp() {
+    SkMatrix m(make_afine());
+    m.setPerspX(0.001f);
+    m.setPerspY(-0.0015f);
+    return m;
+}
 
 class MapPointsMatrixBench : public MatrixBench {
 protected:
@@ -226,6 +233,7 @@ DEF_BENCH( return new MapPointsMatrixBench("mappoints_identity", SkMatrix::I());
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_trans", make_trans()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_scale", make_scale()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_affine", make_afine()); )
+DEF_BENCH( return new MapPointsMatrixBench("mappoints_persp", make_persp()); )
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -260,3 +268,40 @@ public:
 };
 DEF_BENCH( return new MapRectMatrixBench("maprect", false); )
 DEF_BENCH( return new MapRectMatrixBench("maprectscaletrans", true); )
+
+// Maps many rects against one matrix, as when culling, either with the batched
+// SkMatrixPriv::MapRects() or one SkMatrix::mapRect() at a time.
+class MapRectsMatrixBench : public MatrixBench {
+    SkMatrix fM;
+    bool     fBatched;
+
+    enum { N = 1000 };
+    SkRect fSrc[N], fDst[N];
+public:
+    MapRectsMatrixBench(const char name[], const SkMatrix& m, bool batched)
+        : MatrixBench(name), fM(m), fBatched(batched)
+    {
+        SkRandom rand;
+        for (int i = 0; i < N; ++i) {
+            SkScalar x = rand.nextRangeScalar(0, 400),
+                     y = rand.nextRangeScalar(0, 400);
+            fSrc[i].setXYWH(x, y, rand.nextRangeScalar(1, 50), rand.nextRangeScalar(1, 50));
+        }
+    }
+
+    void performTest() override {
+        for (int loop = 0; loop < 1000; ++loop) {
+            if (fBatched) {
+                SkMatrixPriv::MapRects(fM, fDst, fSrc, N);
+            } else {
+                for (int i = 0; i < N; ++i) {
+                    fM.mapRect(&fDst[i], fSrc[i]);
+                }
+            }
+        }
+    }
+};
+DEF_BENCH( return new MapRectsMatrixBench("maprects_affine_batched", make_afine(), true); )
+DEF_BENCH( return new MapRectsMatrixBench("maprects_affine_loop", make_afine(), false); )
+DEF_BENCH( return new MapRectsMatrixBench("maprects_persp_batched", make_persp(), true); )
+DEF_BENCH( return new MapRectsMatrixBench("maprects_persp_loop", make_persp(), false); )
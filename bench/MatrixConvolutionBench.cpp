@@ -16,12 +16,38 @@
 
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
+    enum class Kernel {
+        kSmall,           // 3x3
+        kBig,             // 9x9
+        kLargeSeparable,  // 16x16 Gaussian, which factors into 1D kernels
+        kLargeDense,      // 16x16 random values
+    };
+
+    MatrixConvolutionBench(Kernel kernelType, SkTileMode tileMode, bool convolveAlpha)
         : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+                               kernel_name(kernelType),
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+        if (kernelType == Kernel::kLargeSeparable || kernelType == Kernel::kLargeDense) {
+            SkISize kernelSize = SkISize::Make(16, 16);
+            SkScalar kernel[256];
+            SkRandom rand;
+            for (int y = 0; y < 16; y++) {
+                for (int x = 0; x < 16; x++) {
+                    if (kernelType == Kernel::kLargeSeparable) {
+                        SkScalar dx = x - 7.5f, dy = y - 7.5f;
+                        kernel[y * 16 + x] = SkScalarExp(-(dx * dx + dy * dy) / 32) / 50;
+                    } else {
+                        kernel[y * 16 + x] = rand.nextSScalar1() / 16;
+                    }
+                }
+            }
+            SkScalar gain = 1.f, bias = SkIntToScalar(0);
+            SkIPoint kernelOffset = SkIPoint::Make(8, 8);
+            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
+                                                        kernelOffset, tileMode, convolveAlpha,
+                                                        nullptr);
+        } else if (kernelType == Kernel::kBig) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -48,6 +74,16 @@ public:
         }
     }
 
+    static const char* kernel_name(Kernel kernelType) {
+        switch (kernelType) {
+            case Kernel::kSmall:          return "";
+            case Kernel::kBig:            return "bigKernel_";
+            case Kernel::kLargeSeparable: return "largeSeparableKernel_";
+            case Kernel::kLargeDense:     return "largeDenseKernel_";
+        }
+        SkUNREACHABLE;
+    }
+
 protected:
     const char* onGetName() override {
         return fName.c_str();
@@ -74,14 +110,21 @@ private:
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+using MCB = MatrixConvolutionBench::Kernel;
+
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kSmall, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kSmall, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kSmall, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kSmall, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kSmall, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kBig, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kBig, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kBig, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kBig, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kBig, SkTileMode::kDecal, false); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kLargeSeparable, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kLargeSeparable, SkTileMode::kClamp, false); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kLargeDense, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(MCB::kLargeDense, SkTileMode::kClamp, false); )
@@ -10,10 +10,12 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
@@ -79,6 +81,7 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "src/core/SkResourceCache.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFShader.h"
@@ -306,6 +309,175 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Measures the cost of a document whose close() is dominated by subsetting and embedding fonts.
+// 'cached' leaves the subset font programs from the previous loop in the resource cache, as
+// happens when many reports are generated from the same template.
+struct PDFFontEmbedBench : public Benchmark {
+    bool fThreaded;
+    bool fCached;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::vector<sk_sp<SkTypeface>> fTypefaces;
+
+    PDFFontEmbedBench(bool threaded, bool cached) : fThreaded(threaded), fCached(cached) {
+        fName.printf("PDFFontEmbed_%s%s", threaded ? "threaded" : "serial",
+                     cached ? "_cached" : "");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        fExecutor = fThreaded ? SkExecutor::MakeFIFOThreadPool() : nullptr;
+        for (const char* resource : {"fonts/Roboto-Regular.ttf", "fonts/Funkster.ttf",
+                                     "fonts/cond-bold-italic.ttf", "fonts/Em.ttf"}) {
+            if (sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource(resource)) {
+                fTypefaces.push_back(std::move(typeface));
+            }
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        static const char kText[] = "The quick brown fox jumps over the lazy dog. 0123456789";
+        while (loops-- > 0) {
+            if (!fCached) {
+                SkResourceCache::PurgeAll();
+            }
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fExecutor = fExecutor.get();
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int page = 0; page < 4; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                float y = 24;
+                for (const sk_sp<SkTypeface>& typeface : fTypefaces) {
+                    SkFont font(typeface, 12);
+                    canvas->drawString(kText, 24, y, font, SkPaint());
+                    y += 24;
+                }
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+};
+
+// A 1000-page report that draws the same logo on every page, but from a different SkImage each
+// time, as happens when each page is produced separately. 'encoded' draws a fresh lazy image of
+// the same PNG on each page; otherwise each page gets a raster copy of the same pixels.
+struct PDFRepeatedImageBench : public Benchmark {
+    static constexpr int kPageCount = 1000;
+    static constexpr int kRasterCopies = 16;
+
+    bool fEncoded;
+    SkString fName;
+    sk_sp<SkData> fEncodedData;
+    std::vector<sk_sp<SkImage>> fRasterImages;
+
+    PDFRepeatedImageBench(bool encoded) : fEncoded(encoded) {
+        fName.printf("PDFRepeatedImage_%s", encoded ? "encoded" : "raster");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        fEncodedData = GetResourceAsData("images/color_wheel.png");
+        sk_sp<SkImage> img = SkImages::DeferredFromEncodedData(fEncodedData);
+        if (!img) {
+            return;
+        }
+        SkAutoPixmapStorage pixmap;
+        pixmap.alloc(SkImageInfo::MakeN32Premul(img->dimensions()));
+        if (!img->readPixels(nullptr, pixmap, 0, 0)) {
+            return;
+        }
+        for (int i = 0; i < kRasterCopies; ++i) {
+            fRasterImages.push_back(SkImages::RasterFromPixmapCopy(pixmap));
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (fRasterImages.empty()) {
+            return;
+        }
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            auto doc = SkPDF::MakeDocument(&wStream, SkPDF::Metadata());
+            for (int page = 0; page < kPageCount; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                sk_sp<SkImage> image = fEncoded
+                        ? SkImages::DeferredFromEncodedData(fEncodedData)
+                        : fRasterImages[page % kRasterCopies];
+                canvas->drawImage(image, 36, 36);
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+};
+
+// A large tagged document: every page is a section of short paragraphs, each paragraph its own
+// structure element drawn as several marked-content runs. Time is mostly spent in close(); peak
+// memory tracks how much of the structure tree is kept until then.
+struct PDFTaggedDocumentBench : public Benchmark {
+    static constexpr int kPageCount = 100;
+    static constexpr int kParagraphsPerPage = 100;
+    static constexpr int kRunsPerParagraph = 4;
+
+    std::unique_ptr<SkPDF::StructureElementNode> fRoot;
+    SkFont fFont;
+
+    const char* onGetName() override { return "PDFTaggedDocument"; }
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+    void onDelayedSetup() override {
+        fFont = ToolUtils::DefaultFont();
+        fRoot = std::make_unique<SkPDF::StructureElementNode>();
+        fRoot->fTypeString = "Document";
+        fRoot->fNodeId = 1;
+        int nextNodeId = 2;
+        for (int page = 0; page < kPageCount; ++page) {
+            auto section = std::make_unique<SkPDF::StructureElementNode>();
+            section->fTypeString = "Sect";
+            section->fNodeId = nextNodeId++;
+            auto heading = std::make_unique<SkPDF::StructureElementNode>();
+            heading->fTypeString = "H1";
+            heading->fNodeId = nextNodeId++;
+            section->fChildVector.push_back(std::move(heading));
+            for (int i = 0; i < kParagraphsPerPage; ++i) {
+                auto paragraph = std::make_unique<SkPDF::StructureElementNode>();
+                paragraph->fTypeString = "P";
+                paragraph->fNodeId = nextNodeId++;
+                section->fChildVector.push_back(std::move(paragraph));
+            }
+            fRoot->fChildVector.push_back(std::move(section));
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fStructureElementTreeRoot = fRoot.get();
+            metadata.fOutline = SkPDF::Metadata::Outline::StructureElementHeaders;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (const auto& section : fRoot->fChildVector) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                float y = 8;
+                for (const auto& node : section->fChildVector) {
+                    for (int run = 0; run < kRunsPerParagraph; ++run) {
+                        SkPDF::SetNodeId(canvas, node->fNodeId);
+                        canvas->drawString("Lorem ipsum", 36 + 72 * run, y, fFont, SkPaint());
+                    }
+                    y += 7.5f;
+                }
+                SkPDF::SetNodeId(canvas, 0);
+                doc->endPage();
+            }
+            doc->close();
+        }
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -314,6 +486,12 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFFontEmbedBench(false, false);)
+DEF_BENCH(return new PDFFontEmbedBench(true, false);)
+DEF_BENCH(return new PDFFontEmbedBench(false, true);)
+DEF_BENCH(return new PDFRepeatedImageBench(false);)
+DEF_BENCH(return new PDFRepeatedImageBench(true);)
+DEF_BENCH(return new PDFTaggedDocumentBench;)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
@@ -115,3 +115,67 @@ private:
 DEF_BENCH(return new PathTextBench(false, false);)
 DEF_BENCH(return new PathTextBench(false, true);)
 DEF_BENCH(return new PathTextBench(true, true);)
+
+/*
+ * Draws the same glyphs unrotated at text sizes, a line per call, so that they are drawn from
+ * cached masks instead of as paths.
+ */
+class PathTextMasksBench : public Benchmark {
+public:
+    explicit PathTextMasksBench(bool clipped) : fClipped(clipped) {}
+
+private:
+    static constexpr int kNumLines = kNumDraws / kNumGlyphs;
+
+    const char* onGetName() override {
+        return fClipped ? "path_text_masks_clipped" : "path_text_masks";
+    }
+    SkISize onGetSize() override { return SkISize::Make(kScreenWidth, kScreenHeight); }
+
+    void onDelayedSetup() override {
+        SkFont font = ToolUtils::DefaultFont();
+        for (int i = 0; i < kNumGlyphs; ++i) {
+            fGlyphs[i] = font.unicharToGlyph(kGlyphs[i]);
+        }
+
+        SkRandom rand;
+        for (int i = 0; i < kNumLines; ++i) {
+            fFonts[i] = font;
+            fFonts[i].setSize(rand.nextRangeF(9, 24));
+            fFonts[i].getPos(fGlyphs, kNumGlyphs, fPositions[i],
+                             {rand.nextRangeF(0, kScreenWidth / 3),
+                              (i + 1) * (kScreenHeight / (kNumLines + 1.0f))});
+            fPaints[i].setAntiAlias(true);
+            fPaints[i].setColor(rand.nextU() | 0x80808080);
+        }
+
+        if (fClipped) {
+            fClipPath = ToolUtils::make_star(SkRect::MakeIWH(kScreenWidth, kScreenHeight), 11, 3);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkAutoCanvasRestore acr(canvas, true);
+        if (fClipped) {
+            canvas->clipPath(fClipPath, SkClipOp::kIntersect, true);
+        }
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < kNumLines; ++i) {
+                canvas->drawGlyphs(kNumGlyphs, fGlyphs, fPositions[i], {0, 0}, fFonts[i],
+                                   fPaints[i]);
+            }
+        }
+    }
+
+    const bool fClipped;
+    SkGlyphID  fGlyphs[kNumGlyphs];
+    SkFont     fFonts[kNumLines];
+    SkPoint    fPositions[kNumLines][kNumGlyphs];
+    SkPaint    fPaints[kNumLines];
+    SkPath     fClipPath;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new PathTextMasksBench(false);)
+DEF_BENCH(return new PathTextMasksBench(true);)
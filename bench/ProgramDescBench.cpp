@@ -0,0 +1,139 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/gpu/GrDirectContext.h"
+#include "include/private/SkColorData.h"
+#include "include/private/base/SkTArray.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/gpu/SkBackingFit.h"
+#include "src/gpu/Swizzle.h"
+#include "src/gpu/ganesh/GrAppliedClip.h"
+#include "src/gpu/ganesh/GrCaps.h"
+#include "src/gpu/ganesh/GrDefaultGeoProcFactory.h"
+#include "src/gpu/ganesh/GrDirectContextPriv.h"
+#include "src/gpu/ganesh/GrDstProxyView.h"
+#include "src/gpu/ganesh/GrFragmentProcessor.h"
+#include "src/gpu/ganesh/GrProgramDesc.h"
+#include "src/gpu/ganesh/GrProgramInfo.h"
+#include "src/gpu/ganesh/SurfaceDrawContext.h"
+#include "tools/gpu/ProxyUtils.h"
+
+#include <memory>
+#include <utility>
+
+// Measures building the program keys for draws whose pipelines have already been keyed, as happens
+// for every draw after the first in an op, and for ops keyed at DDL record and replay time. The
+// "uncached" variant walks every processor for each key, as all builds did before GrPipeline cached
+// its portion of the key.
+class ProgramDescBench : public Benchmark {
+public:
+    ProgramDescBench(bool cached)
+            : fCached(cached)
+            , fName(cached ? "program_desc_cached" : "program_desc_uncached") {}
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+protected:
+    const char* onGetName() override { return fName; }
+
+    void onDelayedSetup() override {
+        using namespace GrDefaultGeoProcFactory;
+
+        fContext = GrDirectContext::MakeMock(nullptr);
+        if (!fContext) {
+            return;
+        }
+        fSDC = skgpu::ganesh::SurfaceDrawContext::Make(fContext.get(),
+                                                       GrColorType::kRGBA_8888,
+                                                       nullptr,
+                                                       SkBackingFit::kExact,
+                                                       {256, 256},
+                                                       SkSurfaceProps(),
+                                                       /*label=*/{});
+        if (!fSDC) {
+            return;
+        }
+
+        const GrCaps* caps = fContext->priv().caps();
+        GrGeometryProcessor* geomProcs[] = {
+            Make(&fArena, Color::kPremulGrColorAttribute_Type, Coverage::kSolid_Type,
+                 LocalCoords::kUnused_Type, SkMatrix::I()),
+            Make(&fArena, Color::kPremulGrColorAttribute_Type, Coverage::kAttribute_Type,
+                 LocalCoords::kHasExplicit_Type, SkMatrix::Scale(2, 2)),
+        };
+        for (GrGeometryProcessor* geomProc : geomProcs) {
+            for (int depth = 0; depth < 4; ++depth) {
+                GrAppliedClip clip = GrAppliedClip::Disabled();
+                if (auto fp = MakeCoverageFP(depth)) {
+                    clip.addCoverageFP(std::move(fp));
+                }
+                fProgramInfos.push_back(sk_gpu_test::CreateProgramInfo(caps,
+                                                                       &fArena,
+                                                                       fSDC->writeSurfaceView(),
+                                                                       /*usesMSAASurface=*/false,
+                                                                       std::move(clip),
+                                                                       GrDstProxyView(),
+                                                                       geomProc,
+                                                                       SkBlendMode::kSrcOver,
+                                                                       GrPrimitiveType::kTriangles,
+                                                                       GrXferBarrierFlags::kNone,
+                                                                       GrLoadOp::kLoad));
+                // Key each pipeline once up front, like the first draw in an op would.
+                caps->makeDesc(/*rt=*/nullptr, *fProgramInfos.back());
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fContext || !fSDC) {
+            return;
+        }
+        const GrCaps* caps = fContext->priv().caps();
+        for (int i = 0; i < loops; ++i) {
+            for (const GrProgramInfo* programInfo : fProgramInfos) {
+                GrProgramDesc desc =
+                        fCached ? caps->makeDesc(/*rt=*/nullptr, *programInfo)
+                                : GrProgramDesc::MakeUncachedForTesting(*programInfo, *caps);
+                SkASSERT(desc.isValid());
+            }
+        }
+    }
+
+private:
+    // A chain of 'depth' color-modifying processors, similar to what a shader with a color filter
+    // and a clip produces.
+    static std::unique_ptr<GrFragmentProcessor> MakeCoverageFP(int depth) {
+        if (depth == 0) {
+            return nullptr;
+        }
+        const SkPMColor4f color = {0.5f, 0.5f, 0.5f, 0.5f};
+        std::unique_ptr<GrFragmentProcessor> fp = GrFragmentProcessor::MakeColor(color);
+        for (int i = 0; i < depth; ++i) {
+            fp = GrFragmentProcessor::Compose(
+                    GrFragmentProcessor::ClampOutput(GrFragmentProcessor::SwizzleOutput(
+                            std::move(fp), skgpu::Swizzle("aaa1"))),
+                    GrFragmentProcessor::ModulateRGBA(nullptr, color));
+        }
+        return fp;
+    }
+
+    const bool fCached;
+    const char* fName;
+    sk_sp<GrDirectContext> fContext;
+    std::unique_ptr<skgpu::ganesh::SurfaceDrawContext> fSDC;
+    SkArenaAlloc fArena{4096};
+    skia_private::TArray<GrProgramInfo*> fProgramInfos;
+};
+
+DEF_BENCH(return new ProgramDescBench(/*cached=*/true);)
+DEF_BENCH(return new ProgramDescBench(/*cached=*/false);)
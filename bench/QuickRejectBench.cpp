@@ -7,8 +7,13 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
 
+#include <algorithm>
+#include <iterator>
+
 class QuickRejectBench : public Benchmark {
     enum { N = 1000000 };
     float fFloats[N];
@@ -38,6 +43,50 @@ class QuickRejectBench : public Benchmark {
 };
 DEF_BENCH( return new QuickRejectBench; )
 
+// Culls many items against the clip under a rotation, as a retained scene graph does each frame,
+// either with the batched quickReject() or one rect at a time.
+class QuickRejectRectsBench : public Benchmark {
+    enum { N = 10000 };
+    SkRect   fRects[N];
+    uint32_t fVisible[(N + 31) / 32];
+    bool     fBatched;
+    SkString fName;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend != Backend::kNonRendering; }
+
+    void onDelayedSetup() override  {
+        SkRandom rand;
+        for (int i = 0; i < N; ++i) {
+            fRects[i].setXYWH(rand.nextRangeScalar(-200, 800), rand.nextRangeScalar(-200, 800),
+                              rand.nextRangeScalar(1, 40), rand.nextRangeScalar(1, 40));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        canvas->rotate(10);
+        while (loops --> 0) {
+            if (fBatched) {
+                canvas->quickReject(fRects, fVisible);
+            } else {
+                std::fill_n(fVisible, std::size(fVisible), 0);
+                for (int i = 0; i < N; ++i) {
+                    if (!canvas->quickReject(fRects[i])) {
+                        fVisible[i >> 5] |= 1u << (i & 31);
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    explicit QuickRejectRectsBench(bool batched) : fBatched(batched) {
+        fName.printf("quick_reject_rects_%s", batched ? "batched" : "loop");
+    }
+};
+DEF_BENCH( return new QuickRejectRectsBench(true); )
+DEF_BENCH( return new QuickRejectRectsBench(false); )
+
 class ConcatBench : public Benchmark {
     SkMatrix fMatrix;
 
@@ -7,8 +7,11 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkString.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
 
+#include <vector>
+
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
     return result.op(a, b, SkRegion::kUnion_Op);
@@ -129,3 +132,59 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+// Builds a region from many small rects, as damage tracking does, either with setRects(), with
+// one batched op(), or with one op() per rect.
+class RegionBuildBench : public Benchmark {
+public:
+    enum class Mode { kSetRects, kBatchedOp, kOpPerRect };
+
+    RegionBuildBench(int count, Mode mode) : fMode(mode) {
+        static const char* kNames[] = {"setrects", "oprects", "opperrect"};
+        fName.printf("region_build_%s_%d", kNames[(int)mode], count);
+
+        SkRandom rand;
+        fRects.resize(count);
+        for (SkIRect& r : fRects) {
+            r = SkIRect::MakeXYWH(rand.nextU() % 1024, rand.nextU() % 768,
+                                  1 + rand.nextU() % 32, 1 + rand.nextU() % 32);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int count = SkToInt(fRects.size());
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            switch (fMode) {
+                case Mode::kSetRects:
+                    rgn.setRects(fRects.data(), count);
+                    break;
+                case Mode::kBatchedOp:
+                    rgn.op(fRects.data(), count, SkRegion::kUnion_Op);
+                    break;
+                case Mode::kOpPerRect:
+                    for (const SkIRect& r : fRects) {
+                        rgn.op(r, SkRegion::kUnion_Op);
+                    }
+                    break;
+            }
+        }
+    }
+
+private:
+    Mode                 fMode;
+    std::vector<SkIRect> fRects;
+    SkString             fName;
+};
+
+DEF_BENCH(return new RegionBuildBench(10000, RegionBuildBench::Mode::kSetRects);)
+DEF_BENCH(return new RegionBuildBench(10000, RegionBuildBench::Mode::kBatchedOp);)
+DEF_BENCH(return new RegionBuildBench(1000, RegionBuildBench::Mode::kSetRects);)
+DEF_BENCH(return new RegionBuildBench(1000, RegionBuildBench::Mode::kOpPerRect);)
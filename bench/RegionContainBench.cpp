@@ -8,8 +8,11 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkString.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
 
+#include <vector>
+
 static bool sect_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
     return result.op(a, b, SkRegion::kIntersect_Op);
@@ -65,3 +68,49 @@ private:
 };
 
 DEF_BENCH(return new RegionContainBench(sect_proc, "sect");)
+
+static bool contains_proc(SkRegion& a, SkRegion& b) {
+    SkIRect r = b.getBounds();
+    r.inset(r.width()/4, r.height()/4);
+    return a.contains(r);
+}
+
+// The same ops against a region built from 10k small rects, as in damage tracking.
+class RegionContainLargeBench : public Benchmark {
+public:
+    typedef bool (*Proc)(SkRegion& a, SkRegion& b);
+
+    RegionContainLargeBench(Proc proc, const char name[]) : fProc(proc) {
+        fName.printf("region_contains_10k_%s", name);
+
+        SkRandom rand;
+        std::vector<SkIRect> rects(10000);
+        for (SkIRect& r : rects) {
+            r = SkIRect::MakeXYWH(rand.nextU() % 1024, rand.nextU() % 768,
+                                  1 + rand.nextU() % 32, 1 + rand.nextU() % 32);
+        }
+        fA.setRects(rects.data(), SkToInt(rects.size()));
+        fB.setRect({256, 192, 768, 576});
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            fProc(fA, fB);
+        }
+    }
+
+private:
+    SkRegion fA, fB;
+    Proc     fProc;
+    SkString fName;
+};
+
+DEF_BENCH(return new RegionContainLargeBench(sect_proc, "sect");)
+DEF_BENCH(return new RegionContainLargeBench(contains_proc, "containsrect");)
@@ -16,10 +16,12 @@ class ShadowBench : public Benchmark {
 // Draws a set of shadowed rrects filling the canvas, in various modes:
 // * opaque or transparent
 // * use analytic fast path or geometric tessellation
+// * static, or with a slightly different scale each draw (which defeats cached tessellations)
 public:
-    ShadowBench(bool transparent, bool forceGeometric)
+    ShadowBench(bool transparent, bool forceGeometric, bool animate = false)
         : fTransparent(transparent)
-        , fForceGeometric(forceGeometric) {
+        , fForceGeometric(forceGeometric)
+        , fAnimate(animate) {
         computeName("shadows");
     }
 
@@ -44,6 +46,9 @@ protected:
         };
 
         fBaseName.printf("%s_%c_%c", root, kTransChars[fTransparent], kGeomChars[fForceGeometric]);
+        if (fAnimate) {
+            fBaseName.append("_anim");
+        }
     }
 
     void genRRects() {
@@ -83,6 +88,10 @@ protected:
         this->setupPaint(&paint);
 
         for (int i = 0; i < loops; ++i) {
+            SkAutoCanvasRestore acr(canvas, fAnimate);
+            if (fAnimate) {
+                canvas->scale(1 + (i % 16) / 64.f, 1 + (i % 16) / 64.f);
+            }
             // use the private canvas call so we don't include the time to stuff data in the Rec
             canvas->private_draw_shadow_rec(fRRects[i % kNumRRects], fRec);
         }
@@ -95,6 +104,7 @@ private:
     SkDrawShadowRec fRec;
     int    fTransparent;
     int    fForceGeometric;
+    bool   fAnimate;
 
     using INHERITED = Benchmark;
 };
@@ -103,4 +113,6 @@ DEF_BENCH(return new ShadowBench(false, false);)
 DEF_BENCH(return new ShadowBench(false, true);)
 DEF_BENCH(return new ShadowBench(true, false);)
 DEF_BENCH(return new ShadowBench(true, true);)
+DEF_BENCH(return new ShadowBench(false, false, true);)
+DEF_BENCH(return new ShadowBench(false, true, true);)
 
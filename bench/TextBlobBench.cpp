@@ -9,6 +9,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTextBlob.h"
@@ -109,3 +110,63 @@ class TextBlobMakeBench : public SkTextBlobBench {
     }
 };
 DEF_BENCH( return new TextBlobMakeBench(); )
+
+/*
+ * A page of small text in one blob, where the per-glyph cost of blitting cached masks dominates.
+ */
+class TextBlobDensePageBench : public Benchmark {
+public:
+    TextBlobDensePageBench(SkFont::Edging edging, bool complexClip)
+            : fEdging(edging), fComplexClip(complexClip) {
+        fName.printf("TextBlobDensePageBench_%s%s",
+                     edging == SkFont::Edging::kSubpixelAntiAlias ? "lcd" : "aa",
+                     complexClip ? "_complexclip" : "");
+    }
+
+private:
+    static constexpr int kLines = 60;
+    static constexpr int kWidth = 1000;
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkISize onGetSize() override { return {kWidth, kLines * 14 + 20}; }
+
+    void onDelayedSetup() override {
+        SkFont font(ToolUtils::CreatePortableTypeface("serif", SkFontStyle()), 12);
+        font.setSubpixel(true);
+        font.setEdging(fEdging);
+
+        const char* text = "The quick brown fox jumps over the lazy dog; pack my box with five "
+                           "dozen liquor jugs. Sphinx of black quartz, judge my vow!";
+        const int count = font.countText(text, strlen(text), SkTextEncoding::kUTF8);
+        SkTextBlobBuilder builder;
+        for (int line = 0; line < kLines; ++line) {
+            const auto& run = builder.allocRunPosH(font, count, 20 + line * 14);
+            font.textToGlyphs(text, strlen(text), SkTextEncoding::kUTF8, run.glyphs, count);
+            font.getXPos(run.glyphs, count, run.pos, 10);
+        }
+        fBlob = builder.make();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkAutoCanvasRestore acr(canvas, true);
+        if (fComplexClip) {
+            SkRegion clip;
+            for (int i = 0; i < 8; ++i) {
+                clip.op(SkIRect::MakeXYWH(i * 130, i * 40, 120, 600), SkRegion::kUnion_Op);
+            }
+            canvas->clipRegion(clip);
+        }
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            canvas->drawTextBlob(fBlob, 0, 0, paint);
+        }
+    }
+
+    const SkFont::Edging fEdging;
+    const bool           fComplexClip;
+    SkString             fName;
+    sk_sp<SkTextBlob>    fBlob;
+};
+DEF_BENCH( return new TextBlobDensePageBench(SkFont::Edging::kAntiAlias, false); )
+DEF_BENCH( return new TextBlobDensePageBench(SkFont::Edging::kAntiAlias, true); )
+DEF_BENCH( return new TextBlobDensePageBench(SkFont::Edging::kSubpixelAntiAlias, false); )
@@ -150,6 +150,73 @@ DEF_BENCH(return new VertBench(kColors_VertFlag | kTexture_VertFlag | kBilerp_Ve
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Draws a single mesh of ~100K tiny triangles, similar to a finely tessellated mesh warp. This is
+// dominated by per-triangle rasterization cost rather than by shading.
+class DenseVertBench : public Benchmark {
+    SkString fName;
+    bool fColors;
+
+    static constexpr int W = 640;
+    static constexpr int H = 480;
+    static constexpr int ROW = 160;
+    static constexpr int COL = 320;
+    static constexpr int VTX = ROW * COL * 6;
+
+    sk_sp<SkVertices> fVertices;
+
+public:
+    DenseVertBench(bool colors) : fColors(colors) {
+        fName.printf("verts_dense%s", colors ? "_colors" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    void onDelayedSetup() override {
+        SkVertices::Builder builder(SkVertices::kTriangles_VertexMode, VTX, 0,
+                                    fColors ? SkVertices::kHasColors_BuilderFlag : 0);
+        SkPoint* pts = builder.positions();
+        SkColor* colors = builder.colors();
+
+        SkRandom rand;
+        const SkScalar dx = SkIntToScalar(W) / COL;
+        const SkScalar dy = SkIntToScalar(H) / ROW;
+        auto jitter = [&](SkScalar x, SkScalar y) {
+            // Keep the grid coordinates shared between neighboring triangles, but off the
+            // pixel grid, so the shared edge rules are exercised.
+            return SkPoint::Make(x + 0.25f * dx * SkScalarSin(y), y + 0.25f * dy * SkScalarCos(x));
+        };
+        for (int y = 0; y < ROW; ++y) {
+            for (int x = 0; x < COL; ++x) {
+                SkPoint p00 = jitter(x * dx, y * dy),
+                        p10 = jitter((x + 1) * dx, y * dy),
+                        p01 = jitter(x * dx, (y + 1) * dy),
+                        p11 = jitter((x + 1) * dx, (y + 1) * dy);
+                *pts++ = p00; *pts++ = p10; *pts++ = p11;
+                *pts++ = p00; *pts++ = p11; *pts++ = p01;
+                if (colors) {
+                    for (int i = 0; i < 6; ++i) {
+                        *colors++ = rand.nextU() | 0xFF000000;
+                    }
+                }
+            }
+        }
+        fVertices = builder.detach();
+    }
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawVertices(fVertices, SkBlendMode::kModulate, paint);
+        }
+    }
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH(return new DenseVertBench(false);)
+DEF_BENCH(return new DenseVertBench(true);)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
 #include "include/core/SkRSXform.h"
 #include "src/base/SkRandom.h"
 #include "tools/Resources.h"
@@ -158,6 +225,8 @@ enum AtlasFlags {
     kColors_Flag = 1 << 0,
     kRotate_Flag = 1 << 1,
     kPersp_Flag  = 1 << 2,
+    kScale_Flag  = 1 << 3,
+    kLinear_Flag = 1 << 4,
 };
 
 class AtlasBench : public Benchmark {
@@ -185,6 +254,12 @@ public:
         if (flags & kPersp_Flag) {
             fName.append("_persp");
         }
+        if (flags & kScale_Flag) {
+            fName.append("_scaled");
+        }
+        if (flags & kLinear_Flag) {
+            fName.append("_linear");
+        }
     }
     ~AtlasBench() override {}
 
@@ -204,6 +279,10 @@ protected:
             scos = 0.866025403784439f;  // sqrt(3)/2
             ssin = 0.5f;
         }
+        if (fFlags & kScale_Flag) {
+            scos *= 1.5f;
+            ssin *= 1.5f;
+        }
 
         SkRandom rand;
         for (int i = 0; i < N; ++i) {
@@ -223,9 +302,11 @@ protected:
         if (fFlags & kPersp_Flag) {
             tiny_persp_effect(canvas);
         }
+        SkSamplingOptions sampling((fFlags & kLinear_Flag) ? SkFilterMode::kLinear
+                                                           : SkFilterMode::kNearest);
         for (int i = 0; i < loops; i++) {
             canvas->drawAtlas(fAtlas.get(), fXforms, fRects, colors, N, SkBlendMode::kModulate,
-                              SkSamplingOptions(), cullRect, paintPtr);
+                              sampling, cullRect, paintPtr);
         }
     }
 private:
@@ -238,4 +319,7 @@ DEF_BENCH(return new AtlasBench(kRotate_Flag);)
 DEF_BENCH(return new AtlasBench(kPersp_Flag);)
 DEF_BENCH(return new AtlasBench(kColors_Flag);)
 DEF_BENCH(return new AtlasBench(kColors_Flag | kRotate_Flag);)
+DEF_BENCH(return new AtlasBench(kScale_Flag);)
+DEF_BENCH(return new AtlasBench(kScale_Flag | kLinear_Flag);)
+DEF_BENCH(return new AtlasBench(kColors_Flag | kScale_Flag | kLinear_Flag);)
 
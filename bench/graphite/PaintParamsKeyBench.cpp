@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "bench/Benchmark.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkString.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/gpu/graphite/Recorder.h"
+#include "include/gpu/graphite/Recording.h"
+
+namespace skgpu::graphite {
+
+// Records many draws whose paints share a deep effect tree and snaps the recording, so that the
+// CPU cost per draw of building paint keys and uniforms dominates. With 'repeated' every draw
+// uses the same paint; otherwise each draw gets its own (identical) effect objects.
+class PaintParamsKeyBench : public Benchmark {
+public:
+    explicit PaintParamsKeyBench(bool repeated) : fRepeated(repeated) {
+        fName.printf("graphite_paint_key_%s", repeated ? "repeated" : "distinct");
+    }
+
+private:
+    static constexpr int kDraws = 1000;
+
+    static SkPaint MakePaint() {
+        const SkPoint pts[] = {{0, 0}, {64, 64}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+        sk_sp<SkShader> gradient = SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                                SkTileMode::kMirror);
+        sk_sp<SkShader> shader = SkShaders::Blend(SkBlendMode::kMultiply, std::move(gradient),
+                                                  SkShaders::Color(0xFF808080));
+        const float kSepia[20] = { 0.393f, 0.769f, 0.189f, 0, 0,
+                                   0.349f, 0.686f, 0.168f, 0, 0,
+                                   0.272f, 0.534f, 0.131f, 0, 0,
+                                   0,      0,      0,      1, 0 };
+        sk_sp<SkColorFilter> filter = SkColorFilters::Compose(
+                SkColorFilters::Matrix(kSepia),
+                SkColorFilters::Blend(0x40FF0000, SkBlendMode::kScreen));
+
+        SkPaint paint;
+        paint.setShader(std::move(shader));
+        paint.setColorFilter(std::move(filter));
+        paint.setBlendMode(SkBlendMode::kSrcOver);
+        return paint;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kGraphite; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        Recorder* recorder = canvas->recorder();
+        if (!recorder) {
+            return;
+        }
+        const SkPaint shared = MakePaint();
+        while (loops --> 0) {
+            for (int i = 0; i < kDraws; ++i) {
+                const SkRect r = SkRect::MakeXYWH((i * 13) % 500, (i * 7) % 500, 32, 32);
+                canvas->drawRect(r, fRepeated ? shared : MakePaint());
+            }
+            recorder->snap();
+        }
+    }
+
+    SkString fName;
+    bool     fRepeated;
+};
+
+DEF_BENCH( return new PaintParamsKeyBench(true); )
+DEF_BENCH( return new PaintParamsKeyBench(false); )
+
+}  // namespace skgpu::graphite
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/gpu/graphite/PipelineData.h"
+#include "src/gpu/graphite/PipelineDataCache.h"
+#include "src/gpu/graphite/Uniform.h"
+#include "src/gpu/graphite/UniformManager.h"
+
+namespace skgpu::graphite {
+
+// Writes the uniforms of a uniform-heavy runtime effect for many draws and dedups the finished
+// blocks, which is the per-draw uniform work a DrawPass does on the CPU. 'fused' writes the
+// whole uniform list at once (as runtime effects do) while 'per_field' writes one uniform at a
+// time. Only a handful of the draws have distinct values, so most blocks are duplicates.
+class UniformManagerBench : public Benchmark {
+public:
+    UniformManagerBench(Layout layout, bool fused) : fLayout(layout), fFused(fused) {
+        fName.printf("graphite_uniforms_%s_%s", LayoutString(layout),
+                     fused ? "fused" : "per_field");
+    }
+
+private:
+    static constexpr int kDraws = 1000;
+    static constexpr int kDistinctValues = 16;
+
+    inline static const Uniform kUniforms[] = {
+            {"localMatrix", SkSLType::kFloat4x4},
+            {"color0",      SkSLType::kFloat4},
+            {"color1",      SkSLType::kFloat4},
+            {"scale",       SkSLType::kFloat2},
+            {"bias",        SkSLType::kFloat2},
+            {"weights",     SkSLType::kFloat4, 2},
+            {"radius",      SkSLType::kFloat},
+            {"mode",        SkSLType::kInt},
+    };
+    // Enough floats for the tightly packed values above.
+    static constexpr int kValueCount = 16 + 4 + 4 + 2 + 2 + 8 + 1 + 1;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kDistinctValues; ++i) {
+            for (int j = 0; j < kValueCount; ++j) {
+                fValues[i][j] = static_cast<float>(i * kValueCount + j);
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        UniformManager mgr(fLayout);
+        while (loops --> 0) {
+            UniformDataCache cache;
+            for (int i = 0; i < kDraws; ++i) {
+                const float* values = fValues[i % kDistinctValues];
+                mgr.reset();
+                SkDEBUGCODE(mgr.setExpectedUniforms(SkSpan(kUniforms));)
+                if (fFused) {
+                    mgr.write(SkSpan(kUniforms), values);
+                } else {
+                    const float* src = values;
+                    for (const Uniform& u : kUniforms) {
+                        mgr.write(u, src);
+                        const int matrixSize = SkSLTypeMatrixSize(u.type());
+                        src += (matrixSize > 0 ? matrixSize * matrixSize
+                                               : SkSLTypeVecLength(u.type())) *
+                               std::max(u.count(), 1);
+                    }
+                }
+                SkDEBUGCODE(mgr.doneWithExpectedUniforms();)
+                cache.insert(mgr.finishUniformDataBlock());
+            }
+        }
+    }
+
+    SkString fName;
+    Layout   fLayout;
+    bool     fFused;
+    float    fValues[kDistinctValues][kValueCount];
+};
+
+DEF_BENCH( return new UniformManagerBench(Layout::kStd140, /*fused=*/false); )
+DEF_BENCH( return new UniformManagerBench(Layout::kStd140, /*fused=*/true); )
+DEF_BENCH( return new UniformManagerBench(Layout::kStd430, /*fused=*/false); )
+DEF_BENCH( return new UniformManagerBench(Layout::kStd430, /*fused=*/true); )
+DEF_BENCH( return new UniformManagerBench(Layout::kMetal, /*fused=*/false); )
+DEF_BENCH( return new UniformManagerBench(Layout::kMetal, /*fused=*/true); )
+
+}  // namespace skgpu::graphite
@@ -1121,6 +1121,19 @@ public:
     */
     bool quickReject(const SkPath& path) const;
 
+    /** Tests each SkRect in rects, transformed by SkMatrix, as quickReject(const SkRect&) would,
+        and records the results in the bitmask visible. Bit (i % 32) of visible[i / 32] is set if
+        rects[i] may intersect clip, and cleared if it can be quickly determined to be outside of
+        clip. Unused bits of the last word are cleared.
+
+        Use to cull many items at once, such as the children of a retained scene graph node.
+
+        @param rects    SkRect to compare with clip
+        @param visible  storage for at least (rects.size() + 31) / 32 words
+        @return         number of rects that may intersect clip
+    */
+    int quickReject(SkSpan<const SkRect> rects, uint32_t visible[]) const;
+
     /** Returns bounds of clip, transformed by inverse of SkMatrix. If clip is empty,
         return SkRect::MakeEmpty, where all SkRect sides equal zero.
 
@@ -1746,6 +1759,22 @@ public:
                                          const SkSamplingOptions&, const SkPaint* paint = nullptr,
                                          SrcRectConstraint constraint = kStrict_SrcRectConstraint);
 
+    /**
+     * Experimental. Draws 'cnt' rounded rectangles as if drawRRect() were called for each entry of
+     * 'rrects', with a copy of 'paint' whose color is replaced by the matching entry of 'colors'.
+     * Rectangles and circles are drawn by passing rect and oval SkRRects. Entries are drawn in
+     * order, and each is affected by the paint's shader, color filter, blend mode, and mask filter
+     * independently; an image filter applies to the set as a whole.
+     *
+     * If 'preViewMatrices' is not null, it must have 'cnt' entries, and entry i is drawn as if the
+     * canvas's CTM was canvas->getTotalMatrix() * preViewMatrices[i].
+     *
+     * Scatter plots, charts, and other dashboards draw many small shapes with the same paint but
+     * different colors; this avoids paying the per-draw overhead of the canvas for each of them.
+     */
+    void experimental_DrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int cnt,
+                                   const SkMatrix preViewMatrices[], const SkPaint& paint);
+
     /** Draws text, with origin at (x, y), using clip, SkMatrix, SkFont font,
         and SkPaint paint.
 
@@ -2318,6 +2347,8 @@ protected:
                                        const SkPoint dstClips[], const SkMatrix preViewMatrices[],
                                        const SkSamplingOptions&, const SkPaint*,
                                        SrcRectConstraint);
+    virtual void onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                                const SkMatrix preViewMatrices[], const SkPaint& paint);
 
     virtual void onDrawVerticesObject(const SkVertices* vertices, SkBlendMode mode,
                                       const SkPaint& paint);
@@ -2399,16 +2430,26 @@ private:
     // clip, and matrix commands. There is a layer per call to saveLayer() using the
     // kFullLayer_SaveLayerStrategy.
     struct Layer {
+        // What's needed to allocate the device of a layer whose allocation has been deferred.
+        struct DeferredDevice {
+            SkColorInfo     fColorInfo;
+            SkPixelGeometry fPixelGeometry;
+        };
+
         sk_sp<SkDevice>                                fDevice;
         skia_private::STArray<1, sk_sp<SkImageFilter>> fImageFilters;
         SkPaint                                        fPaint;
         bool                                           fIsCoverage;
         bool                                           fDiscard;
+        // Set while fDevice is null because nothing has drawn into the layer yet. See
+        // internalSaveLayer() for when a layer can be deferred.
+        std::optional<DeferredDevice>                  fDeferred;
 
         Layer(sk_sp<SkDevice> device,
               FilterSpan imageFilters,
               const SkPaint& paint,
               bool isCoverage);
+        Layer(const DeferredDevice& deferred, const SkPaint& paint);
     };
 
     // Encapsulate state needed to restore from saveBehind()
@@ -2447,6 +2488,8 @@ private:
                       FilterSpan filters,
                       const SkPaint& restorePaint,
                       bool layerIsCoverage);
+        // Like newLayer(), but fDevice remains the prior device until the layer is allocated.
+        void newDeferredLayer(const Layer::DeferredDevice& deferred, const SkPaint& restorePaint);
 
         void reset(SkDevice* device);
     };
@@ -2482,6 +2525,10 @@ private:
 
     void doSave();
     void checkForDeferredSave();
+    // Allocates the top layer's device if its allocation was deferred by internalSaveLayer(). This
+    // must be called before anything draws into, or reads back, the top device.
+    void checkForDeferredLayer();
+    void allocateDeferredLayer();
     void internalSetMatrix(const SkM44&);
 
     friend class SkAndroidFrameworkUtils;
@@ -82,6 +82,8 @@ public:
                           SkBlendMode) override;
     void onDrawEdgeAAImageSet2(const ImageSetEntry[], int count, const SkPoint[], const SkMatrix[],
                                const SkSamplingOptions&,const SkPaint*, SrcRectConstraint) override;
+    void onDrawRRectSet(const SkRRect[], const SkColor4f[], int count, const SkMatrix[],
+                        const SkPaint&) override;
 
 private:
     inline SkPaint overdrawPaint(const SkPaint& paint);
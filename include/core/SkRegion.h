@@ -432,6 +432,18 @@ public:
     */
     bool op(const SkRegion& rgna, const SkRegion& rgnb, Op op);
 
+    /** Replaces SkRegion with the result of SkRegion op the union of SkIRect in rects array.
+        Returns true if replaced SkRegion is not empty.
+
+        Faster than calling op() once per rect when there are many rects. For kUnion_Op and
+        kDifference_Op the result is the same as calling op() for each rect in turn.
+
+        @param rects  array of SkIRect
+        @param count  array size
+        @return       false if result is empty
+    */
+    bool op(const SkIRect rects[], int count, Op op);
+
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     /** Private. Android framework only.
 
@@ -114,6 +114,8 @@ protected:
                           SkBlendMode) override;
     void onDrawEdgeAAImageSet2(const ImageSetEntry[], int count, const SkPoint[], const SkMatrix[],
                                const SkSamplingOptions&,const SkPaint*, SrcRectConstraint) override;
+    void onDrawRRectSet(const SkRRect[], const SkColor4f[], int count, const SkMatrix[],
+                        const SkPaint&) override;
     class Iter;
 private:
     using INHERITED = SkCanvasVirtualEnforcer<SkNoDrawCanvas>;
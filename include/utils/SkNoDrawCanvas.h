@@ -70,6 +70,8 @@ protected:
     void onDrawEdgeAAImageSet2(const ImageSetEntry[], int, const SkPoint[], const SkMatrix[],
                                const SkSamplingOptions&, const SkPaint*,
                                SrcRectConstraint) override {}
+    void onDrawRRectSet(const SkRRect[], const SkColor4f[], int, const SkMatrix[],
+                        const SkPaint&) override {}
 
 private:
     using INHERITED = SkCanvasVirtualEnforcer<SkCanvas>;
@@ -8,11 +8,17 @@
 #include "modules/sksg/include/SkSGGroup.h"
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkTemplates.h"
 #include "modules/sksg/include/SkSGNode.h"
+#include "modules/sksg/src/SkSGNodePriv.h"
+#include "src/core/SkRectPriv.h"
 
 #include <algorithm>
+#include <cstdint>
 
 class SkMatrix;
 struct SkPoint;
@@ -65,13 +71,48 @@ void Group::removeChild(const sk_sp<RenderNode>& node) {
     this->invalidate();
 }
 
+namespace {
+
+// Children that draw everywhere (planes, inverse-filled paths) report bounds at or beyond the
+// large S32 rect. Those bounds stop being finite when mapped through a scale or rotation, and
+// would then be rejected, so such children are never culled.
+bool is_cullable(const SkRect& bounds) {
+    const SkRect large = SkRectPriv::MakeLargeS32();
+    return bounds.isFinite() && bounds.fLeft  > large.fLeft  && bounds.fTop    > large.fTop &&
+                                bounds.fRight < large.fRight && bounds.fBottom < large.fBottom;
+}
+
+}  // namespace
+
 void Group::onRender(SkCanvas* canvas, const RenderContext* ctx) const {
     const auto local_ctx = ScopedRenderContext(canvas, ctx).setIsolation(this->bounds(),
                                                                          canvas->getTotalMatrix(),
                                                                          fRequiresIsolation);
 
-    for (const auto& child : fChildren) {
-        child->render(canvas, local_ctx);
+    // Cull all the children against the clip at once; their bounds are in our local space.
+    const size_t count = fChildren.size();
+    skia_private::AutoSTArray<16, SkRect> child_bounds(count);
+    for (size_t i = 0; i < count; ++i) {
+        child_bounds[i] = NodePriv::Bounds(fChildren[i].get());
+    }
+    skia_private::AutoSTMalloc<1, uint32_t> visible((count + 31) / 32);
+    int visible_count = canvas->quickReject(SkSpan(child_bounds.get(), count), visible.get());
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t bit = 1u << (i & 31);
+        if (!(visible[i >> 5] & bit) && !is_cullable(child_bounds[i])) {
+            visible[i >> 5] |= bit;
+            visible_count++;
+        }
+    }
+    if (!visible_count) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (visible[i >> 5] & (1u << (i & 31))) {
+            fChildren[i]->render(canvas, local_ctx);
+        }
     }
 }
 
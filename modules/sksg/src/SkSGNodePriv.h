@@ -18,6 +18,8 @@ public:
 
     static bool HasInval(const sk_sp<Node>& node) { return node->hasInval(); }
 
+    static const SkRect& Bounds(const Node* node) { return node->bounds(); }
+
 private:
     NodePriv() = delete;
 };
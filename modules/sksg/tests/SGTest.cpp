@@ -9,14 +9,22 @@
 
 #if !defined(SK_BUILD_FOR_GOOGLE3)
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
 #include "include/private/base/SkTo.h"
 #include "modules/sksg/include/SkSGDraw.h"
 #include "modules/sksg/include/SkSGGroup.h"
 #include "modules/sksg/include/SkSGInvalidationController.h"
 #include "modules/sksg/include/SkSGPaint.h"
+#include "modules/sksg/include/SkSGPlane.h"
 #include "modules/sksg/include/SkSGRect.h"
 #include "modules/sksg/include/SkSGRenderEffect.h"
+#include "modules/sksg/include/SkSGRenderNode.h"
 #include "modules/sksg/include/SkSGTransform.h"
 #include "src/core/SkRectPriv.h"
 
@@ -355,4 +363,84 @@ DEF_TEST(SGInvalidation, reporter) {
     inval_group_remove(reporter);
 }
 
+namespace {
+
+// Counts how many times it is rendered, and reports fixed bounds.
+class CountingNode final : public sksg::RenderNode {
+public:
+    explicit CountingNode(const SkRect& bounds) : fBoundsForTest(bounds) {}
+
+    int renderCount() const { return fRenderCount; }
+
+protected:
+    void onRender(SkCanvas*, const RenderContext*) const override { ++fRenderCount; }
+    const RenderNode* onNodeAt(const SkPoint&) const override { return nullptr; }
+    SkRect onRevalidate(sksg::InvalidationController*, const SkMatrix&) override {
+        return fBoundsForTest;
+    }
+
+private:
+    const SkRect fBoundsForTest;
+    mutable int  fRenderCount = 0;
+};
+
+}  // namespace
+
+static void render(const sk_sp<sksg::RenderNode>& root, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(32, 32);
+    bitmap->eraseColor(SK_ColorWHITE);
+    root->revalidate(nullptr, SkMatrix::I());
+
+    SkCanvas canvas(*bitmap);
+    root->render(&canvas);
+}
+
+// Planes report bounds that overflow when mapped through a scale or rotation; they must still
+// draw, and not be culled by their group.
+DEF_TEST(SGGroupCullPlane, reporter) {
+    for (const SkMatrix& m : {SkMatrix::I(),
+                              SkMatrix::Scale(2, 2),
+                              SkMatrix::RotateDeg(30, {16, 16}),
+                              SkMatrix::Scale(-1, 1)}) {
+        auto grp = sksg::Group::Make();
+        grp->addChild(sksg::Draw::Make(sksg::Plane::Make(), sksg::Color::Make(SK_ColorBLUE)));
+        auto root = sksg::TransformEffect::Make(grp, m);
+
+        SkBitmap bitmap;
+        render(root, &bitmap);
+        REPORTER_ASSERT(reporter, bitmap.getColor(16, 16) == SK_ColorBLUE);
+    }
+}
+
+// Children whose bounds miss the clip are skipped, the rest are rendered.
+DEF_TEST(SGGroupCullChildren, reporter) {
+    const SkRect kChildBounds[] = {
+        SkRect::MakeXYWH(  0,   0, 10, 10),  // visible
+        SkRect::MakeXYWH(100, 100, 10, 10),  // outside the canvas
+        SkRect::MakeXYWH( 28,  -4, 10, 10),  // straddles the edge
+        SkRect::MakeXYWH(-50,   0, 10, 10),  // outside the canvas
+        SkRectPriv::MakeLargeS32(),           // unbounded
+    };
+    const bool kExpectRendered[] = {true, false, true, false, true};
+
+    for (const SkMatrix& m : {SkMatrix::I(), SkMatrix::Scale(2, 2)}) {
+        auto grp = sksg::Group::Make();
+        std::vector<sk_sp<CountingNode>> children;
+        for (const SkRect& bounds : kChildBounds) {
+            children.push_back(sk_make_sp<CountingNode>(bounds));
+            grp->addChild(children.back());
+        }
+        auto root = sksg::TransformEffect::Make(grp, m);
+
+        SkBitmap bitmap;
+        render(root, &bitmap);
+        for (size_t i = 0; i < children.size(); ++i) {
+            const bool rendered = children[i]->renderCount() > 0;
+            // Under the 2x scale, the straddling child lands outside the canvas too.
+            const bool expected = kExpectRendered[i] && !(i == 2 && !m.isIdentity());
+            REPORTER_ASSERT(reporter, rendered == expected, "child %zu", i);
+        }
+    }
+}
+
 #endif // !defined(SK_BUILD_FOR_GOOGLE3)
@@ -370,6 +370,11 @@ void SkBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
 #endif
 }
 
+void SkBitmapDevice::drawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                                  const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    LOOP_TILER( drawRRectSet(rrects, colors, count, preViewMatrices, paint), nullptr )
+}
+
 void SkBitmapDevice::drawPath(const SkPath& path,
                               const SkPaint& paint,
                               bool pathIsMutable) {
@@ -566,6 +571,15 @@ void SkBitmapDevice::drawAtlas(const SkRSXform xform[],
     BDDraw(this).drawAtlas(xform, tex, colors, count, std::move(blender), paint);
 }
 
+void SkBitmapDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
+    // Rect, circle and rrect occluders are drawn analytically, without tessellating or caching
+    // a mesh. The analytic path draws in device space, so it isn't used when we need to tile.
+    if (!SkDrawTiler::NeedsTiling(this) && BDDraw(this).drawAnalyticShadow(path, rec)) {
+        return;
+    }
+    this->SkDevice::drawShadow(path, rec);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkBitmapDevice::drawSpecial(SkSpecialImage* src,
@@ -37,6 +37,7 @@ class SkSurfaceProps;
 class SkVertices;
 enum class SkClipOp;
 namespace sktext { class GlyphRunList; }
+struct SkDrawShadowRec;
 struct SkImageInfo;
 struct SkPoint;
 struct SkRSXform;
@@ -68,6 +69,8 @@ public:
     void drawRect(const SkRect& r, const SkPaint& paint) override;
     void drawOval(const SkRect& oval, const SkPaint& paint) override;
     void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+    void drawRRectSet(const SkRRect[], const SkColor4f[], int count,
+                      const SkMatrix preViewMatrices[], const SkPaint&) override;
 
     void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
 
@@ -82,6 +85,8 @@ public:
     void drawAtlas(const SkRSXform[], const SkRect[], const SkColor[], int count, sk_sp<SkBlender>,
                    const SkPaint&) override;
 
+    void drawShadow(const SkPath&, const SkDrawShadowRec&) override;
+
     ///////////////////////////////////////////////////////////////////////////
 
     void pushClipStack() override;
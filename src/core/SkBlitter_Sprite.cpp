@@ -228,6 +228,9 @@ SkBlitter* SkBlitter::ChooseSprite(const SkPixmap& dst, const SkPaint& paint,
                     break;
             }
         }
+        if (!blitter) {
+            blitter = SkSpriteBlitter::ChoosePlanes(dst, source, paint, alloc);
+        }
     }
     if (!blitter && !paint.getMaskFilter()) {
         blitter = alloc->make<SkRasterPipelineSpriteBlitter>(source, alloc, clipShader);
@@ -34,6 +34,7 @@
 #include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "include/core/SkVertices.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSafe32.h"
@@ -44,6 +45,7 @@
 #include "include/utils/SkNoDrawCanvas.h"
 #include "src/base/SkEnumBitMask.h"
 #include "src/base/SkMSAN.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkBlenderBase.h"
 #include "src/core/SkBlurMaskFilterImpl.h"
 #include "src/core/SkCanvasPriv.h"
@@ -191,6 +193,14 @@ SkCanvas::Layer::Layer(sk_sp<SkDevice> device,
     SkASSERT(!fPaint.getImageFilter());
 }
 
+SkCanvas::Layer::Layer(const DeferredDevice& deferred, const SkPaint& paint)
+        : fPaint(paint)
+        , fIsCoverage(false)
+        , fDiscard(false)
+        , fDeferred(deferred) {
+    SkASSERT(!fPaint.getImageFilter());
+}
+
 SkCanvas::BackImage::BackImage(sk_sp<SkSpecialImage> img, SkIPoint loc)
                                :fImage(img), fLoc(loc) {}
 SkCanvas::BackImage::BackImage(const BackImage&) = default;
@@ -218,6 +228,12 @@ void SkCanvas::MCRec::newLayer(sk_sp<SkDevice> layerDevice,
     fDevice = fLayer->fDevice.get();
 }
 
+void SkCanvas::MCRec::newDeferredLayer(const Layer::DeferredDevice& deferred,
+                                       const SkPaint& restorePaint) {
+    SkASSERT(!fBackImage);
+    fLayer = std::make_unique<Layer>(deferred, restorePaint);
+}
+
 void SkCanvas::MCRec::reset(SkDevice* device) {
     SkASSERT(!fLayer);
     SkASSERT(device);
@@ -254,6 +270,8 @@ std::optional<AutoLayerForImageFilter> SkCanvas::aboutToDraw(
         const SkPaint& paint,
         const SkRect* rawBounds,
         SkEnumBitMask<PredrawFlags> flags) {
+    this->checkForDeferredLayer();
+
     if (flags & PredrawFlags::kCheckForOverwrite) {
         if (!this->predrawNotify(rawBounds, &paint, flags)) {
             return std::nullopt;
@@ -428,6 +446,51 @@ void SkCanvas::checkForDeferredSave() {
     }
 }
 
+void SkCanvas::checkForDeferredLayer() {
+    // Only the top record can have a deferred layer, since internalSave() allocates it first.
+    if (fMCRec->fLayer && fMCRec->fLayer->fDeferred) {
+        this->allocateDeferredLayer();
+    }
+}
+
+void SkCanvas::allocateDeferredLayer() {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    Layer* layer = fMCRec->fLayer.get();
+    SkASSERT(layer && layer->fDeferred && !layer->fDevice);
+    const Layer::DeferredDevice deferred = *layer->fDeferred;
+    layer->fDeferred.reset();
+
+    // The prior device's clip started out as the layer's bounds, and has only been intersected
+    // with pixel-aligned rects since (see onClipRect()), so its bounds are exactly what the layer
+    // can still draw to.
+    SkDevice* priorDevice = fMCRec->fDevice;
+    const SkIRect layerBounds = priorDevice->devClipBounds();
+
+    sk_sp<SkDevice> newDevice;
+    if (!layerBounds.isEmpty()) {
+        const SkImageInfo info = SkImageInfo::Make(layerBounds.size(), deferred.fColorInfo);
+        newDevice = priorDevice->createDevice(
+                SkDevice::CreateInfo(info, deferred.fPixelGeometry, fAllocator.get()),
+                /*layerPaint=*/nullptr);
+    }
+    if (!newDevice) {
+        newDevice = sk_make_sp<SkNoPixelsDevice>(SkIRect::MakeSize(layerBounds.size()),
+                                                 fProps, this->imageInfo().refColorSpace());
+    }
+
+    // Deferred layers have no filters, so the layer is just an integer translation of the prior
+    // device, and picks up any matrix changes made since the saveLayer().
+    newDevice->setDeviceCoordinateSystem(priorDevice->deviceToGlobal(),
+                                         priorDevice->globalToDevice(),
+                                         priorDevice->localToDevice44(),
+                                         layerBounds.left(),
+                                         layerBounds.top());
+
+    layer->fDevice = std::move(newDevice);
+    fMCRec->fDevice = layer->fDevice.get();
+    fQuickRejectBounds = this->computeDeviceClipBounds();
+}
+
 int SkCanvas::getSaveCount() const {
 #ifdef SK_DEBUG
     int count = 0;
@@ -488,6 +551,9 @@ void SkCanvas::restoreToCount(int count) {
 }
 
 void SkCanvas::internalSave() {
+    // The new record would inherit the prior device instead of the layer's.
+    this->checkForDeferredLayer();
+
     fMCRec = new (fMCStack.push_back()) MCRec(fMCRec);
 
     this->topDevice()->pushClipStack();
@@ -991,35 +1057,65 @@ void SkCanvas::internalSaveLayer(const SaveLayerRec& rec,
         }
     }
 
+    SkColorType layerColorType;
+    if (coverageOnly) {
+        layerColorType = kAlpha_8_SkColorType;
+    } else {
+        layerColorType = SkToBool(rec.fSaveLayerFlags & kF16ColorType)
+                                ? kRGBA_F16_SkColorType
+                                : image_filter_color_type(priorDevice->imageInfo().colorInfo());
+    }
+    const SkColorInfo layerColorInfo(layerColorType,
+                                     kPremul_SkAlphaType,
+                                     rec.fColorSpace ? sk_ref_sp(rec.fColorSpace)
+                                                     : priorDevice->imageInfo().refColorSpace());
+    const SkPixelGeometry geo = rec.fSaveLayerFlags & kPreserveLCDText_SaveLayerFlag
+                                        ? fProps.pixelGeometry()
+                                        : kUnknown_SkPixelGeometry;
+    bool initBackdrop = (rec.fSaveLayerFlags & kInitWithPrevious_SaveLayerFlag) || rec.fBackdrop;
+
+    // A raster layer without filters or a backdrop starts out transparent and is only an integer
+    // translation of the prior device, so there's no need to allocate it until something draws
+    // into it. Layers whose draws are all culled are never allocated, and any clip applied before
+    // the first draw shrinks the allocation. Until then the prior device takes the layer's clip
+    // and matrix changes, so its clip must start out as a plain rect, and its surface props must
+    // match the layer's, for the canvas to report the same state it would with the layer.
+    // A layer that is never drawn to is also never restored, which is only correct if restoring a
+    // transparent layer would leave the prior device unchanged. So the restore must be trivial,
+    // blend with src-over, and not have a color filter that affects transparent black; kClear,
+    // kDstIn, or a color filter that adds color would all modify the prior device.
+    const bool emptyRestoreIsNoOp =
+            trivialRestore &&
+            (!blender || as_BB(blender)->asBlendMode() == SkBlendMode::kSrcOver) &&
+            (!cf || !as_CFB(cf)->affectsTransparentBlack());
+    SkPixmap priorPixels;
+    if (strategy == kFullLayer_SaveLayerStrategy && filters.empty() && !initBackdrop &&
+        emptyRestoreIsNoOp && !coverageOnly && !fAllocator &&
+        priorDevice->peekPixels(&priorPixels) && priorDevice->isClipRect() &&
+        !priorDevice->isClipAntiAliased() &&
+        priorDevice->surfaceProps().pixelGeometry() == geo &&
+        newLayerMapping.layerToDevice().isIdentity()) {
+        if (SkIRect(layerBounds) != priorDevice->devClipBounds()) {
+            // The bounds hint restricted the layer, so restrict the prior device's clip to match.
+            SkAutoDeviceTransformRestore adtr(priorDevice, SkMatrix::I());
+            priorDevice->clipRect(SkRect::Make(SkIRect(layerBounds)), SkClipOp::kIntersect,
+                                  /*aa=*/false);
+        }
+        fMCRec->newDeferredLayer({layerColorInfo, geo}, restorePaint);
+        fQuickRejectBounds = this->computeDeviceClipBounds();
+        return;
+    }
+
     sk_sp<SkDevice> newDevice;
     if (strategy == kFullLayer_SaveLayerStrategy) {
         SkASSERT(!layerBounds.isEmpty());
 
-        SkColorType layerColorType;
-        if (coverageOnly) {
-            layerColorType = kAlpha_8_SkColorType;
-        } else {
-            layerColorType = SkToBool(rec.fSaveLayerFlags & kF16ColorType)
-                                    ? kRGBA_F16_SkColorType
-                                    : image_filter_color_type(priorDevice->imageInfo().colorInfo());
-        }
-        SkImageInfo info =
-                SkImageInfo::Make(layerBounds.width(),
-                                  layerBounds.height(),
-                                  layerColorType,
-                                  kPremul_SkAlphaType,
-                                  rec.fColorSpace ? sk_ref_sp(rec.fColorSpace)
-                                                  : priorDevice->imageInfo().refColorSpace());
-
-        SkPixelGeometry geo = rec.fSaveLayerFlags & kPreserveLCDText_SaveLayerFlag
-                                      ? fProps.pixelGeometry()
-                                      : kUnknown_SkPixelGeometry;
+        SkImageInfo info = SkImageInfo::Make(SkIRect(layerBounds).size(), layerColorInfo);
         const auto createInfo = SkDevice::CreateInfo(info, geo, fAllocator.get());
         // Use the original paint as a hint so that it includes the image filter
         newDevice = priorDevice->createDevice(createInfo, rec.fPaint);
     }
 
-    bool initBackdrop = (rec.fSaveLayerFlags & kInitWithPrevious_SaveLayerFlag) || rec.fBackdrop;
     if (!newDevice) {
         // Either we weren't meant to allocate a full layer, or the full layer creation failed.
         // Using an explicit NoPixelsDevice lets us reflect what the layer state would have been
@@ -1085,6 +1181,7 @@ int SkCanvas::saveLayerAlphaf(const SkRect* bounds, float alpha) {
 }
 
 void SkCanvas::internalSaveBehind(const SkRect* localBounds) {
+    this->checkForDeferredLayer();
     SkDevice* device = this->topDevice();
 
     // Map the local bounds into the top device's coordinate space (this is not
@@ -1154,7 +1251,9 @@ void SkCanvas::internalRestore() {
 
     // Draw the layer's device contents into the now-current older device. We can't call public
     // draw functions since we don't want to record them.
-    if (layer && !layer->fDevice->isNoPixelsDevice() && !layer->fDiscard) {
+    // A layer that is still deferred was never drawn to, and internalSaveLayer() only defers
+    // layers whose restore paint leaves the prior device unchanged when the layer is transparent.
+    if (layer && layer->fDevice && !layer->fDevice->isNoPixelsDevice() && !layer->fDiscard) {
         layer->fDevice->setImmutable();
 
         // Don't go through AutoLayerForImageFilter since device draws are so closely tied to
@@ -1270,6 +1369,7 @@ void* SkCanvas::accessTopLayerPixels(SkImageInfo* info, size_t* rowBytes, SkIPoi
 }
 
 bool SkCanvas::onAccessTopLayerPixels(SkPixmap* pmap) {
+    this->checkForDeferredLayer();
     return this->topDevice()->accessPixels(pmap);
 }
 
@@ -1371,6 +1471,17 @@ void SkCanvas::onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle edgeSty
     SkASSERT(rect.isSorted());
     const bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    if (fMCRec->fLayer && fMCRec->fLayer->fDeferred) {
+        // A deferred layer can keep using the prior device's clip as long as it remains a
+        // pixel-aligned rect, which then becomes the bounds of the layer once it's allocated.
+        const SkMatrix& localToDevice = this->topDevice()->localToDevice();
+        const SkRect devRect = localToDevice.mapRect(rect);
+        if (op != SkClipOp::kIntersect || !localToDevice.rectStaysRect() ||
+            (isAA && devRect != SkRect::Make(devRect.round()))) {
+            this->allocateDeferredLayer();
+        }
+    }
+
     AutoUpdateQRBounds aqr(this);
     this->topDevice()->clipRect(rect, op, isAA);
 }
@@ -1422,6 +1533,7 @@ void SkCanvas::internal_private_resetClip() {
 }
 
 void SkCanvas::onResetClip() {
+    this->checkForDeferredLayer();
     SkIRect deviceRestriction = this->topDevice()->imageInfo().bounds();
     if (fClipRestrictionSaveCount >= 0 && this->topDevice() == this->rootDevice()) {
         // Respect the device clip restriction when resetting the clip if we're on the base device.
@@ -1447,6 +1559,7 @@ void SkCanvas::clipRRect(const SkRRect& rrect, SkClipOp op, bool doAA) {
 }
 
 void SkCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edgeStyle) {
+    this->checkForDeferredLayer();
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
     AutoUpdateQRBounds aqr(this);
@@ -1479,6 +1592,7 @@ void SkCanvas::clipPath(const SkPath& path, SkClipOp op, bool doAA) {
 }
 
 void SkCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
+    this->checkForDeferredLayer();
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
     AutoUpdateQRBounds aqr(this);
@@ -1503,6 +1617,7 @@ void SkCanvas::clipShader(sk_sp<SkShader> sh, SkClipOp op) {
 }
 
 void SkCanvas::onClipShader(sk_sp<SkShader> sh, SkClipOp op) {
+    this->checkForDeferredLayer();
     AutoUpdateQRBounds aqr(this);
     this->topDevice()->clipShader(sh, op);
 }
@@ -1513,6 +1628,7 @@ void SkCanvas::clipRegion(const SkRegion& rgn, SkClipOp op) {
 }
 
 void SkCanvas::onClipRegion(const SkRegion& rgn, SkClipOp op) {
+    this->checkForDeferredLayer();
     AutoUpdateQRBounds aqr(this);
     this->topDevice()->clipRegion(rgn, op);
 }
@@ -1564,6 +1680,52 @@ bool SkCanvas::quickReject(const SkRect& src) const {
     return !devRect.isFinite() || !devRect.intersects(fQuickRejectBounds);
 }
 
+int SkCanvas::quickReject(SkSpan<const SkRect> rects, uint32_t visible[]) const {
+#ifdef SK_DEBUG
+    // Verify that fQuickRejectBounds are set properly.
+    this->validateClip();
+#endif
+
+    // Rects are mapped to device space a chunk at a time, then tested against the clip bounds four
+    // at a time, with one lane per rect. The chunk size is a multiple of 32 so each chunk fills
+    // whole words of 'visible'.
+    constexpr int kChunk = 64;
+    using F = skvx::float4;
+    const F clipL(fQuickRejectBounds.fLeft),  clipT(fQuickRejectBounds.fTop),
+            clipR(fQuickRejectBounds.fRight), clipB(fQuickRejectBounds.fBottom);
+
+    const int count = SkToInt(rects.size());
+    std::fill_n(visible, (count + 31) / 32, 0);
+
+    SkRect devRects[kChunk];
+    int visibleCount = 0;
+    for (int start = 0; start < count; start += kChunk) {
+        const int n = std::min(kChunk, count - start);
+        SkMatrixPriv::MapRects(fMCRec->fMatrix, devRects, rects.data() + start, n);
+        // Pad to a multiple of four with empty rects, which never intersect.
+        for (int i = n; i < SkAlign4(n); ++i) {
+            devRects[i].setEmpty();
+        }
+
+        for (int i = 0; i < n; i += 4) {
+            F l, t, r, b;
+            skvx::strided_load4(&devRects[i].fLeft, l, t, r, b);
+            // Same as SkRect::isFinite() and SkRect::Intersects(); NaNs fail every comparison.
+            const auto isFinite = (l*0 == 0) & (t*0 == 0) & (r*0 == 0) & (b*0 == 0);
+            const auto hit = isFinite & (max(l, clipL) < min(r, clipR)) &
+                                        (max(t, clipT) < min(b, clipB));
+            for (int j = 0; j < 4; ++j) {
+                if (hit[j]) {
+                    const int index = start + i + j;
+                    visible[index >> 5] |= 1u << (index & 31);
+                    visibleCount++;
+                }
+            }
+        }
+    }
+    return visibleCount;
+}
+
 bool SkCanvas::quickReject(const SkPath& path) const {
     return path.isEmpty() || this->quickReject(path.getBounds());
 }
@@ -1836,6 +1998,7 @@ void SkCanvas::private_draw_shadow_rec(const SkPath& path, const SkDrawShadowRec
 void SkCanvas::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
     // We don't test quickReject because the shadow outsets the path's bounds.
     // TODO(michaelludwig): Is it worth calling SkDrawShadowMetrics::GetLocalBounds here?
+    this->checkForDeferredLayer();
     if (!this->predrawNotify()) {
         return;
     }
@@ -1850,6 +2013,18 @@ void SkCanvas::experimental_DrawEdgeAAQuad(const SkRect& rect, const SkPoint cli
     this->onDrawEdgeAAQuad(rect.makeSorted(), clip, aaFlags, color, mode);
 }
 
+void SkCanvas::experimental_DrawRRectSet(const SkRRect rrects[], const SkColor4f colors[],
+                                         int cnt, const SkMatrix preViewMatrices[],
+                                         const SkPaint& paint) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    if (cnt <= 0) {
+        // Nothing to draw
+        return;
+    }
+    SkASSERT(rrects && colors);
+    this->onDrawRRectSet(rrects, colors, cnt, preViewMatrices, paint);
+}
+
 void SkCanvas::experimental_DrawEdgeAAImageSet(const ImageSetEntry imageSet[], int cnt,
                                                const SkPoint dstClips[],
                                                const SkMatrix preViewMatrices[],
@@ -2029,6 +2204,7 @@ void SkCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
 }
 
 void SkCanvas::onDrawBehind(const SkPaint& paint) {
+    this->checkForDeferredLayer();
     SkDevice* dev = this->topDevice();
     if (!dev) {
         return;
@@ -2231,6 +2407,7 @@ void SkCanvas::onDrawImageRect2(const SkImage* image, const SkRect& src, const S
     // simplicity since *somehow* embedding colorization or mask blurring into the filter graph
     // would likely be equivalent to using the existing AutoLayerForImageFilter functionality.
     if (realPaint.getImageFilter() && !image->isAlphaOnly() && !realPaint.getMaskFilter()) {
+        this->checkForDeferredLayer();
         SkDevice* device = this->topDevice();
 
         skif::ParameterSpace<SkRect> imageBounds{dst};
@@ -2630,6 +2807,7 @@ void SkCanvas::onDrawEdgeAAQuad(const SkRect& r, const SkPoint clip[4], QuadAAFl
         return;
     }
 
+    this->checkForDeferredLayer();
     if (this->predrawNotify()) {
         this->topDevice()->drawEdgeAAQuad(r, clip, edgeAA, color, mode);
     }
@@ -2680,6 +2858,31 @@ void SkCanvas::onDrawEdgeAAImageSet2(const ImageSetEntry imageSet[], int count,
     }
 }
 
+void SkCanvas::onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                              const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    // Each entry replaces the paint's color, so the paint's own alpha can't make the set a no-op.
+    SkPaint setPaint = paint;
+    setPaint.setColor4f(SkColors::kBlack);
+
+    // One quickReject() and one layer for the whole set, rather than one per entry.
+    SkRect setBounds = SkRect::MakeEmpty();
+    for (int i = 0; i < count; ++i) {
+        SkRect entryBounds = rrects[i].getBounds();
+        if (preViewMatrices) {
+            preViewMatrices[i].mapRect(&entryBounds);
+        }
+        setBounds.join(entryBounds);
+    }
+    if (this->internalQuickReject(setBounds, setPaint)) {
+        return;
+    }
+
+    auto layer = this->aboutToDraw(setPaint, &setBounds);
+    if (layer) {
+        this->topDevice()->drawRRectSet(rrects, colors, count, preViewMatrices, layer->paint());
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // These methods are NOT virtual, and therefore must call back into virtual
 // methods, rather than actually drawing themselves.
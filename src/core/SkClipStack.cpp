@@ -12,6 +12,7 @@
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkScalar.h"
 #include "include/private/base/SkDebug.h"
+#include "src/core/SkRRectPriv.h"
 #include "src/core/SkRectPriv.h"
 #include "src/shaders/SkShaderBase.h"
 
@@ -50,6 +51,8 @@ SkClipStack::Element::Element(const Element& that) {
     fFiniteBoundType = that.fFiniteBoundType;
     fFiniteBound = that.fFiniteBound;
     fIsIntersectionOfRects = that.fIsIntersectionOfRects;
+    fInteriorBound = that.fInteriorBound;
+    fIsAnyAA = that.fIsAnyAA;
     fGenID = that.fGenID;
 }
 
@@ -174,6 +177,8 @@ void SkClipStack::Element::initCommon(int saveCount, SkClipOp op, bool doAA) {
     fFiniteBoundType = kInsideOut_BoundsType;
     fFiniteBound.setEmpty();
     fIsIntersectionOfRects = false;
+    fInteriorBound.setEmpty();
+    fIsAnyAA = doAA;
     fGenID = kInvalidGenID;
 }
 
@@ -281,6 +286,7 @@ void SkClipStack::Element::setEmpty() {
     fFiniteBound.setEmpty();
     fFiniteBoundType = kNormal_BoundsType;
     fIsIntersectionOfRects = false;
+    fInteriorBound.setEmpty();
     fDeviceSpaceRRect.setEmpty();
     fDeviceSpacePath.reset();
     fShader.reset();
@@ -292,6 +298,7 @@ void SkClipStack::Element::checkEmpty() const {
     SkASSERT(fFiniteBound.isEmpty());
     SkASSERT(kNormal_BoundsType == fFiniteBoundType);
     SkASSERT(!fIsIntersectionOfRects);
+    SkASSERT(fInteriorBound.isEmpty());
     SkASSERT(kEmptyGenID == fGenID);
     SkASSERT(fDeviceSpaceRRect.isEmpty());
     SkASSERT(!fDeviceSpacePath.isValid());
@@ -499,6 +506,21 @@ void SkClipStack::Element::updateBoundAndGenID(const Element* prior) {
                 break;
         }
     } // else Replace just ignores everything prior and should already have filled in bounds.
+
+    // Only an intersection can keep a known interior; anything else (or a shape whose interior
+    // isn't cheap to find) leaves it empty, and quickContains() falls back to walking the stack.
+    fInteriorBound.setEmpty();
+    if (SkClipOp::kIntersect == fOp) {
+        if (DeviceSpaceType::kRect == fDeviceSpaceType) {
+            fInteriorBound = this->getDeviceSpaceRect();
+        } else if (DeviceSpaceType::kRRect == fDeviceSpaceType) {
+            fInteriorBound = SkRRectPriv::InnerBounds(fDeviceSpaceRRect);
+        }
+        if (prior && !this->isReplaceOp() && !fInteriorBound.intersect(prior->fInteriorBound)) {
+            fInteriorBound.setEmpty();
+        }
+    }
+    fIsAnyAA = fDoAA || (prior && prior->fIsAnyAA);
 }
 
 // This constant determines how many Element's are allocated together as a block in
@@ -637,6 +659,15 @@ void SkClipStack::getBounds(SkRect* canvFiniteBound,
 }
 
 bool SkClipStack::internalQuickContains(const SkRect& rect) const {
+    // Most queries are answered by the summary kept in the top element.
+    const Element* back = static_cast<const Element*>(fDeque.back());
+    if (back->fInteriorBound.contains(rect)) {
+        return true;
+    }
+    if (kNormal_BoundsType == back->fFiniteBoundType && !back->fFiniteBound.contains(rect)) {
+        return false;
+    }
+
     Iter iter(*this, Iter::kTop_IterStart);
     const Element* element = iter.prev();
     while (element != nullptr) {
@@ -663,6 +694,16 @@ bool SkClipStack::internalQuickContains(const SkRect& rect) const {
 }
 
 bool SkClipStack::internalQuickContains(const SkRRect& rrect) const {
+    // Most queries are answered by the summary kept in the top element.
+    const Element* back = static_cast<const Element*>(fDeque.back());
+    if (back->fInteriorBound.contains(rrect.getBounds())) {
+        return true;
+    }
+    if (kNormal_BoundsType == back->fFiniteBoundType &&
+        !back->fFiniteBound.contains(rrect.getBounds())) {
+        return false;
+    }
+
     Iter iter(*this, Iter::kTop_IterStart);
     const Element* element = iter.prev();
     while (element != nullptr) {
@@ -776,9 +817,9 @@ void SkClipStack::clipEmpty() {
     if (element && element->canBeIntersectedInPlace(fSaveCount, SkClipOp::kIntersect)) {
         element->setEmpty();
     }
-    new (fDeque.push_back()) Element(fSaveCount);
-
-    ((Element*)fDeque.back())->fGenID = kEmptyGenID;
+    Element* newElement = new (fDeque.push_back()) Element(fSaveCount);
+    newElement->fGenID = kEmptyGenID;
+    newElement->fIsAnyAA = element && element->fIsAnyAA;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -899,15 +940,24 @@ bool SkClipStack::isRRect(const SkRect& bounds, SkRRect* rrect, bool* aa) const
         if (!backBounds.intersect(bounds, back->asDeviceSpaceRRect().rect())) {
             return false;
         }
-        // We limit to 17 elements. This means the back element will be bounds checked at most 16
-        // times if it is an rrect.
         int cnt = fDeque.count();
-        if (cnt > 17) {
-            return false;
-        }
         if (cnt > 1) {
             SkDeque::Iter iter(fDeque, SkDeque::Iter::kBack_IterStart);
             SkAssertResult(static_cast<const Element*>(iter.prev()) == back);
+            SkDeque::Iter priorIter = iter;
+            const Element* prior = static_cast<const Element*>(priorIter.prev());
+            // Skip walking the stack, however deep it is, if everything before is already known to
+            // contain 'back'.
+            if (prior->fInteriorBound.contains(backBounds)) {
+                *rrect = back->asDeviceSpaceRRect();
+                *aa = back->isAA();
+                return true;
+            }
+            // Otherwise we limit to 17 elements. This means the back element will be bounds
+            // checked at most 16 times if it is an rrect.
+            if (cnt > 17) {
+                return false;
+            }
             while (const Element* prior = (const Element*)iter.prev()) {
                 // TODO: Once expanding clip ops are removed, this is equiv. to op == kDifference
                 if ((prior->getOp() != SkClipOp::kIntersect && !prior->isReplaceOp()) ||
@@ -938,6 +988,11 @@ uint32_t SkClipStack::GetNextGenID() {
     return id;
 }
 
+bool SkClipStack::isAnyAA() const {
+    const Element* back = static_cast<const Element*>(fDeque.back());
+    return back && back->fIsAnyAA;
+}
+
 uint32_t SkClipStack::getTopmostGenID() const {
     if (fDeque.empty()) {
         return kWideOpenGenID;
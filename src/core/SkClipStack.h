@@ -218,6 +218,13 @@ public:
         // equivalent to a single rect intersection? IIOW, is the clip effectively a rectangle.
         bool fIsIntersectionOfRects;
 
+        // These summarize this element together with all the elements before it in the stack, so
+        // that queries about the whole clip only need to look at the top element.
+        // fInteriorBound is a rect known to be inside the clip, or empty if none is known.
+        SkRect fInteriorBound;
+        // Is this element, or any element before it, anti-aliased?
+        bool fIsAnyAA;
+
         uint32_t fGenID;
         Element(int saveCount) {
             this->initCommon(saveCount, SkClipOp::kIntersect, false);
@@ -361,6 +368,11 @@ public:
      */
     bool isWideOpen() const { return this->getTopmostGenID() == kWideOpenGenID; }
 
+    /**
+     * Returns true if any element of the stack is anti-aliased.
+     */
+    bool isAnyAA() const;
+
     /**
      * This method quickly and conservatively determines whether the entire stack is equivalent to
      * intersection with a rrect given a bounds, where the rrect must not contain the entire bounds.
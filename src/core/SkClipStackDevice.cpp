@@ -70,15 +70,7 @@ void SkClipStackDevice::replaceClip(const SkIRect& rect) {
 }
 
 bool SkClipStackDevice::isClipAntiAliased() const {
-    SkClipStack::B2TIter        iter(fClipStack);
-    const SkClipStack::Element* element;
-
-    while ((element = iter.next()) != nullptr) {
-        if (element->isAA()) {
-            return true;
-        }
-    }
-    return false;
+    return fClipStack.isAnyAA();
 }
 
 bool SkClipStackDevice::isClipWideOpen() const {
@@ -293,6 +293,29 @@ void SkDevice::drawEdgeAAImageSet(const SkCanvas::ImageSetEntry images[], int co
     }
 }
 
+void SkDevice::drawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                            const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    SkPaint entryPaint = paint;
+    const SkM44 baseLocalToDevice = this->localToDevice44();
+    for (int i = 0; i < count; ++i) {
+        entryPaint.setColor4f(colors[i]);
+        if (preViewMatrices) {
+            this->setLocalToDevice(baseLocalToDevice * SkM44(preViewMatrices[i]));
+        }
+        const SkRRect& rrect = rrects[i];
+        if (rrect.isRect()) {
+            this->drawRect(rrect.rect(), entryPaint);
+        } else if (rrect.isOval()) {
+            this->drawOval(rrect.rect(), entryPaint);
+        } else {
+            this->drawRRect(rrect, entryPaint);
+        }
+        if (preViewMatrices) {
+            this->setLocalToDevice(baseLocalToDevice);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void SkDevice::drawDrawable(SkCanvas* canvas, SkDrawable* drawable, const SkMatrix* matrix) {
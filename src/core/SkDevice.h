@@ -410,6 +410,10 @@ public:
                                     const SkPoint dstClips[], const SkMatrix preViewMatrices[],
                                     const SkSamplingOptions&, const SkPaint&,
                                     SkCanvas::SrcRectConstraint);
+    // Default impl draws each entry with drawRect(), drawOval() or drawRRect(), using a copy of the
+    // paint with the entry's color and applying the entry's pre-view matrix, if any.
+    virtual void drawRRectSet(const SkRRect[], const SkColor4f[], int count,
+                              const SkMatrix preViewMatrices[], const SkPaint&);
 
     virtual void drawDrawable(SkCanvas*, SkDrawable*, const SkMatrix*);
 
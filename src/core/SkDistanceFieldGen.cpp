@@ -9,13 +9,17 @@
 
 #include "include/core/SkPoint.h"
 #include "include/core/SkScalar.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkAutoMalloc.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkPointPriv.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <utility>
@@ -30,53 +34,32 @@ struct DFData {
     SkPoint fDistVector; // distance vector to nearest (so far) edge texel
 };
 
-enum NeighborFlags {
-    kLeft_NeighborFlag        = 0x01,
-    kRight_NeighborFlag       = 0x02,
-    kTopLeft_NeighborFlag     = 0x04,
-    kTop_NeighborFlag         = 0x08,
-    kTopRight_NeighborFlag    = 0x10,
-    kBottomLeft_NeighborFlag  = 0x20,
-    kBottom_NeighborFlag      = 0x40,
-    kBottomRight_NeighborFlag = 0x80,
-    kAll_NeighborFlags        = 0xff,
-
-    kNeighborFlagCount        = 8
-};
-
 // We treat an "edge" as a place where we cross from >=128 to <128, or vice versa, or
 // where we have two non-zero pixels that are <128.
-// 'neighborFlags' is used to limit the directions in which we test to avoid indexing
-// outside of the image
-static bool found_edge(const unsigned char* imagePtr, int width, int neighborFlags) {
-    // the order of these should match the neighbor flags above
-    const int kNum8ConnectedNeighbors = 8;
-    const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
-    SkASSERT(kNum8ConnectedNeighbors == kNeighborFlagCount);
-
-    // search for an edge
-    unsigned char currVal = *imagePtr;
-    unsigned char currCheck = (currVal >> 7);
-    for (int i = 0; i < kNum8ConnectedNeighbors; ++i) {
-        unsigned char neighborVal;
-        if ((1 << i) & neighborFlags) {
-            const unsigned char* checkPtr = imagePtr + offsets[i];
-            neighborVal = *checkPtr;
-        } else {
-            neighborVal = 0;
-        }
-        unsigned char neighborCheck = (neighborVal >> 7);
-        SkASSERT(currCheck == 0 || currCheck == 1);
-        SkASSERT(neighborCheck == 0 || neighborCheck == 1);
-        // if sharp transition
-        if (currCheck != neighborCheck ||
-            // or both <128 and >0
-            (!currCheck && !neighborCheck && currVal && neighborVal)) {
-            return true;
+// 'image' must have a border of zeros, so that every pixel has 8 neighbors, and must be readable
+// 16 bytes past the end of each row, since pixels are tested 16 at a time. 'edges' is set to 255
+// (convenient for debug rendering) at each edge pixel.
+static void find_edges(const unsigned char* image, size_t rowBytes, int width,
+                       unsigned char* edges) {
+    using U8 = skvx::Vec<16, uint8_t>;
+    const ptrdiff_t rb = rowBytes;
+    const ptrdiff_t offsets[8] = {-1, 1, -rb-1, -rb, -rb+1, rb-1, rb, rb+1};
+
+    for (int i = 0; i < width; i += 16) {
+        const U8 curr = U8::Load(image + i);
+        const U8 currCheck = curr >> 7;
+        U8 edge(0);
+        for (ptrdiff_t offset : offsets) {
+            const U8 neighbor = U8::Load(image + i + offset);
+            const U8 neighborCheck = neighbor >> 7;
+            // if sharp transition, or both <128 and >0
+            edge |= (currCheck != neighborCheck) |
+                    ((currCheck == 0) & (neighborCheck == 0) & (curr != 0) & (neighbor != 0));
         }
+        uint8_t found[16];
+        edge.store(found);
+        memcpy(edges + i, found, std::min(16, width - i));
     }
-
-    return false;
 }
 
 static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned char* image,
@@ -87,6 +70,15 @@ static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned c
     data += pad;
     edges += (pad*dataWidth + pad);
 
+    // Give the image another border of zeros, so that find_edges() can test every neighbor.
+    const size_t borderedRowBytes = imageWidth + 2;
+    const size_t borderedSize = (imageHeight + 2)*borderedRowBytes + 16;
+    AutoSTMalloc<1024, unsigned char> bordered(borderedSize);
+    sk_bzero(bordered.get(), borderedSize);
+    for (int j = 0; j < imageHeight; ++j) {
+        memcpy(bordered.get() + (j + 1)*borderedRowBytes + 1, image + j*imageWidth, imageWidth);
+    }
+
     for (int j = 0; j < imageHeight; ++j) {
         for (int i = 0; i < imageWidth; ++i) {
             if (255 == *image) {
@@ -94,28 +86,13 @@ static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned c
             } else {
                 data->fAlpha = (*image)*0.00392156862f;  // 1/255
             }
-            int checkMask = kAll_NeighborFlags;
-            if (i == 0) {
-                checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
-            }
-            if (i == imageWidth-1) {
-                checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (j == 0) {
-                checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
-            }
-            if (j == imageHeight-1) {
-                checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (found_edge(image, imageWidth, checkMask)) {
-                *edges = 255;  // using 255 makes for convenient debug rendering
-            }
             ++data;
             ++image;
-            ++edges;
         }
+        find_edges(bordered.get() + (j + 1)*borderedRowBytes + 1, borderedRowBytes, imageWidth,
+                   edges);
         data += 2*pad;
-        edges += 2*pad;
+        edges += dataWidth;
     }
 }
 
@@ -206,125 +183,140 @@ static void init_distances(DFData* data, unsigned char* edges, int width, int he
     }
 }
 
-// Danielsson's 8SSEDT
-
-// first stage forward pass
-// (forward in Y, forward in X)
-static void F1(DFData* curr, int width) {
-    // upper left
-    DFData* check = curr - width-1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*(distVec.fX + distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+// The edge texels were given exact (sub-texel) distance vectors above; every other texel takes
+// the vector to the edge point of its nearest edge texel. The nearest edge texel is found with
+// Felzenszwalb and Huttenlocher's exact Euclidean distance transform (2012): first the nearest
+// edge texel in each column, then the lower envelope of parabolas along each row.
 
-    // up
-    check = curr - width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+// Sentinel row for columns with no edge texel; far enough away that any edge texel is closer.
+static constexpr int kNoEdgeRow = -(1 << 14);
+
+// For each texel, finds the row of the nearest edge texel in the same column. The scans run
+// along rows, so that each step handles many columns at once.
+static void nearest_edge_rows(const unsigned char* edges, int width, int height, int32_t* rows) {
+    using I32 = skvx::Vec<8, int32_t>;
+    using U8  = skvx::Vec<8, uint8_t>;
 
-    // upper right
-    check = curr - width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX - distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    // Down the image, taking the nearest edge at or above each texel...
+    for (int j = 0; j < height; ++j) {
+        const unsigned char* edgeRow = edges + j*width;
+        int32_t* row = rows + j*width;
+        const int32_t* above = row - width;
+        int i = 0;
+        for (; i + 8 <= width; i += 8) {
+            const I32 prev = j > 0 ? I32::Load(above + i) : I32(kNoEdgeRow);
+            const auto isEdge = skvx::cast<int32_t>(U8::Load(edgeRow + i)) != 0;
+            skvx::if_then_else(isEdge, I32(j), prev).store(row + i);
+        }
+        for (; i < width; ++i) {
+            row[i] = edgeRow[i] ? j : (j > 0 ? above[i] : kNoEdgeRow);
+        }
     }
 
-    // left
-    check = curr - 1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    // ...then back up, keeping whichever of that and the nearest edge below is closer.
+    for (int j = height - 2; j >= 0; --j) {
+        int32_t* row = rows + j*width;
+        const int32_t* below = row + width;
+        int i = 0;
+        for (; i + 8 <= width; i += 8) {
+            const I32 curr = I32::Load(row + i),
+                      next = I32::Load(below + i);
+            skvx::if_then_else(next - j < j - curr, next, curr).store(row + i);
+        }
+        for (; i < width; ++i) {
+            if (below[i] - j < j - row[i]) {
+                row[i] = below[i];
+            }
+        }
     }
 }
 
-// second stage forward pass
-// (forward in Y, backward in X)
-static void F2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Distances are clamped to SK_DistanceFieldMagnitude when packed, and an edge texel's edge point
+// is less than a texel from its center, so edge texels further away than this can be ignored.
+static constexpr int kMaxEdgeTexelDistance = SK_DistanceFieldMagnitude + 2;
+
+// For one row, finds the column of the nearest edge texel to each texel. 'cols' and 'f' list the
+// candidate columns, in increasing order, and the squared distance to the nearest edge texel in
+// each; they're overwritten with the parabolas of the lower envelope. 'z' is scratch space for
+// the boundaries between those parabolas.
+static void nearest_edge_columns(int* cols, float* f, int count, float* z,
+                                 int width, int32_t* columns) {
+    // Where the parabola rooted at candidate b crosses the one rooted at candidate a.
+    auto intersect = [&](int b, int a) {
+        return ((f[b] + cols[b]*cols[b]) - (f[a] + cols[a]*cols[a])) / (2*(cols[b] - cols[a]));
+    };
+
+    // The envelope is built in place in cols[0..k] and f[0..k]; k < q, so the candidates still
+    // to be visited aren't overwritten.
+    int k = 0;
+    z[0] = -SK_FloatInfinity;
+    z[1] =  SK_FloatInfinity;
+    for (int q = 1; q < count; ++q) {
+        float s = intersect(q, k);
+        while (s <= z[k]) {
+            --k;
+            s = intersect(q, k);
+        }
+        ++k;
+        cols[k] = cols[q];
+        f[k] = f[q];
+        z[k] = s;
+        z[k + 1] = SK_FloatInfinity;
     }
-}
 
-// first stage backward pass
-// (backward in Y, forward in X)
-static void B1(DFData* curr, int width) {
-    // left
-    DFData* check = curr - 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    k = 0;
+    for (int i = 0; i < width; ++i) {
+        while (z[k + 1] < i) {
+            ++k;
+        }
+        columns[i] = cols[k];
     }
 }
 
-// second stage backward pass
-// (backward in Y, backwards in X)
-static void B2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+// Propagates the distance vectors of the edge texels to every texel.
+static void propagate_distances(DFData* data, const unsigned char* edges,
+                                int width, int height) {
+    // rows, then per-row scratch: candidate columns, their distances, envelope, and result.
+    AutoSTMalloc<1024, int32_t> storage(width*height + 4*width + 1);
+    int32_t* rows    = storage.get();
+    int*     cols    = rows + width*height;
+    float*   f       = reinterpret_cast<float*>(cols + width);
+    float*   z       = f + width;
+    int32_t* columns = reinterpret_cast<int32_t*>(z + width + 1);
 
-    // bottom left
-    check = curr + width-1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*(distVec.fX - distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    nearest_edge_rows(edges, width, height, rows);
 
-    // bottom
-    check = curr + width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    for (int j = 0; j < height; ++j) {
+        const int32_t* row = rows + j*width;
+        int count = 0;
+        for (int i = 0; i < width; ++i) {
+            const int dy = row[i] - j;
+            if (-kMaxEdgeTexelDistance <= dy && dy <= kMaxEdgeTexelDistance) {
+                cols[count] = i;
+                f[count] = (float)(dy*dy);
+                ++count;
+            }
+        }
+        if (!count) {
+            // Everything in this row is too far from an edge to matter.
+            continue;
+        }
+        nearest_edge_columns(cols, f, count, z, width, columns);
 
-    // bottom right
-    check = curr + width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX + distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+        for (int i = 0; i < width; ++i) {
+            if (edges[j*width + i]) {
+                // Edge texels already know their distance.
+                continue;
+            }
+            const int edgeI = columns[i],
+                      edgeJ = row[edgeI];
+            const DFData& edge = data[edgeJ*width + edgeI];
+            const SkPoint distVec = {edge.fDistVector.fX + (edgeI - i),
+                                     edge.fDistVector.fY + (edgeJ - j)};
+            DFData* curr = data + j*width + i;
+            curr->fDistVector = distVec;
+            curr->fDistSq = SkPointPriv::LengthSqd(distVec);
+        }
     }
 }
 
@@ -347,6 +339,31 @@ static unsigned char pack_distance_field_val(float dist) {
     // (which represents zero).
     return (unsigned char)SkScalarRoundToInt(dist / (2 * distanceMagnitude) * 256.0f);
 }
+
+// Packs a row of distances, with the sign taken from each texel's alpha, 8 texels at a time.
+template <int distanceMagnitude>
+static void pack_distance_field_row(const DFData* data, int count, unsigned char* dst) {
+    using F = skvx::Vec<8, float>;
+    static_assert(sizeof(DFData) == 4*sizeof(float));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        F alpha, distSq, unusedX, unusedY;
+        skvx::strided_load4(reinterpret_cast<const float*>(data + i),
+                            alpha, distSq, unusedX, unusedY);
+        const F dist = sqrt(distSq);
+        // Same as pack_distance_field_val(), with the negation folded into the sign test.
+        F val = skvx::if_then_else(alpha > 0.5f, dist, -dist);
+        val = skvx::pin(val, F(-distanceMagnitude), F(distanceMagnitude * 127.0f / 128.0f));
+        val = (val + distanceMagnitude) * (256.0f / (2 * distanceMagnitude));
+        // val is non-negative, so truncating rounds just as SkScalarRoundToInt() does.
+        skvx::cast<uint8_t>(skvx::cast<int>(val + 0.5f)).store(dst + i);
+    }
+    for (; i < count; ++i) {
+        const float dist = SkScalarSqrt(data[i].fDistSq);
+        dst[i] = pack_distance_field_val<distanceMagnitude>(data[i].fAlpha > 0.5f ? -dist : dist);
+    }
+}
 #endif
 
 // assumes a padded 8-bit image and distance field
@@ -379,74 +396,15 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
     init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
 
     // now perform Euclidean distance transform to propagate distances
-
-    // forwards in y
-    DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData += dataWidth+1;
-        currEdge += dataWidth+1;
-    }
-
-    // backwards in y
-    currData = dataPtr+dataWidth*(dataHeight-2) - 1; // skip outer buffer
-    currEdge = edgePtr+dataWidth*(dataHeight-2) - 1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData -= dataWidth-1;
-        currEdge -= dataWidth-1;
-    }
+    propagate_distances(dataPtr, edgePtr, dataWidth, dataHeight);
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
+    DFData* currData = dataPtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
+#if DUMP_EDGE
+    unsigned char* currEdge = edgePtr + dataWidth+1;
     for (int j = 1; j < dataHeight-1; ++j) {
         for (int i = 1; i < dataWidth-1; ++i) {
-#if DUMP_EDGE
             float alpha = currData->fAlpha;
             float edge = 0.0f;
             if (*currEdge) {
@@ -456,21 +414,19 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
             float result = alpha + (1.0f-alpha)*edge;
             unsigned char val = sk_float_round2int(255*result);
             *dfPtr++ = val;
-#else
-            float dist;
-            if (currData->fAlpha > 0.5f) {
-                dist = -SkScalarSqrt(currData->fDistSq);
-            } else {
-                dist = SkScalarSqrt(currData->fDistSq);
-            }
-            *dfPtr++ = pack_distance_field_val<SK_DistanceFieldMagnitude>(dist);
-#endif
             ++currData;
             ++currEdge;
         }
         currData += 2;
         currEdge += 2;
     }
+#else
+    for (int j = 1; j < dataHeight-1; ++j) {
+        pack_distance_field_row<SK_DistanceFieldMagnitude>(currData, dataWidth-2, dfPtr);
+        currData += dataWidth;
+        dfPtr += dataWidth-2;
+    }
+#endif
 
     return true;
 }
@@ -26,8 +26,10 @@ class SkGlyph;
 class SkGlyphRunListPainterCPU;
 class SkMatrix;
 class SkPaint;
+class SkPath;
 class SkVertices;
 namespace sktext { class GlyphRunList; }
+struct SkDrawShadowRec;
 struct SkPoint3;
 struct SkPoint;
 struct SkRSXform;
@@ -59,6 +61,8 @@ public:
                       bool skipColorXform) const;
     void drawAtlas(const SkRSXform[], const SkRect[], const SkColor[], int count,
                    sk_sp<SkBlender>, const SkPaint&);
+    /* Returns false if the shadow can't be drawn analytically, and nothing was drawn. */
+    bool drawAnalyticShadow(const SkPath&, const SkDrawShadowRec&) const;
 
 #if defined(SK_SUPPORT_LEGACY_ALPHA_BITMAP_AS_COVERAGE)
     void drawDevMask(const SkMask& mask, const SkPaint&) const;
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
@@ -322,6 +323,103 @@ DRAW_PATH:
     this->drawPath(path, paint, nullptr, true);
 }
 
+void SkDrawBase::drawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                              const SkMatrix preViewMatrices[], const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    SkPaint entryPaint = paint;
+    SkMatrix ctm = *fCTM;
+    // Concatenate in 4x4 like SkCanvas::concat() and SkDevice::drawRRectSet() do, so each entry
+    // sees the same matrix, to the bit, as when it is drawn on its own.
+    const SkM44 baseCTM(*fCTM);
+    auto entryCTM = [&](int i) { return (baseCTM * SkM44(preViewMatrices[i])).asM33(); };
+
+    // Only plain fills can share a blitter between entries. A shader's context depends on the
+    // CTM, so it can only be shared if every entry uses the same one.
+    const bool canShareBlitter = paint.getStyle() == SkPaint::kFill_Style &&
+                                 !paint.getPathEffect() && !paint.getMaskFilter() &&
+                                 (!paint.getShader() || !preViewMatrices);
+    if (!canShareBlitter) {
+        SkDrawBase draw(*this);
+        draw.fCTM = &ctm;
+        for (int i = 0; i < count; ++i) {
+            if (preViewMatrices) {
+                ctm = entryCTM(i);
+            }
+            entryPaint.setColor4f(colors[i]);
+            // Dispatch like SkDevice::drawRRectSet() does, so each entry matches drawRect(),
+            // drawOval() or drawRRect() with the same paint, including AA, strokes, path effects
+            // and mask filters.
+            if (rrects[i].isRect()) {
+                draw.drawRect(rrects[i].rect(), entryPaint);
+            } else if (rrects[i].isOval()) {
+                draw.drawPath(SkPath::Oval(rrects[i].rect()), entryPaint, nullptr, true);
+            } else {
+                draw.drawRRect(rrects[i], entryPaint);
+            }
+        }
+        return;
+    }
+
+    // From here on, every entry is a plain fill without a mask filter. These are the fill cases
+    // of drawRect() and drawPath(), using the same geometry, but with one shared blitter.
+    SkASSERT(paint.getStyle() == SkPaint::kFill_Style && !paint.getMaskFilter());
+
+    std::optional<SkAutoBlitterChoose> blitter;
+    SkColor4f blitterColor;
+    SkPath path;
+    for (int i = 0; i < count; ++i) {
+        if (preViewMatrices) {
+            ctm = entryCTM(i);
+        }
+        const SkRRect& rrect = rrects[i];
+        const SkRect devBounds = ctm.mapRect(rrect.getBounds());
+        if (SkPathPriv::TooBigForMath(devBounds) || fRC->quickReject(devBounds.roundOut())) {
+            continue;
+        }
+
+        // Consecutive entries of the same color, e.g. the points of one series in a chart, reuse
+        // the blitter instead of choosing a new one for each draw.
+        if (!blitter || colors[i] != blitterColor) {
+            blitter.reset();
+            entryPaint.setColor4f(colors[i]);
+            blitter.emplace(*this, nullptr, entryPaint);
+            blitterColor = colors[i];
+        }
+
+        if (rrect.isRect() && ctm.rectStaysRect() && SkRectPriv::FitsInFixed(devBounds)) {
+            if (paint.isAntiAlias()) {
+                SkScan::AntiFillRect(devBounds, *fRC, blitter->get());
+            } else {
+                SkScan::FillRect(devBounds, *fRC, blitter->get());
+            }
+            continue;
+        }
+
+        path.reset();
+        if (rrect.isRect()) {
+            path.addRect(rrect.rect());
+        } else if (rrect.isOval()) {
+            path.addOval(rrect.rect());
+        } else {
+            path.addRRect(rrect);
+        }
+        path.transform(ctm);
+        if (SkPathPriv::TooBigForMath(path)) {
+            continue;
+        }
+        if (paint.isAntiAlias()) {
+            SkScan::AntiFillPath(path, *fRC, blitter->get());
+        } else {
+            SkScan::FillPath(path, *fRC, blitter->get());
+        }
+    }
+}
+
 void SkDrawBase::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                          SkBlitter* customBlitter, bool doFill) const {
     if (SkPathPriv::TooBigForMath(devPath)) {
@@ -9,6 +9,7 @@
 #define SkDrawBase_DEFINED
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -48,6 +49,11 @@ public:
         this->drawRect(rect, paint, nullptr, nullptr);
     }
     void    drawRRect(const SkRRect&, const SkPaint&) const;
+    // Draws each rrect as drawRRect() would, with the paint's color replaced by the entry's color
+    // and the CTM pre-concatenated with the entry's matrix (if 'preViewMatrices' is not null).
+    // Plain fills share one blitter between consecutive entries of the same color.
+    void    drawRRectSet(const SkRRect[], const SkColor4f[], int count,
+                         const SkMatrix preViewMatrices[], const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
      *  mutable, so that we don't have to make copies of it as we transform it.
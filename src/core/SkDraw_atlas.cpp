@@ -22,6 +22,7 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
+#include "src/core/SkBlitter.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkCoreBlitters.h"
@@ -40,7 +41,6 @@
 #include <optional>
 
 class SkBlender;
-class SkBlitter;
 enum class SkBlendMode;
 
 static void fill_rect(const SkMatrix& ctm, const SkRasterClip& rc,
@@ -129,22 +129,48 @@ void SkDraw::drawAtlas(const SkRSXform xform[],
     }
     SkPath scratchPath;
 
-    for (int i = 0; i < count; ++i) {
-        if (colors) {
-            SkColor4f c4 = SkColor4f::FromColor(colors[i]);
-            steps.apply(c4.vec());
-            load_color(uniformCtx, c4.premul().vec());
-        }
+    // Particle systems and sprite sheets draw many small sprites, most of which are scale and
+    // translate only. Those sprites are culled against the clip before paying for the inverse
+    // matrix and the per-sprite color, and when the clip is a rect they are blitted directly
+    // rather than going through SkScan's per-rect clip setup.
+    const SkIRect& clipBounds = fRC->getBounds();
+    const bool clipIsRect = fRC->isBW() && fRC->isRect();
 
+    for (int i = 0; i < count; ++i) {
         SkMatrix mx;
         mx.setRSXform(xform[i]);
         mx.preTranslate(-textures[i].fLeft, -textures[i].fTop);
         mx.postConcat(*fCTM);
+
+        SkRect devRect;
+        if (!perspective) {
+            devRect = mx.mapRect(textures[i]);
+            if (!SkIRect::Intersects(devRect.roundOut(), clipBounds)) {
+                continue;
+            }
+        }
+
         SkMatrix inv;
         if (!mx.invert(&inv)) {
             return;
         }
-        if (transformShader->update(inv)) {
+        if (!transformShader->update(inv)) {
+            continue;
+        }
+
+        if (colors) {
+            SkColor4f c4 = SkColor4f::FromColor(colors[i]);
+            steps.apply(c4.vec());
+            load_color(uniformCtx, c4.premul().vec());
+        }
+
+        if (clipIsRect && !perspective && mx.rectStaysRect()) {
+            // Matches the rounding of SkScan::FillRect.
+            SkIRect ir = devRect.round();
+            if (ir.intersect(clipBounds)) {
+                blitter->blitRect(ir.fLeft, ir.fTop, ir.width(), ir.height());
+            }
+        } else {
             fill_rect(mx, *fRC, textures[i], blitter, &scratchPath);
         }
     }
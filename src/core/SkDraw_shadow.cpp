@@ -0,0 +1,293 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkColor.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkPoint3.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkScalar.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/utils/SkShadowUtils.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkAutoBlitterChoose.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkDraw.h"
+#include "src/core/SkDrawShadowInfo.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkPointPriv.h"
+#include "src/core/SkRRectPriv.h"
+#include "src/core/SkRasterClip.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace {
+
+// A shadow that is a simple circular rrect in device space. Coverage falls off from 1 at fBlur
+// inside the border of fRRect (the outer edge of the penumbra) to 0 at the border itself. Pixels
+// more than fInsetWidth inside the border are not drawn, as with ShadowRRectOp's stroked rrects;
+// an infinite inset fills the whole shadow.
+struct AnalyticShadow {
+    SkRRect  fRRect;
+    SkScalar fBlur;
+    SkScalar fInsetWidth;
+    SkColor  fColor;
+};
+
+// The same falloff that ShadowRRectOp bakes into its lookup texture, and that the tessellated
+// shadows get from SkColorFilterPriv::MakeGaussian().
+const std::array<uint8_t, 256>& falloff_table() {
+    static const std::array<uint8_t, 256> gTable = [] {
+        std::array<uint8_t, 256> table;
+        for (int i = 0; i < 256; ++i) {
+            SkScalar d = SK_Scalar1 - i / SkIntToScalar(255);
+            SkScalar factor = SkScalarExp(-4 * d * d) - 0.018f;
+            table[i] = SkToU8(std::max(SkScalarRoundToInt(factor * 255), 0));
+        }
+        return table;
+    }();
+    return gTable;
+}
+
+// Writes the coverage of 'shadow' for the pixels in 'bounds' into 'dst'. The distance to the
+// border is computed with the usual rounded box distance function, kLanes pixels at a time.
+// As in ShadowRRectOp, the corners are rounded by at least the blur radius, and rrects (but not
+// circles) are always drawn at least that far in from their border.
+void compute_coverage(const AnalyticShadow& shadow, const SkIRect& bounds,
+                      uint8_t* dst, size_t rowBytes) {
+    constexpr int kLanes = 8;
+    using F = skvx::Vec<kLanes, float>;
+
+    const SkRect& r = shadow.fRRect.rect();
+    const float halfW = 0.5f * r.width(),
+                halfH = 0.5f * r.height();
+    const float radius = shadow.fRRect.isOval()
+            ? halfW
+            : std::min(std::max(SkRRectPriv::GetSimpleRadii(shadow.fRRect).fX, shadow.fBlur),
+                       std::min(halfW, halfH));
+    const float innerW = halfW - radius,
+                innerH = halfH - radius;
+    const float maxInside = shadow.fRRect.isOval() ? shadow.fInsetWidth
+                                                   : std::max(shadow.fInsetWidth, radius);
+    // A spot shadow with no blur has a hard edge.
+    const float invBlur = shadow.fBlur > 0 ? 255 / shadow.fBlur : SK_ScalarMax;
+    const F lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+    const auto& table = falloff_table();
+
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y, dst += rowBytes) {
+        const float qy = std::abs(y + 0.5f - r.centerY()) - innerH;
+        for (int x = bounds.fLeft; x < bounds.fRight; x += kLanes) {
+            F qx = abs(lanes + (x + 0.5f - r.centerX())) - innerW;
+            F ox = max(qx, 0.f),
+              oy = std::max(qy, 0.f);
+            // The signed distance to the border of the rrect, negated so it is positive inside.
+            F inside = radius - sqrt(ox*ox + oy*oy) - min(max(qx, qy), 0.f);
+            skvx::int8 index = skvx::cast<int32_t>(pin(inside * invBlur, F(0), F(255)) + 0.5f);
+            // Index 0 maps to no coverage.
+            index = if_then_else(inside > maxInside, skvx::int8(0), index);
+
+            const int n = std::min(kLanes, bounds.fRight - x);
+            for (int i = 0; i < n; ++i) {
+                dst[x - bounds.fLeft + i] = table[index[i]];
+            }
+        }
+    }
+}
+
+// How far the spot shadow's shape is from the occluder's at its farthest corner, computed as in
+// drawFastShadow. The spot shadow's band has to reach this far in under the occluder.
+SkScalar spot_offset(const SkRRect& occluder, const SkRRect& shadow) {
+    const SkRect& o = occluder.rect();
+    const SkRect& s = shadow.rect();
+    if (occluder.isRect()) {
+        // Manhattan distance works better for rects
+        return std::max(std::max(SkTAbs(s.fLeft - o.fLeft), SkTAbs(s.fTop - o.fTop)),
+                        std::max(SkTAbs(s.fRight - o.fRight), SkTAbs(s.fBottom - o.fBottom)));
+    }
+    const SkScalar dr = SkRRectPriv::GetSimpleRadii(shadow).fX -
+                        SkRRectPriv::GetSimpleRadii(occluder).fX;
+    const SkVector upperLeft = {s.fLeft - o.fLeft + dr, s.fTop - o.fTop + dr},
+                   lowerRight = {s.fRight - o.fRight - dr, s.fBottom - o.fBottom - dr};
+    return SkScalarSqrt(std::max(SkPointPriv::LengthSqd(upperLeft),
+                                 SkPointPriv::LengthSqd(lowerRight))) + dr;
+}
+
+// Mirrors the ambient and spot geometry of SurfaceDrawContext::drawFastShadow, but directly in
+// device space. Returns false if the occluder or the matrix can't be handled analytically.
+bool compute_shadows(const SkPath& path, const SkDrawShadowRec& rec, const SkMatrix& ctm,
+                     AnalyticShadow* ambient, AnalyticShadow* spot, bool* empty) {
+    const bool tiltZPlane = !SkScalarNearlyZero(rec.fZPlaneParams.fX) ||
+                            !SkScalarNearlyZero(rec.fZPlaneParams.fY);
+    const bool skipAnalytic = SkToBool(rec.fFlags & SkShadowFlags::kGeometricOnly_ShadowFlag);
+    if (tiltZPlane || skipAnalytic || !ctm.rectStaysRect() || !ctm.isSimilarity()) {
+        return false;
+    }
+
+    SkRRect rrect;
+    SkRect rect;
+    // we can only handle rects, circles, and simple rrects with circular corners
+    bool isRRect = path.isRRect(&rrect) && SkRRectPriv::IsNearlySimpleCircular(rrect) &&
+                   rrect.getSimpleRadii().fX > SK_ScalarNearlyZero;
+    if (!isRRect &&
+        path.isOval(&rect) && SkScalarNearlyEqual(rect.width(), rect.height()) &&
+        rect.width() > SK_ScalarNearlyZero) {
+        rrect.setOval(rect);
+        isRRect = true;
+    }
+    if (!isRRect && path.isRect(&rect)) {
+        rrect.setRect(rect);
+        isRRect = true;
+    }
+    if (!isRRect) {
+        return false;
+    }
+
+    SkRRect devRRect;
+    if (!rrect.transform(ctm, &devRRect)) {
+        return false;
+    }
+    *empty = devRRect.isEmpty();
+    if (*empty) {
+        return true;
+    }
+
+    auto outset = [](const SkRRect& rr, SkScalar outset) {
+        SkRect outsetRect = rr.rect().makeOutset(outset, outset);
+        // If the rrect was an oval then its outset will also be one.
+        // We set it explicitly to avoid errors.
+        if (rr.isOval()) {
+            return SkRRect::MakeOval(outsetRect);
+        }
+        SkScalar outsetRad = SkRRectPriv::GetSimpleRadii(rr).fX + outset;
+        return SkRRect::MakeRectXY(outsetRect, outsetRad, outsetRad);
+    };
+
+    const SkScalar occluderHeight = rec.fZPlaneParams.fZ;
+    // As in drawFastShadow, only transparent occluders have their shadows filled. Otherwise just
+    // a band reaching in under the occluder is drawn.
+    const bool transparent = SkToBool(rec.fFlags & SkShadowFlags::kTransparentOccluder_ShadowFlag);
+    const SkScalar devScale = SkScalarSqrt(ctm.getScaleX() * ctm.getScaleX() +
+                                           ctm.getSkewX() * ctm.getSkewX());
+    if (SkColorGetA(rec.fAmbientColor) > 0) {
+        SkScalar devSpaceInsetWidth = SkDrawShadowMetrics::AmbientBlurRadius(occluderHeight);
+        const SkScalar umbraRecipAlpha = SkDrawShadowMetrics::AmbientRecipAlpha(occluderHeight);
+
+        // An occluder resting on the plane has no ambient shadow.
+        if (devSpaceInsetWidth > 0) {
+            // Outset the shadow rrect to the border of the penumbra
+            ambient->fRRect = outset(devRRect, devSpaceInsetWidth);
+            ambient->fBlur = devSpaceInsetWidth * umbraRecipAlpha;
+            ambient->fInsetWidth = transparent ? SK_ScalarInfinity : devSpaceInsetWidth * devScale;
+            ambient->fColor = rec.fAmbientColor;
+        }
+    }
+
+    if (SkColorGetA(rec.fSpotColor) > 0) {
+        const bool directional = SkToBool(rec.fFlags & kDirectionalLight_ShadowFlag);
+        SkPoint3 devLightPos = rec.fLightPos;
+        if (!directional) {
+            ctm.mapPoints((SkPoint*)&devLightPos.fX, 1);
+        }
+
+        SkScalar devSpaceSpotBlur;
+        SkScalar spotScale;
+        SkVector spotOffset;
+        if (directional) {
+            SkDrawShadowMetrics::GetDirectionalParams(occluderHeight, devLightPos.fX,
+                                                      devLightPos.fY, devLightPos.fZ,
+                                                      rec.fLightRadius, &devSpaceSpotBlur,
+                                                      &spotScale, &spotOffset);
+        } else {
+            SkDrawShadowMetrics::GetSpotParams(occluderHeight, devLightPos.fX, devLightPos.fY,
+                                               devLightPos.fZ, rec.fLightRadius,
+                                               &devSpaceSpotBlur, &spotScale, &spotOffset);
+        }
+
+        // In device space the spot shadow is the occluder scaled about the origin, then offset.
+        SkRRect spotShadowRRect;
+        SkMatrix shadowTransform = SkMatrix::Scale(spotScale, spotScale);
+        shadowTransform.postTranslate(spotOffset.fX, spotOffset.fY);
+        if (!devRRect.transform(shadowTransform, &spotShadowRRect)) {
+            return false;
+        }
+
+        // ShadowRRectOp is given a blur width of twice the spot blur radius.
+        spot->fRRect = outset(spotShadowRRect, devSpaceSpotBlur);
+        spot->fBlur = 2 * devSpaceSpotBlur;
+        spot->fInsetWidth = transparent ? SK_ScalarInfinity
+                                        : devSpaceSpotBlur + std::max(devSpaceSpotBlur,
+                                                                      spot_offset(devRRect,
+                                                                                  spotShadowRRect));
+        spot->fColor = rec.fSpotColor;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool SkDraw::drawAnalyticShadow(const SkPath& path, const SkDrawShadowRec& rec) const {
+    AnalyticShadow shadows[2] = {{SkRRect(), 0, 0, SK_ColorTRANSPARENT},
+                                 {SkRRect(), 0, 0, SK_ColorTRANSPARENT}};
+    bool empty = false;
+    if (!compute_shadows(path, rec, *fCTM, &shadows[0], &shadows[1], &empty)) {
+        return false;
+    }
+    if (empty || fRC->isEmpty()) {
+        return true;
+    }
+
+    // The coverage is computed a band of rows at a time, so large shadows don't need a mask
+    // covering their entire bounds.
+    constexpr int kBandHeight = 16;
+    skia_private::AutoTMalloc<uint8_t> storage;
+
+    for (const AnalyticShadow& shadow : shadows) {
+        if (SkColorGetA(shadow.fColor) == 0 || !shadow.fRRect.getBounds().isFinite()) {
+            continue;
+        }
+        SkIRect bounds = shadow.fRRect.getBounds().roundOut();
+        if (!bounds.intersect(fRC->getBounds())) {
+            continue;
+        }
+
+        SkPaint paint;
+        paint.setColor(shadow.fColor);
+        SkAutoBlitterChoose blitterChooser(*this, nullptr, paint);
+        SkBlitter* blitter = blitterChooser.get();
+        if (!blitter) {
+            continue;
+        }
+        SkAAClipBlitterWrapper wrapper;
+        const SkRegion* clipRgn;
+        if (fRC->isBW()) {
+            clipRgn = &fRC->bwRgn();
+        } else {
+            wrapper.init(*fRC, blitter);
+            clipRgn = &wrapper.getRgn();
+            blitter = wrapper.getBlitter();
+        }
+
+        const int width = bounds.width();
+        storage.realloc(width * kBandHeight);
+        for (int top = bounds.fTop; top < bounds.fBottom; top += kBandHeight) {
+            const SkIRect band = SkIRect::MakeLTRB(bounds.fLeft, top, bounds.fRight,
+                                                   std::min(top + kBandHeight, bounds.fBottom));
+            compute_coverage(shadow, band, storage.get(), width);
+            SkMask mask(storage.get(), band, width, SkMask::kA8_Format);
+            for (SkRegion::Cliperator clipper(*clipRgn, band); !clipper.done(); clipper.next()) {
+                blitter->blitMask(mask, clipper.rect());
+            }
+        }
+    }
+    return true;
+}
@@ -13,6 +13,7 @@
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/base/SkAutoMalloc.h"
 #include "src/base/SkZip.h"
 #include "src/core/SkAAClip.h"
 #include "src/core/SkBlitter.h"
@@ -25,6 +26,7 @@
 
 #include <cstdint>
 #include <climits>
+#include <cstring>
 
 class SkCanvas;
 class SkPaint;
@@ -49,6 +51,89 @@ static bool check_glyph_position(SkPoint position) {
              lt(position.fY, INT_MIN - (INT16_MIN + 0 /*UINT16_MIN*/)));
 }
 
+namespace {
+// Gathers the masks of neighbouring glyphs into one mask, so that a run of glyphs is clipped and
+// blitted with one call instead of one call per glyph. A glyph only joins the batch if it lies
+// entirely outside the batch so far, so no pixel is covered twice and the result is the same as
+// blitting each glyph on its own.
+class GlyphMaskBatch {
+public:
+    // Returns false if the mask can't join this batch; flush() it and try again.
+    bool add(const SkMask& mask) {
+        if (mask.fFormat != SkMask::kA8_Format && mask.fFormat != SkMask::kLCD16_Format) {
+            return false;
+        }
+        const int64_t area = mask.fBounds.width() * (int64_t)mask.fBounds.height();
+        if (fCount == 0) {
+            fFormat = mask.fFormat;
+            fBounds = mask.fBounds;
+            fGlyphArea = area;
+        } else {
+            if (fCount == kMaxGlyphs || mask.fFormat != fFormat ||
+                SkIRect::Intersects(fBounds, mask.fBounds)) {
+                return false;
+            }
+            SkIRect joined = fBounds;
+            joined.join(mask.fBounds);
+            // Don't let clearing the space between glyphs cost more than the saved blits.
+            const int64_t joinedArea = joined.width() * (int64_t)joined.height();
+            if (joinedArea > kMaxArea || joinedArea > 2 * (fGlyphArea + area)) {
+                return false;
+            }
+            fBounds = joined;
+            fGlyphArea += area;
+        }
+        fGlyphs[fCount++] = {mask.fImage, mask.fBounds, mask.fRowBytes};
+        return true;
+    }
+
+    // Calls blit() with the mask of everything in the batch, and empties it.
+    template <typename Fn>
+    void flush(Fn&& blit) {
+        if (fCount == 1) {
+            blit(SkMask(fGlyphs[0].fImage, fGlyphs[0].fBounds, fGlyphs[0].fRowBytes, fFormat));
+        } else if (fCount > 1) {
+            const size_t bpp = fFormat == SkMask::kLCD16_Format ? 2 : 1,
+                         rowBytes = fBounds.width() * bpp,
+                         size = rowBytes * fBounds.height();
+            uint8_t* image = static_cast<uint8_t*>(
+                    fStorage.reset(size, SkAutoMalloc::kReuse_OnShrink));
+            sk_bzero(image, size);
+            for (int i = 0; i < fCount; ++i) {
+                const Glyph& glyph = fGlyphs[i];
+                uint8_t* dst = image + (glyph.fBounds.fTop - fBounds.fTop) * rowBytes
+                                     + (glyph.fBounds.fLeft - fBounds.fLeft) * bpp;
+                const uint8_t* src = glyph.fImage;
+                for (int y = 0; y < glyph.fBounds.height(); ++y) {
+                    memcpy(dst, src, glyph.fBounds.width() * bpp);
+                    dst += rowBytes;
+                    src += glyph.fRowBytes;
+                }
+            }
+            blit(SkMask(image, fBounds, SkToU32(rowBytes), fFormat));
+        }
+        fCount = 0;
+    }
+
+private:
+    static constexpr int kMaxGlyphs = 64;
+    static constexpr int64_t kMaxArea = 64 * 1024;
+
+    struct Glyph {
+        const uint8_t* fImage;
+        SkIRect        fBounds;
+        uint32_t       fRowBytes;
+    };
+
+    Glyph          fGlyphs[kMaxGlyphs];
+    int            fCount = 0;
+    SkMask::Format fFormat = SkMask::kA8_Format;
+    SkIRect        fBounds = SkIRect::MakeEmpty();
+    int64_t        fGlyphArea = 0;
+    SkAutoMalloc   fStorage;
+};
+}  // namespace
+
 void SkDraw::paintMasks(SkZip<const SkGlyph*, SkPoint> accepted, const SkPaint& paint) const {
     // The size used for a typical blitter.
     SkSTArenaAlloc<3308> alloc;
@@ -64,63 +149,59 @@ void SkDraw::paintMasks(SkZip<const SkGlyph*, SkPoint> accepted, const SkPaint&
     blitter = wrapper.getBlitter();
 
     bool useRegion = fRC->isBW() && !fRC->isRect();
-
-    if (useRegion) {
-        for (auto [glyph, pos] : accepted) {
-            if (check_glyph_position(pos)) {
-                SkMask mask = glyph->mask(pos);
-
-                SkRegion::Cliperator clipper(fRC->bwRgn(), mask.fBounds);
-
-                if (!clipper.done()) {
-                    if (SkMask::kARGB32_Format == mask.fFormat) {
-                        SkBitmap bm;
-                        bm.installPixels(SkImageInfo::MakeN32Premul(mask.fBounds.size()),
-                                         const_cast<uint8_t*>(mask.fImage),
-                                         mask.fRowBytes);
-                        bm.setImmutable();
-                        this->drawSprite(bm, mask.fBounds.x(), mask.fBounds.y(), paint);
-                    } else {
-                        const SkIRect& cr = clipper.rect();
-                        do {
-                            blitter->blitMask(mask, cr);
-                            clipper.next();
-                        } while (!clipper.done());
-                    }
-                }
+    SkIRect clipBounds = fRC->isBW() ? fRC->bwRgn().getBounds()
+                                     : fRC->aaRgn().getBounds();
+
+    auto clippedOut = [&](const SkIRect& bounds) {
+        return useRegion ? !fRC->bwRgn().intersects(bounds)
+                         : !SkIRect::Intersects(bounds, clipBounds);
+    };
+
+    auto blitMask = [&](const SkMask& mask) {
+        if (useRegion) {
+            for (SkRegion::Cliperator clipper(fRC->bwRgn(), mask.fBounds); !clipper.done();
+                 clipper.next()) {
+                blitter->blitMask(mask, clipper.rect());
+            }
+        } else {
+            // this extra test is worth it, assuming that most of the time it succeeds
+            // since we can avoid writing to storage
+            if (clipBounds.containsNoEmptyCheck(mask.fBounds)) {
+                blitter->blitMask(mask, mask.fBounds);
+            } else if (SkIRect storage; storage.intersect(mask.fBounds, clipBounds)) {
+                blitter->blitMask(mask, storage);
             }
         }
-    } else {
-        SkIRect clipBounds = fRC->isBW() ? fRC->bwRgn().getBounds()
-                                         : fRC->aaRgn().getBounds();
-        for (auto [glyph, pos] : accepted) {
-            if (check_glyph_position(pos)) {
-                SkMask mask = glyph->mask(pos);
-                SkIRect storage;
-                const SkIRect* bounds = &mask.fBounds;
-
-                // this extra test is worth it, assuming that most of the time it succeeds
-                // since we can avoid writing to storage
-                if (!clipBounds.containsNoEmptyCheck(mask.fBounds)) {
-                    if (!storage.intersect(mask.fBounds, clipBounds)) {
-                        continue;
-                    }
-                    bounds = &storage;
-                }
+    };
 
-                if (SkMask::kARGB32_Format == mask.fFormat) {
-                    SkBitmap bm;
-                    bm.installPixels(SkImageInfo::MakeN32Premul(mask.fBounds.size()),
-                                     const_cast<uint8_t*>(mask.fImage),
-                                     mask.fRowBytes);
-                    bm.setImmutable();
-                    this->drawSprite(bm, mask.fBounds.x(), mask.fBounds.y(), paint);
-                } else {
-                    blitter->blitMask(mask, *bounds);
-                }
+    GlyphMaskBatch batch;
+    for (auto [glyph, pos] : accepted) {
+        if (!check_glyph_position(pos)) {
+            continue;
+        }
+        SkMask mask = glyph->mask(pos);
+        if (batch.add(mask)) {
+            continue;
+        }
+        batch.flush(blitMask);
+        if (batch.add(mask)) {
+            continue;
+        }
+
+        if (SkMask::kARGB32_Format == mask.fFormat) {
+            if (!clippedOut(mask.fBounds)) {
+                SkBitmap bm;
+                bm.installPixels(SkImageInfo::MakeN32Premul(mask.fBounds.size()),
+                                 const_cast<uint8_t*>(mask.fImage),
+                                 mask.fRowBytes);
+                bm.setImmutable();
+                this->drawSprite(bm, mask.fBounds.x(), mask.fBounds.y(), paint);
             }
+        } else {
+            blitMask(mask);
         }
     }
+    batch.flush(blitMask);
 }
 
 void SkDraw::drawGlyphRunList(SkCanvas* canvas,
@@ -30,8 +30,10 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkBlenderBase.h"
 #include "src/core/SkConvertPixels.h"
+#include "src/core/SkBlitter.h"
 #include "src/core/SkCoreBlitters.h"
 #include "src/core/SkDraw.h"
+#include "src/core/SkEdge.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkScan.h"
 #include "src/core/SkSurfacePriv.h"
@@ -41,13 +43,12 @@
 #include "src/shaders/SkTransformShader.h"
 #include "src/shaders/SkTriColorShader.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <utility>
 
-class SkBlitter;
-
 [[nodiscard]] static bool texture_to_matrix(const VertState& state, const SkPoint verts[],
                                             const SkPoint texs[], SkMatrix* matrix) {
     SkPoint src[3], dst[3];
@@ -95,16 +96,102 @@ static bool compute_is_opaque(const SkColor colors[], int count) {
     return SkColorGetA(c) == 0xFF;
 }
 
-static void fill_triangle_2(const VertState& state, SkBlitter* blitter, const SkRasterClip& rc,
+// Scan converts the triangles of a mesh. Meshes are usually made of many small triangles, where
+// the per-triangle clipper setup, edge sorting and edge list walking of SkScan::FillTriangle
+// dominate the cost of actually blitting. When the clip is a rectangle that contains a triangle,
+// the triangle's edges are instead built with SkEdge::setLine and walked directly.
+//
+// The spans are exactly the ones SkScan::FillTriangle produces: the edges are the same SkEdges,
+// and each row's x is the value SkScan reaches by stepping the edge one row at a time. Triangles
+// that take either path can therefore share edges without leaving seams or blitting twice.
+class TriangleRasterizer {
+public:
+    TriangleRasterizer(const SkRasterClip& rc, SkBlitter* blitter)
+            : fRC(rc)
+            , fBlitter(blitter)
+            , fClip(MakeFastClip(rc)) {}
+
+    void fill(const SkPoint pts[3]) {
+        SkRect r;
+        r.setBounds(pts, 3);
+        // SkScan doesn't clip triangles whose conservatively rounded bounds are inside the clip.
+        // Staying a pixel inside it keeps the two paths in agreement about that.
+        if (!fClip.contains(r)) {
+            SkScan::FillTriangle(pts, fRC, fBlitter);
+            return;
+        }
+
+        SkEdge edges[3];
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            count += edges[count].setLine(pts[i], pts[(i + 1) % 3], nullptr, 0);
+        }
+        if (count < 2) {
+            return;
+        }
+
+        int top = edges[0].fFirstY,
+            bottom = edges[0].fLastY;
+        for (int i = 1; i < count; ++i) {
+            top = std::min(top, (int)edges[i].fFirstY);
+            bottom = std::max(bottom, (int)edges[i].fLastY);
+        }
+        for (int y = top; y <= bottom; ++y) {
+            // Every row of a triangle crosses exactly two of its edges.
+            SkFixed x[2];
+            int active = 0;
+            for (int i = 0; i < count && active < 2; ++i) {
+                const SkEdge& edge = edges[i];
+                if (edge.fFirstY <= y && y <= edge.fLastY) {
+                    // Wraps the same way as SkScan's repeated fX += fDX.
+                    x[active++] = (SkFixed)((uint32_t)edge.fX +
+                                            (uint32_t)(y - edge.fFirstY) * (uint32_t)edge.fDX);
+                }
+            }
+            if (active < 2) {
+                continue;
+            }
+            int L = SkFixedRoundToInt(x[0]),
+                R = SkFixedRoundToInt(x[1]);
+            if (L > R) {
+                std::swap(L, R);
+            }
+            if (L < R) {
+                fBlitter->blitH(L, y, R - L);
+            }
+        }
+    }
+
+private:
+    // The region in which triangles take the fast path: the clip's bounds inset by one pixel, when
+    // the clip is a rectangle, and limited as in SkScan::FillTriangle so that edges fit in SkFixed.
+    static SkRect MakeFastClip(const SkRasterClip& rc) {
+        if (!rc.isBW() || !rc.isRect()) {
+            return SkRect::MakeEmpty();
+        }
+        constexpr SkScalar kLimit = SK_MaxS16 >> 1;
+        SkRect clip = SkRect::Make(rc.getBounds()).makeInset(1, 1);
+        if (!clip.intersect(SkRect::MakeLTRB(-kLimit, -kLimit, kLimit, kLimit))) {
+            return SkRect::MakeEmpty();
+        }
+        return clip;
+    }
+
+    const SkRasterClip& fRC;
+    SkBlitter*          fBlitter;
+    const SkRect        fClip;
+};
+
+static void fill_triangle_2(const VertState& state, TriangleRasterizer* rasterizer,
                             const SkPoint dev2[]) {
     SkPoint tmp[] = {
         dev2[state.f0], dev2[state.f1], dev2[state.f2]
     };
-    SkScan::FillTriangle(tmp, rc, blitter);
+    rasterizer->fill(tmp);
 }
 
 static constexpr int kMaxClippedTrianglePointCount = 4;
-static void fill_triangle_3(const VertState& state, SkBlitter* blitter, const SkRasterClip& rc,
+static void fill_triangle_3(const VertState& state, TriangleRasterizer* rasterizer,
                             const SkPoint3 dev3[]) {
     // Compute the crossing point (across zero) for the two values, expressed as a
     // normalized 0...1 value. If curr is 0, returns 0. If next is 0, returns 1.
@@ -166,21 +253,21 @@ static void fill_triangle_3(const VertState& state, SkBlitter* blitter, const Sk
     if (int n = clipTriangle(tmp, idx, dev3)) {
         // TODO: SkScan::FillConvexPoly(tmp, n, ...);
         SkASSERT(n == 3 || n == 4);
-        SkScan::FillTriangle(tmp, rc, blitter);
+        rasterizer->fill(tmp);
         if (n == 4) {
             tmp[1] = tmp[2];
             tmp[2] = tmp[3];
-            SkScan::FillTriangle(tmp, rc, blitter);
+            rasterizer->fill(tmp);
         }
     }
 }
 
-static void fill_triangle(const VertState& state, SkBlitter* blitter, const SkRasterClip& rc,
+static void fill_triangle(const VertState& state, TriangleRasterizer* rasterizer,
                           const SkPoint dev2[], const SkPoint3 dev3[]) {
     if (dev3) {
-        fill_triangle_3(state, blitter, rc, dev3);
+        fill_triangle_3(state, rasterizer, dev3);
     } else {
-        fill_triangle_2(state, blitter, rc, dev2);
+        fill_triangle_2(state, rasterizer, dev2);
     }
 }
 
@@ -292,6 +379,7 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
     if (!blitter) {
         return;
     }
+    TriangleRasterizer rasterizer(*fRC, blitter);
     while (vertProc(&state)) {
         if (triColorShader && !triColorShader->update(ctmInverse, positions, dstColors,
                                                       state.f0, state.f1, state.f2)) {
@@ -301,7 +389,7 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
         SkMatrix localM;
         if (!transformShader || (texture_to_matrix(state, positions, texCoords, &localM) &&
                                  transformShader->update(SkMatrix::Concat(localM, ctmInverse)))) {
-            fill_triangle(state, blitter, *fRC, dev2, dev3);
+            fill_triangle(state, &rasterizer, dev2, dev3);
         }
     }
 }
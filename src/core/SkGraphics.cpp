@@ -12,6 +12,7 @@
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkMatrixPriv.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
@@ -26,6 +27,7 @@ void SkGraphics::Init() {
     SkOpts::Init_BitmapProcState();
     SkOpts::Init_BlitMask();
     SkOpts::Init_BlitRow();
+    SkOpts::Init_Matrix();
     SkOpts::Init_Memset();
     SkOpts::Init_Swizzler();
 }
@@ -15,6 +15,8 @@
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkPathPriv.h"
 
+#include <algorithm>
+
 bool SkM44::operator==(const SkM44& other) const {
     if (this == &other) {
         return true;
@@ -223,6 +225,36 @@ SkRect SkMatrixPriv::MapRect(const SkM44& m, const SkRect& src) {
     }
 }
 
+void SkMatrixPriv::MapRects(const SkM44& m, SkRect dst[], const SkRect src[], int count) {
+    if (count <= 0) {
+        return;
+    }
+    const bool hasPerspective =
+            m.fMat[3] != 0 || m.fMat[7] != 0 || m.fMat[11] != 0 || m.fMat[15] != 1;
+    // With z = 0 the 3rd row and column drop out, leaving the same 3x3 an SkMatrix would hold.
+    const SkScalar m33[9] = {m.rc(0,0), m.rc(0,1), m.rc(0,3),
+                             m.rc(1,0), m.rc(1,1), m.rc(1,3),
+                             m.rc(3,0), m.rc(3,1), m.rc(3,3)};
+    if (!hasPerspective) {
+        SkOpts::matrix_map_rects_affine(m33, dst, src, count);
+        return;
+    }
+
+    // Rects that need clipping come back as NaN, so map into a temporary in case dst == src.
+    constexpr int kChunk = 64;
+    SkRect mapped[kChunk];
+    for (int start = 0; start < count; start += kChunk) {
+        const int n = std::min(kChunk, count - start);
+        SkOpts::matrix_map_rects_persp(m33, SkPathPriv::kW0PlaneDistance, mapped, src + start, n);
+        for (int i = 0; i < n; ++i) {
+            if (SkIsNaN(mapped[i].fLeft)) {
+                mapped[i] = map_rect_perspective(src[start + i], m.fMat);
+            }
+        }
+        std::copy_n(mapped, n, dst + start);
+    }
+}
+
 void SkM44::normalizePerspective() {
     // If the bottom row of the matrix is [0, 0, 0, not_one], we will treat the matrix as if it
     // is in perspective, even though it stills behaves like its affine. If we divide everything
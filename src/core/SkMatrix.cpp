@@ -22,6 +22,7 @@
 #include "src/base/SkVx.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkMatrixUtils.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkSamplingPriv.h"
 
 #include <algorithm>
@@ -958,28 +959,18 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
     SkASSERT(m.hasPerspective());
 
     if (count > 0) {
-        do {
-            SkScalar sy = src->fY;
-            SkScalar sx = src->fX;
-            src += 1;
-
-            SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
-            SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
-            SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
-            if (z) {
-                z = 1 / z;
-            }
-
-            dst->fY = y * z;
-            dst->fX = x * z;
-            dst += 1;
-        } while (--count);
+        SkOpts::matrix_map_points_persp(m.fMat, dst, src, count);
     }
 }
 
 void SkMatrix::Affine_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() != SkMatrix::kPerspective_Mask);
-    if (count > 0) {
+    // The wider SkOpts kernels do the same math, but aren't worth the indirect call for the
+    // handful of points in a rect or quad.
+    constexpr int kMinOptsCount = 16;
+    if (count >= kMinOptsCount) {
+        SkOpts::matrix_map_points_affine(m.fMat, dst, src, count);
+    } else if (count > 0) {
         SkScalar tx = m.getTranslateX();
         SkScalar ty = m.getTranslateY();
         SkScalar sx = m.getScaleX();
@@ -1167,6 +1158,34 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src, SkApplyPerspectiveClip pc
     }
 }
 
+void SkMatrixPriv::MapRects(const SkMatrix& m, SkRect dst[], const SkRect src[], int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (m.isScaleTranslate()) {
+        for (int i = 0; i < count; ++i) {
+            m.mapRectScaleTranslate(&dst[i], src[i]);
+        }
+    } else if (!m.hasPerspective()) {
+        SkOpts::matrix_map_rects_affine(m.fMat, dst, src, count);
+    } else {
+        // Rects that need clipping come back as NaN, so map into a temporary in case dst == src.
+        constexpr int kChunk = 64;
+        SkRect mapped[kChunk];
+        for (int start = 0; start < count; start += kChunk) {
+            const int n = std::min(kChunk, count - start);
+            SkOpts::matrix_map_rects_persp(m.fMat, SkPathPriv::kW0PlaneDistance,
+                                           mapped, src + start, n);
+            for (int i = 0; i < n; ++i) {
+                if (SkIsNaN(mapped[i].fLeft)) {
+                    m.mapRect(&mapped[i], src[start + i], SkApplyPerspectiveClip::kYes);
+                }
+            }
+            std::copy_n(mapped, n, dst + start);
+        }
+    }
+}
+
 SkScalar SkMatrix::mapRadius(SkScalar radius) const {
     SkVector    vec[2];
 
@@ -199,6 +199,13 @@ public:
     // rectangle will be the bounding box of the projected points after being clipped to w > 0.
     static SkRect MapRect(const SkM44& m, const SkRect& r);
 
+    // Batched versions of SkMatrix::mapRect() and MapRect(SkM44) above, for callers that cull or
+    // bound many rects against the same matrix. Each dst[i] is the bounds of the mapped src[i],
+    // and is the same as mapping that rect on its own, up to rounding. Perspective rects that
+    // cross the w = 0 plane are clipped just as the single rect versions do. dst may equal src.
+    static void MapRects(const SkMatrix& m, SkRect dst[], const SkRect src[], int count);
+    static void MapRects(const SkM44& m, SkRect dst[], const SkRect src[], int count);
+
     // Returns the differential area scale factor for a local point 'p' that will be transformed
     // by 'm' (which may have perspective). If 'm' does not have perspective, this scale factor is
     // constant regardless of 'p'; when it does have perspective, it is specific to that point.
@@ -218,4 +225,19 @@ public:
     static SkScalar ComputeResScaleForStroking(const SkMatrix& matrix);
 };
 
+namespace SkOpts {
+    // 'm' holds the 9 values of an SkMatrix, in SkMatrix's row-major order.
+    extern void (*matrix_map_points_affine)(const SkScalar m[9], SkPoint dst[],
+                                            const SkPoint src[], int count);
+    extern void (*matrix_map_points_persp)(const SkScalar m[9], SkPoint dst[],
+                                           const SkPoint src[], int count);
+    extern void (*matrix_map_rects_affine)(const SkScalar m[9], SkRect dst[],
+                                           const SkRect src[], int count);
+    // Rects with a corner mapped to w < minW are written as NaN, to be mapped again with clipping.
+    extern void (*matrix_map_rects_persp)(const SkScalar m[9], float minW, SkRect dst[],
+                                          const SkRect src[], int count);
+
+    void Init_Matrix();
+}  // namespace SkOpts
+
 #endif
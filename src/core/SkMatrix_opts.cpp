@@ -0,0 +1,42 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/private/base/SkFeatures.h"
+#include "src/core/SkCpu.h"
+#include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOptsTargets.h"
+
+#define SK_OPTS_TARGET SK_OPTS_TARGET_DEFAULT
+#include "src/opts/SkOpts_SetTarget.h"
+
+#include "src/opts/SkMatrix_opts.h"  // IWYU pragma: keep
+
+#include "src/opts/SkOpts_RestoreTarget.h"
+
+namespace SkOpts {
+    DEFINE_DEFAULT(matrix_map_points_affine);
+    DEFINE_DEFAULT(matrix_map_points_persp);
+    DEFINE_DEFAULT(matrix_map_rects_affine);
+    DEFINE_DEFAULT(matrix_map_rects_persp);
+
+    void Init_Matrix_hsw();
+
+    static bool init() {
+    #if defined(SK_ENABLE_OPTIMIZE_SIZE)
+        // All Init_foo functions are omitted when optimizing for size
+    #elif defined(SK_CPU_X86)
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+            if (SkCpu::Supports(SkCpu::HSW)) { Init_Matrix_hsw(); }
+        #endif
+    #endif
+      return true;
+    }
+
+    void Init_Matrix() {
+        [[maybe_unused]] static bool gInitialized = init();
+    }
+}  // namespace SkOpts
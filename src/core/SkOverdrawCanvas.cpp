@@ -15,6 +15,7 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRSXform.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSurfaceProps.h"
@@ -262,6 +263,21 @@ void SkOverdrawCanvas::onDrawEdgeAAImageSet2(const ImageSetEntry set[], int coun
     }
 }
 
+void SkOverdrawCanvas::onDrawRRectSet(const SkRRect rrects[], const SkColor4f[], int count,
+                                      const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    const SkPaint overdrawPaint = this->overdrawPaint(paint);
+    for (int i = 0; i < count; ++i) {
+        if (preViewMatrices) {
+            fList[0]->save();
+            fList[0]->concat(preViewMatrices[i]);
+        }
+        fList[0]->onDrawRRect(rrects[i], overdrawPaint);
+        if (preViewMatrices) {
+            fList[0]->restore();
+        }
+    }
+}
+
 inline SkPaint SkOverdrawCanvas::overdrawPaint(const SkPaint& paint) {
     SkPaint newPaint = fPaint;
     newPaint.setStyle(paint.getStyle());
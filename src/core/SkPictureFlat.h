@@ -124,7 +124,9 @@ enum DrawType {
 
     DRAW_SLUG,
 
-    LAST_DRAWTYPE_ENUM = DRAW_SLUG,
+    DRAW_RRECT_SET,
+
+    LAST_DRAWTYPE_ENUM = DRAW_RRECT_SET,
 };
 
 enum DrawVertexFlags {
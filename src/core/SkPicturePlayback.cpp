@@ -421,6 +421,36 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             canvas->experimental_DrawEdgeAAImageSet(set.get(), cnt, dstClips, matrices.begin(),
                                                     sampling, paint, constraint);
         } break;
+        case DRAW_RRECT_SET: {
+            static const size_t kEntryReadSize = SkRRect::kSizeInMemory + sizeof(SkColor4f);
+            static const size_t kMatrixSize = 9 * sizeof(SkScalar); // != sizeof(SkMatrix)
+
+            const SkPaint& paint = fPictureData->requiredPaint(reader);
+            int cnt = reader->readInt();
+            if (!reader->validate(cnt >= 0) ||
+                !reader->validate(SkSafeMath::Mul(cnt, kEntryReadSize) <= reader->available())) {
+                break;
+            }
+            AutoTArray<SkRRect> rrects(cnt);
+            AutoTArray<SkColor4f> colors(cnt);
+            for (int i = 0; i < cnt && reader->isValid(); ++i) {
+                reader->readRRect(&rrects[i]);
+                reader->readColor4f(&colors[i]);
+            }
+            bool hasMatrices = reader->readInt();
+            if (hasMatrices &&
+                !reader->validate(SkSafeMath::Mul(cnt, kMatrixSize) <= reader->available())) {
+                break;
+            }
+            TArray<SkMatrix> matrices(hasMatrices ? cnt : 0);
+            for (int i = 0; hasMatrices && i < cnt && reader->isValid(); ++i) {
+                reader->readMatrix(&matrices.push_back());
+            }
+            BREAK_ON_READ_ERROR(reader);
+
+            canvas->experimental_DrawRRectSet(rrects.get(), colors.get(), cnt,
+                                              hasMatrices ? matrices.begin() : nullptr, paint);
+        } break;
         case DRAW_IMAGE: {
             const SkPaint* paint = fPictureData->optionalPaint(reader);
             const SkImage* image = fPictureData->getImage(reader);
@@ -824,6 +824,27 @@ void SkPictureRecord::onDrawEdgeAAImageSet2(const SkCanvas::ImageSetEntry set[],
     this->validate(initialOffset, size);
 }
 
+void SkPictureRecord::onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                                     const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    static constexpr size_t kMatrixSize = 9 * sizeof(SkScalar); // *not* sizeof(SkMatrix)
+    // op + paint index + count + (rrect, color) * cnt + hasMatrices(as int) + matrices
+    const int matrixCount = preViewMatrices ? count : 0;
+    size_t size = 4 * kUInt32Size + (SkRRect::kSizeInMemory + sizeof(SkColor4f)) * count +
+                  kMatrixSize * matrixCount;
+    size_t initialOffset = this->addDraw(DRAW_RRECT_SET, &size);
+    this->addPaint(paint);
+    this->addInt(count);
+    for (int i = 0; i < count; ++i) {
+        this->addRRect(rrects[i]);
+        fWriter.write(&colors[i], sizeof(SkColor4f));
+    }
+    this->addInt(preViewMatrices != nullptr);
+    for (int i = 0; i < matrixCount; ++i) {
+        this->addMatrix(preViewMatrices[i]);
+    }
+    this->validate(initialOffset, size);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // De-duping helper.
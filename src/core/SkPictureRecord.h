@@ -252,6 +252,8 @@ protected:
                           SkBlendMode) override;
     void onDrawEdgeAAImageSet2(const ImageSetEntry[], int count, const SkPoint[], const SkMatrix[],
                                const SkSamplingOptions&,const SkPaint*, SrcRectConstraint) override;
+    void onDrawRRectSet(const SkRRect[], const SkColor4f[], int count, const SkMatrix[],
+                        const SkPaint&) override;
 
     int addPathToHeap(const SkPath& path);  // does not write to ops stream
 
@@ -169,6 +169,8 @@ DRAW(DrawEdgeAAQuad, experimental_DrawEdgeAAQuad(
         r.rect, r.clip, r.aa, r.color, r.mode))
 DRAW(DrawEdgeAAImageSet, experimental_DrawEdgeAAImageSet(
         r.set.get(), r.count, r.dstClips, r.preViewMatrices, r.sampling, r.paint, r.constraint))
+DRAW(DrawRRectSet, experimental_DrawRRectSet(
+        r.rrects, r.colors, r.count, r.preViewMatrices, r.paint))
 
 #undef DRAW
 
@@ -524,6 +526,17 @@ private:
         }
         return rect;
     }
+    Bounds bounds(const DrawRRectSet& op) const {
+        SkRect rect = SkRect::MakeEmpty();
+        for (int i = 0; i < op.count; ++i) {
+            SkRect entryBounds = op.rrects[i].getBounds();
+            if (op.preViewMatrices) {
+                op.preViewMatrices[i].mapRect(&entryBounds);
+            }
+            rect.join(this->adjustAndMap(entryBounds, &op.paint));
+        }
+        return rect;
+    }
 
     // Returns true if rect was meaningfully adjusted for the effects of paint,
     // false if the paint could affect the rect in unknown ways.
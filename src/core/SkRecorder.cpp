@@ -336,6 +336,13 @@ void SkRecorder::onDrawEdgeAAImageSet2(const ImageSetEntry set[], int count,
             this->copy(preViewMatrices, totalMatrixCount), sampling, constraint);
 }
 
+void SkRecorder::onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                                const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    this->append<SkRecords::DrawRRectSet>(paint, this->copy(rrects, count),
+                                          this->copy(colors, count), count,
+                                          this->copy(preViewMatrices, count));
+}
+
 void SkRecorder::willSave() {
     this->append<SkRecords::Save>();
 }
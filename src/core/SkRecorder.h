@@ -155,6 +155,8 @@ public:
     void onDrawEdgeAAImageSet2(const ImageSetEntry[], int count, const SkPoint[], const SkMatrix[],
                                const SkSamplingOptions&, const SkPaint*,
                                SrcRectConstraint) override;
+    void onDrawRRectSet(const SkRRect[], const SkColor4f[], int count, const SkMatrix[],
+                        const SkPaint&) override;
 
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&, const SkSurfaceProps&) override;
 
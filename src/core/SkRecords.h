@@ -95,7 +95,8 @@ namespace SkRecords {
     M(DrawShadowRec)                                                \
     M(DrawAnnotation)                                               \
     M(DrawEdgeAAQuad)                                               \
-    M(DrawEdgeAAImageSet)
+    M(DrawEdgeAAImageSet)                                           \
+    M(DrawRRectSet)
 
 
 // Defines SkRecords::Type, an enum of all record types.
@@ -365,6 +366,12 @@ RECORD(DrawEdgeAAImageSet, kDraw_Tag|kHasImage_Tag|kHasPaint_Tag|kMultiDraw_Tag,
        PODArray<SkMatrix> preViewMatrices;
        SkSamplingOptions sampling;
        SkCanvas::SrcRectConstraint constraint)
+RECORD(DrawRRectSet, kDraw_Tag|kHasPaint_Tag|kMultiDraw_Tag,
+       SkPaint paint;
+       PODArray<SkRRect> rrects;
+       PODArray<SkColor4f> colors;
+       int count;
+       PODArray<SkMatrix> preViewMatrices)
 #undef RECORD
 
 }  // namespace SkRecords
@@ -10,16 +10,19 @@
 #include "include/private/base/SkMacros.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkMath.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkBuffer.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkRegionPriv.h"
 
 #include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <functional>
+#include <vector>
 
 using namespace skia_private;
 
@@ -654,16 +657,129 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the smallest of the n values, four at a time.
+static int32_t min_run_value(const SkRegionPriv::RunType values[], int n) {
+    skvx::int4 min4(SK_MaxS32);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        min4 = min(min4, skvx::int4::Load(values + i));
+    }
+    int32_t result = min(min4);
+    for (; i < n; ++i) {
+        result = std::min(result, values[i]);
+    }
+    return result;
+}
+
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    // Sweep from top to bottom, writing one band of identical scanlines at a time straight into
+    // the runs, rather than performing a full union for each rect.
+    TArray<SkIRect> sorted(count);
+    for (int i = 0; i < count; ++i) {
+        const SkIRect& r = rects[i];
+        // Skip the same rects that setRect() would make empty.
+        if (!r.isEmpty() &&
+            SkRegion_kRunTypeSentinel != r.right() && SkRegion_kRunTypeSentinel != r.bottom()) {
+            sorted.push_back(r);
+        }
+    }
+    if (sorted.empty()) {
+        return this->setEmpty();
+    }
+    if (sorted.size() == 1) {
+        return this->setRect(sorted[0]);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const SkIRect& a, const SkIRect& b) {
+        return a.fTop < b.fTop;
+    });
+
+    // The rects crossing the current band, sorted by their left edges.
+    std::vector<RunType> lefts, rites, bottoms;
+
+    RunArray runs;
+    int runCount = 0;
+    runs[runCount++] = sorted[0].fTop;
+    // Where the previous band's intervals start, and how many values they take.
+    int prevStart = 0;
+    int prevLen = -1;
+    // Appends a band from the previous bottom to 'bottom', whose intervals have already been
+    // written after space for its bottom and interval count. Like RgnOper, a band that matches
+    // the previous one just extends it, so the runs match those built by op().
+    auto addBand = [&](int bottom, int len) {
+        const int start = runCount + 2;
+        if (len == prevLen && !memcmp(&runs[prevStart], &runs[start], len * sizeof(RunType))) {
+            runs[prevStart - 2] = bottom;
+        } else {
+            runs[runCount] = bottom;
+            runs[runCount + 1] = len >> 1;
+            runs[start + len] = SkRegion_kRunTypeSentinel;
+            prevStart = start;
+            prevLen = len;
+            runCount = start + len + 1;
+        }
+    };
+
+    int y = sorted[0].fTop;
+    int next = 0;
+    while (next < sorted.size() || !lefts.empty()) {
+        if (lefts.empty() && sorted[next].fTop > y) {
+            // A gap between rects is an empty band.
+            runs.resizeToAtLeast(runCount + 3);
+            y = sorted[next].fTop;
+            addBand(y, 0);
+        }
+        for (; next < sorted.size() && sorted[next].fTop == y; ++next) {
+            const SkIRect& r = sorted[next];
+            auto index = std::upper_bound(lefts.begin(), lefts.end(), r.fLeft) - lefts.begin();
+            lefts.insert(lefts.begin() + index, r.fLeft);
+            rites.insert(rites.begin() + index, r.fRight);
+            bottoms.insert(bottoms.begin() + index, r.fBottom);
+        }
+
+        int bottom = min_run_value(bottoms.data(), SkToInt(bottoms.size()));
+        if (next < sorted.size()) {
+            bottom = std::min(bottom, sorted[next].fTop);
         }
+
+        // Merge the active rects' spans. Room for: bottom, interval count, every span, the
+        // x-sentinel, and the final y-sentinel.
+        runs.resizeToAtLeast(runCount + 2 + 2 * SkToInt(lefts.size()) + 2);
+        RunType* dst = &runs[runCount + 2];
+        int len = 0;
+        for (size_t i = 0; i < lefts.size(); ++i) {
+            if (len > 0 && lefts[i] <= dst[len - 1]) {
+                dst[len - 1] = std::max(dst[len - 1], rites[i]);
+            } else {
+                dst[len++] = lefts[i];
+                dst[len++] = rites[i];
+            }
+        }
+        addBand(bottom, len);
+        y = bottom;
+
+        // Drop the rects that end at this band.
+        size_t kept = 0;
+        for (size_t i = 0; i < lefts.size(); ++i) {
+            if (bottoms[i] > y) {
+                lefts[kept] = lefts[i];
+                rites[kept] = rites[i];
+                bottoms[kept] = bottoms[i];
+                kept++;
+            }
+        }
+        lefts.resize(kept);
+        rites.resize(kept);
+        bottoms.resize(kept);
     }
-    return !this->isEmpty();
+    runs[runCount++] = SkRegion_kRunTypeSentinel;
+
+    return this->setRuns(&runs[0], runCount);
+}
+
+bool SkRegion::op(const SkIRect rects[], int count, Op op) {
+    SkRegion operand;
+    operand.setRects(rects, count);
+    return this->op(*this, operand, op);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
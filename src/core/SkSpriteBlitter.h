@@ -33,6 +33,10 @@ public:
     void blitRect(int x, int y, int width, int height) override = 0;
 
     static SkSpriteBlitter* ChooseL32(const SkPixmap& source, const SkPaint&, SkArenaAlloc*);
+    // Handles the 565, A8, 8888, 1010102 and F16 color types, in any combination, under src,
+    // srcover and modulate, with the paint's alpha and an RGBA color matrix filter.
+    static SkSpriteBlitter* ChoosePlanes(const SkPixmap& dst, const SkPixmap& source,
+                                         const SkPaint&, SkArenaAlloc*);
 
 protected:
     SkPixmap        fDst;
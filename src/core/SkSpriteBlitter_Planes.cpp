@@ -0,0 +1,380 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkColorSpacePriv.h"
+#include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkSpriteBlitter.h"
+#include "src/effects/colorfilters/SkColorFilterBase.h"
+#include "src/effects/colorfilters/SkMatrixColorFilter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+// A sprite blitter for the color types that have no dedicated blitter. Each row is converted, a
+// stripe at a time, into planes of premultiplied floats; the paint's alpha and color filter are
+// applied, the dst is blended in, and the result is converted back. Loading and storing each
+// color type, and each blend mode, is one entry in a table, so any src/dst pair works without
+// building a raster pipeline.
+
+namespace {
+
+constexpr int N = 8;
+constexpr int kStripe = 16 * N;
+
+using F   = skvx::Vec<N, float>;
+using U8  = skvx::Vec<N, uint8_t>;
+using U16 = skvx::Vec<N, uint16_t>;
+using U32 = skvx::Vec<N, uint32_t>;
+
+struct Planes {
+    float r[kStripe], g[kStripe], b[kStripe], a[kStripe];
+
+    F R(int i) const { return F::Load(r + i); }
+    F G(int i) const { return F::Load(g + i); }
+    F B(int i) const { return F::Load(b + i); }
+    F A(int i) const { return F::Load(a + i); }
+    void set(int i, F R, F G, F B, F A) {
+        R.store(r + i);
+        G.store(g + i);
+        B.store(b + i);
+        A.store(a + i);
+    }
+};
+
+// Alpha-only pixels take their (unpremultiplied) r,g,b from 'color'.
+using LoadProc  = void (*)(const void* pixels, int n, const SkColor4f& color, Planes*);
+using StoreProc = void (*)(void* pixels, int n, const Planes&);
+
+// Calls fn(i, group) for each group of N pixels, padding the last group with zeros. Planes are
+// always written in whole groups, which is why kStripe is a multiple of N.
+template <typename P, typename Fn>
+void load_groups(const void* pixels, int n, Fn&& fn) {
+    const P* px = static_cast<const P*>(pixels);
+    int i = 0;
+    for (; i + N <= n; i += N) {
+        fn(i, px + i);
+    }
+    if (i < n) {
+        P tail[N] = {};
+        memcpy(tail, px + i, (n - i) * sizeof(P));
+        fn(i, tail);
+    }
+}
+
+template <typename P, typename Fn>
+void store_groups(void* pixels, int n, Fn&& fn) {
+    P* px = static_cast<P*>(pixels);
+    int i = 0;
+    for (; i + N <= n; i += N) {
+        fn(i, px + i);
+    }
+    if (i < n) {
+        P tail[N];
+        fn(i, tail);
+        memcpy(px + i, tail, (n - i) * sizeof(P));
+    }
+}
+
+F from_unorm(const U32& v, float scale) { return skvx::cast<float>(v) * (1 / scale); }
+
+U32 to_unorm(const F& v, float scale) {
+    return skvx::cast<uint32_t>(max(min(v, 1.0f), 0.0f) * scale + 0.5f);
+}
+
+void load_a8(const void* pixels, int n, const SkColor4f& color, Planes* p) {
+    load_groups<uint8_t>(pixels, n, [&](int i, const uint8_t* px) {
+        const F a = from_unorm(skvx::cast<uint32_t>(U8::Load(px)), 255);
+        p->set(i, color.fR * a, color.fG * a, color.fB * a, a);
+    });
+}
+
+void store_a8(void* pixels, int n, const Planes& p) {
+    store_groups<uint8_t>(pixels, n, [&](int i, uint8_t* px) {
+        skvx::cast<uint8_t>(to_unorm(p.A(i), 255)).store(px);
+    });
+}
+
+void load_565(const void* pixels, int n, const SkColor4f&, Planes* p) {
+    load_groups<uint16_t>(pixels, n, [&](int i, const uint16_t* px) {
+        const U32 v = skvx::cast<uint32_t>(U16::Load(px));
+        p->set(i, from_unorm(v >> 11, 31), from_unorm((v >> 5) & 63, 63), from_unorm(v & 31, 31),
+               1.0f);
+    });
+}
+
+void store_565(void* pixels, int n, const Planes& p) {
+    store_groups<uint16_t>(pixels, n, [&](int i, uint16_t* px) {
+        skvx::cast<uint16_t>(to_unorm(p.R(i), 31) << 11 |
+                             to_unorm(p.G(i), 63) <<  5 |
+                             to_unorm(p.B(i), 31)).store(px);
+    });
+}
+
+template <bool kSwapRB>
+void load_8888(const void* pixels, int n, const SkColor4f&, Planes* p) {
+    load_groups<uint32_t>(pixels, n, [&](int i, const uint32_t* px) {
+        const U32 v = U32::Load(px);
+        const F x = from_unorm(v & 0xff, 255),
+                z = from_unorm((v >> 16) & 0xff, 255);
+        p->set(i, kSwapRB ? z : x, from_unorm((v >> 8) & 0xff, 255), kSwapRB ? x : z,
+               from_unorm(v >> 24, 255));
+    });
+}
+
+template <bool kSwapRB>
+void store_8888(void* pixels, int n, const Planes& p) {
+    store_groups<uint32_t>(pixels, n, [&](int i, uint32_t* px) {
+        const U32 x = to_unorm(kSwapRB ? p.B(i) : p.R(i), 255),
+                  z = to_unorm(kSwapRB ? p.R(i) : p.B(i), 255);
+        (x | to_unorm(p.G(i), 255) << 8 | z << 16 | to_unorm(p.A(i), 255) << 24).store(px);
+    });
+}
+
+template <bool kSwapRB>
+void load_1010102(const void* pixels, int n, const SkColor4f&, Planes* p) {
+    load_groups<uint32_t>(pixels, n, [&](int i, const uint32_t* px) {
+        const U32 v = U32::Load(px);
+        const F x = from_unorm(v & 0x3ff, 1023),
+                z = from_unorm((v >> 20) & 0x3ff, 1023);
+        p->set(i, kSwapRB ? z : x, from_unorm((v >> 10) & 0x3ff, 1023), kSwapRB ? x : z,
+               from_unorm(v >> 30, 3));
+    });
+}
+
+template <bool kSwapRB>
+void store_1010102(void* pixels, int n, const Planes& p) {
+    store_groups<uint32_t>(pixels, n, [&](int i, uint32_t* px) {
+        const U32 x = to_unorm(kSwapRB ? p.B(i) : p.R(i), 1023),
+                  z = to_unorm(kSwapRB ? p.R(i) : p.B(i), 1023);
+        (x | to_unorm(p.G(i), 1023) << 10 | z << 20 | to_unorm(p.A(i), 3) << 30).store(px);
+    });
+}
+
+void load_f16(const void* pixels, int n, const SkColor4f&, Planes* p) {
+    load_groups<uint64_t>(pixels, n, [&](int i, const uint64_t* px) {
+        U16 r, g, b, a;
+        skvx::strided_load4(reinterpret_cast<const uint16_t*>(px), r, g, b, a);
+        p->set(i, skvx::from_half(r), skvx::from_half(g), skvx::from_half(b),
+               skvx::from_half(a));
+    });
+}
+
+void store_f16(void* pixels, int n, const Planes& p) {
+    store_groups<uint64_t>(pixels, n, [&](int i, uint64_t* px) {
+        const U16 r = skvx::to_half(p.R(i)),
+                  g = skvx::to_half(p.G(i)),
+                  b = skvx::to_half(p.B(i)),
+                  a = skvx::to_half(p.A(i));
+        uint16_t* halves = reinterpret_cast<uint16_t*>(px);
+        for (int j = 0; j < N; ++j) {
+            halves[4*j + 0] = r[j];
+            halves[4*j + 1] = g[j];
+            halves[4*j + 2] = b[j];
+            halves[4*j + 3] = a[j];
+        }
+    });
+}
+
+struct ColorTypeProcs {
+    SkColorType fColorType;
+    LoadProc    fLoad;
+    StoreProc   fStore;
+};
+
+constexpr ColorTypeProcs kColorTypeProcs[] = {
+    {kAlpha_8_SkColorType,       load_a8,             store_a8            },
+    {kRGB_565_SkColorType,       load_565,            store_565           },
+    {kRGBA_8888_SkColorType,     load_8888<false>,    store_8888<false>   },
+    {kBGRA_8888_SkColorType,     load_8888<true>,     store_8888<true>    },
+    {kRGBA_1010102_SkColorType,  load_1010102<false>, store_1010102<false>},
+    {kBGRA_1010102_SkColorType,  load_1010102<true>,  store_1010102<true> },
+    {kRGBA_F16_SkColorType,      load_f16,            store_f16           },
+};
+
+const ColorTypeProcs* find_procs(SkColorType ct) {
+    for (const ColorTypeProcs& procs : kColorTypeProcs) {
+        if (procs.fColorType == ct) {
+            return &procs;
+        }
+    }
+    return nullptr;
+}
+
+// Blends the dst into the src planes, leaving the result in 'src'.
+using BlendProc = void (*)(Planes* src, const Planes& dst, int n);
+
+void blend_srcover(Planes* s, const Planes& d, int n) {
+    for (int i = 0; i < n; i += N) {
+        const F invA = 1.0f - s->A(i);
+        s->set(i, s->R(i) + d.R(i) * invA,
+                  s->G(i) + d.G(i) * invA,
+                  s->B(i) + d.B(i) * invA,
+                  s->A(i) + d.A(i) * invA);
+    }
+}
+
+void blend_modulate(Planes* s, const Planes& d, int n) {
+    for (int i = 0; i < n; i += N) {
+        s->set(i, s->R(i) * d.R(i), s->G(i) * d.G(i), s->B(i) * d.B(i), s->A(i) * d.A(i));
+    }
+}
+
+class Sprite_Planes final : public SkSpriteBlitter {
+public:
+    Sprite_Planes(const SkPixmap& src, const ColorTypeProcs& srcProcs,
+                  const ColorTypeProcs& dstProcs, BlendProc blend, const SkPaint& paint,
+                  const float* colorMatrix)
+            : INHERITED(src)
+            , fLoadSrc(srcProcs.fLoad)
+            , fLoadDst(dstProcs.fLoad)
+            , fStoreDst(dstProcs.fStore)
+            , fBlend(blend)
+            , fColor(paint.getColor4f())
+            , fHasColorMatrix(colorMatrix != nullptr) {
+        if (colorMatrix) {
+            memcpy(fColorMatrix, colorMatrix, sizeof(fColorMatrix));
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        SkASSERT(width > 0 && height > 0);
+        const size_t srcBpp = fSource.info().bytesPerPixel(),
+                     dstBpp = fDst.info().bytesPerPixel();
+        Planes src, dst;
+
+        for (; height > 0; --height, ++y) {
+            const char* srcRow = static_cast<const char*>(fSource.addr(x - fLeft, y - fTop));
+            char* dstRow = static_cast<char*>(fDst.writable_addr(x, y));
+
+            for (int done = 0; done < width; done += kStripe) {
+                const int n = std::min(kStripe, width - done);
+                fLoadSrc(srcRow + done * srcBpp, n, fColor, &src);
+                this->filter(&src, n);
+                if (fBlend) {
+                    fLoadDst(dstRow + done * dstBpp, n, SkColors::kTransparent, &dst);
+                    fBlend(&src, dst, n);
+                }
+                fStoreDst(dstRow + done * dstBpp, n, src);
+            }
+        }
+    }
+
+private:
+    // Scales by the paint's alpha, then applies the color filter, just as the raster pipeline
+    // sprite blitter does.
+    void filter(Planes* p, int n) const {
+        if (fColor.fA == 1.0f && !fHasColorMatrix) {
+            return;
+        }
+        const float* m = fColorMatrix;
+        for (int i = 0; i < n; i += N) {
+            F r = p->R(i) * fColor.fA,
+              g = p->G(i) * fColor.fA,
+              b = p->B(i) * fColor.fA,
+              a = p->A(i) * fColor.fA;
+            if (fHasColorMatrix) {
+                const F invA = skvx::if_then_else(a == 0, F(0), 1 / a);
+                r *= invA;
+                g *= invA;
+                b *= invA;
+                const F R = r*m[ 0] + g*m[ 1] + b*m[ 2] + a*m[ 3] + m[ 4],
+                        G = r*m[ 5] + g*m[ 6] + b*m[ 7] + a*m[ 8] + m[ 9],
+                        B = r*m[10] + g*m[11] + b*m[12] + a*m[13] + m[14],
+                        A = r*m[15] + g*m[16] + b*m[17] + a*m[18] + m[19];
+                a = max(min(A, 1.0f), 0.0f);
+                r = max(min(R, 1.0f), 0.0f) * a;
+                g = max(min(G, 1.0f), 0.0f) * a;
+                b = max(min(B, 1.0f), 0.0f) * a;
+            }
+            p->set(i, r, g, b, a);
+        }
+    }
+
+    LoadProc  fLoadSrc;
+    LoadProc  fLoadDst;
+    StoreProc fStoreDst;
+    BlendProc fBlend;  // null for kSrc, which doesn't read the dst
+    SkColor4f fColor;
+    bool      fHasColorMatrix;
+    float     fColorMatrix[20];
+
+    using INHERITED = SkSpriteBlitter;
+};
+
+}  // namespace
+
+SkSpriteBlitter* SkSpriteBlitter::ChoosePlanes(const SkPixmap& dst, const SkPixmap& source,
+                                               const SkPaint& paint, SkArenaAlloc* allocator) {
+    SkASSERT(allocator != nullptr);
+
+    const ColorTypeProcs* srcProcs = find_procs(source.colorType());
+    const ColorTypeProcs* dstProcs = find_procs(dst.colorType());
+    if (!srcProcs || !dstProcs) {
+        return nullptr;
+    }
+    if (dst.alphaType() == kUnpremul_SkAlphaType || source.alphaType() == kUnpremul_SkAlphaType) {
+        return nullptr;
+    }
+    // Dithering needs the pixel's position, so leave it to the raster pipeline.
+    if (paint.getMaskFilter() || paint.isDither()) {
+        return nullptr;
+    }
+    // The color of alpha-only images comes from the sRGB paint color.
+    if (SkColorTypeIsAlphaOnly(source.colorType()) && dst.colorSpace() &&
+        !SkColorSpace::Equals(dst.colorSpace(), sk_srgb_singleton())) {
+        return nullptr;
+    }
+
+    // Only RGBA color matrices can be folded in; anything else needs the raster pipeline.
+    float colorMatrix[20];
+    bool hasColorMatrix = false;
+    if (SkColorFilter* cf = paint.getColorFilter()) {
+        if (as_CFB(cf)->type() != SkColorFilterBase::Type::kMatrix ||
+            static_cast<SkMatrixColorFilter*>(cf)->domain() !=
+                    SkMatrixColorFilter::Domain::kRGBA ||
+            !cf->asAColorMatrix(colorMatrix)) {
+            return nullptr;
+        }
+        hasColorMatrix = true;
+    }
+
+    BlendProc blend;
+    switch (paint.asBlendMode().value_or(SkBlendMode::kClear)) {
+        case SkBlendMode::kSrc:
+            blend = nullptr;
+            break;
+        case SkBlendMode::kSrcOver: {
+            // An opaque src covers the dst, so srcover is just src.
+            const bool opaque = source.isOpaque() && paint.getAlphaf() == 1.0f &&
+                                (!hasColorMatrix || paint.getColorFilter()->isAlphaUnchanged());
+            blend = opaque ? nullptr : blend_srcover;
+            break;
+        }
+        case SkBlendMode::kModulate:
+            blend = blend_modulate;
+            break;
+        default:
+            return nullptr;
+    }
+
+    return allocator->make<Sprite_Planes>(source, *srcProcs, *dstProcs, blend, paint,
+                                          hasColorMatrix ? colorMatrix : nullptr);
+}
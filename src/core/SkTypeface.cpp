@@ -22,6 +22,7 @@
 #include "src/base/SkEndian.h"
 #include "src/base/SkNoDestructor.h"
 #include "src/base/SkUTF.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkFontDescriptor.h"
@@ -47,6 +48,7 @@
 #include "src/ports/SkTypeface_fontations_priv.h"
 #endif
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <vector>
@@ -378,16 +380,45 @@ public:
                 uni = fStorage.reset(byteLength);
                 const char* ptr = (const char*)text;
                 const char* end = ptr + byteLength;
-                for (int i = 0; ptr < end; ++i) {
-                    fStorage[i] = SkUTF::NextUTF8(&ptr, end);
+                for (int i = 0; ptr < end;) {
+                    // ASCII is widened 16 characters at a time...
+                    if (end - ptr >= 16) {
+                        const auto bytes = skvx::byte16::Load(ptr);
+                        if (!any(bytes >= 0x80)) {
+                            skvx::cast<SkUnichar>(bytes).store(fStorage.get() + i);
+                            ptr += 16;
+                            i += 16;
+                            continue;
+                        }
+                    }
+                    // ...and anything else decoded one character at a time, up to the next block.
+                    const char* stop = std::min(ptr + 16, end);
+                    while (ptr < stop) {
+                        fStorage[i++] = SkUTF::NextUTF8(&ptr, end);
+                    }
                 }
             } break;
             case SkTextEncoding::kUTF16: {
                 uni = fStorage.reset(byteLength);
                 const uint16_t* ptr = (const uint16_t*)text;
                 const uint16_t* end = ptr + (byteLength >> 1);
-                for (int i = 0; ptr < end; ++i) {
-                    fStorage[i] = SkUTF::NextUTF16(&ptr, end);
+                for (int i = 0; ptr < end;) {
+                    // Runs without surrogates (Latin and the rest of the BMP) are widened 8 at a
+                    // time...
+                    if (end - ptr >= 8) {
+                        const auto units = skvx::Vec<8, uint16_t>::Load(ptr);
+                        if (!any((units & 0xF800) == 0xD800)) {
+                            skvx::cast<SkUnichar>(units).store(fStorage.get() + i);
+                            ptr += 8;
+                            i += 8;
+                            continue;
+                        }
+                    }
+                    // ...and surrogate pairs decoded one character at a time.
+                    const uint16_t* stop = std::min(ptr + 8, end);
+                    while (ptr < stop) {
+                        fStorage[i++] = SkUTF::NextUTF16(&ptr, end);
+                    }
                 }
             } break;
             case SkTextEncoding::kUTF32:
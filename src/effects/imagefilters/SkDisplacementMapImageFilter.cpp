@@ -7,9 +7,12 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkRect.h"
@@ -21,12 +24,17 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 #include <utility>
 
@@ -137,6 +145,116 @@ sk_sp<SkShader> make_displacement_shader(
     return builder.makeShader();
 }
 
+int channel_shift(SkColorChannel channel) {
+    switch (channel) {
+        case SkColorChannel::kR: return SK_R32_SHIFT;
+        case SkColorChannel::kG: return SK_G32_SHIFT;
+        case SkColorChannel::kB: return SK_B32_SHIFT;
+        case SkColorChannel::kA: return SK_A32_SHIFT;
+    }
+    SkUNREACHABLE;
+}
+
+// Matches the displacement shader with nearest sampling on the raster backend. The destination is
+// processed in square tiles, sized so that the color pixels a tile can be displaced from
+// (the tile outset by the maximum displacement) stay within a typical L2 cache, since large
+// displacements otherwise jump across far apart rows of the color image from pixel to pixel.
+sk_sp<SkSpecialImage> cpu_displacement(const skif::Context& ctx,
+                                       const sk_sp<SkSpecialImage>& displacement,
+                                       const SkIRect& displacementBounds,
+                                       const sk_sp<SkSpecialImage>& color,
+                                       const SkIRect& colorBounds,
+                                       const SkIRect& dstBounds,
+                                       skif::LayerSpace<skif::Vector> scale,
+                                       SkColorChannel xChannel,
+                                       SkColorChannel yChannel) {
+    using F8 = skvx::float8;
+    using I8 = skvx::int8;
+    using U8 = skvx::Vec<8, uint32_t>;
+
+    SkBitmap displacementBM, colorBM;
+    if (!SkSpecialImages::AsBitmap(displacement.get(), &displacementBM) ||
+        !SkSpecialImages::AsBitmap(color.get(), &colorBM) ||
+        displacementBM.colorType() != kN32_SkColorType ||
+        colorBM.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+    SkASSERT(displacement->width() == displacementBounds.width() &&
+             displacement->height() == displacementBounds.height());
+    SkASSERT(color->width() == colorBounds.width() && color->height() == colorBounds.height());
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(colorBM.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return nullptr;
+    }
+
+    static constexpr int kCacheBudget = 256 * 1024;
+    static constexpr int kMinTileSize = 16;
+    const int footprint = static_cast<int>(std::sqrt(kCacheBudget / sizeof(uint32_t)));
+    const int maxDisplacement = SkScalarCeilToInt(std::max(std::abs(scale.x()),
+                                                           std::abs(scale.y())));
+    const int tileSize = std::max(kMinTileSize, footprint - maxDisplacement);
+
+    const int xShift = channel_shift(xChannel),
+              yShift = channel_shift(yChannel);
+    const F8 lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+
+    for (int tileY = dstBounds.fTop; tileY < dstBounds.fBottom; tileY += tileSize) {
+        const int tileBottom = std::min(tileY + tileSize, dstBounds.fBottom);
+        for (int tileX = dstBounds.fLeft; tileX < dstBounds.fRight; tileX += tileSize) {
+            const int tileRight = std::min(tileX + tileSize, dstBounds.fRight);
+            for (int y = tileY; y < tileBottom; ++y) {
+                uint32_t* out = dst.getAddr32(0, y - dstBounds.fTop);
+                const bool displacementRow = y >= displacementBounds.fTop &&
+                                             y < displacementBounds.fBottom;
+                for (int x = tileX; x < tileRight; x += 8) {
+                    const int n = std::min(8, tileRight - x);
+
+                    // Displacement outside of its image is transparent black
+                    U8 d = 0;
+                    if (displacementRow) {
+                        for (int i = 0; i < n; ++i) {
+                            if (x + i >= displacementBounds.fLeft &&
+                                x + i < displacementBounds.fRight) {
+                                d[i] = *displacementBM.getAddr32(x + i - displacementBounds.fLeft,
+                                                                 y - displacementBounds.fTop);
+                            }
+                        }
+                    }
+
+                    // The selected channels of the unpremul displacement color
+                    const F8 a = skvx::cast<float>((d >> SK_A32_SHIFT) & 0xFF);
+                    const F8 invA = if_then_else(a > 0.f, 1.f / a, F8(0.f));
+                    auto channel = [&](int shift) {
+                        if (shift == SK_A32_SHIFT) {
+                            return a * (1 / 255.f);
+                        }
+                        return min(skvx::cast<float>((d >> shift) & 0xFF) * invA, 1.f);
+                    };
+                    const F8 dx = scale.x() * (channel(xShift) - 0.5f),
+                             dy = scale.y() * (channel(yShift) - 0.5f);
+
+                    // Nearest sampling of the color image at the displaced pixel center
+                    const I8 sx = skvx::cast<int32_t>(floor(lanes + (x + 0.5f) + dx)),
+                             sy = skvx::cast<int32_t>(floor(y + 0.5f + dy));
+                    const I8 inside = (sx >= colorBounds.fLeft) & (sx < colorBounds.fRight) &
+                                      (sy >= colorBounds.fTop) & (sy < colorBounds.fBottom);
+                    for (int i = 0; i < n; ++i) {
+                        out[x - dstBounds.fLeft + i] =
+                                inside[i] ? *colorBM.getAddr32(sx[i] - colorBounds.fLeft,
+                                                               sy[i] - colorBounds.fTop)
+                                          : 0;
+                    }
+                }
+            }
+        }
+    }
+
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                           dst,
+                                           ctx.backend()->surfaceProps());
+}
+
 }  // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -243,6 +361,32 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
     // image. We need to evaluate each pixel within 'outputBounds'.
     using ShaderFlags = skif::FilterResult::ShaderFlags;
 
+    if (!ctx.backend()->getBlurEngine()) {
+        auto [resolvedDisplacement, displacementOrigin] = displacementOutput.imageAndOffset(
+                ctx.withNewDesiredOutput(outputBounds).withNewColorSpace(/*cs=*/nullptr));
+        auto [resolvedColor, colorOrigin] =
+                colorOutput.imageAndOffset(ctx.withNewDesiredOutput(requiredColorInput));
+        if (resolvedDisplacement && resolvedColor) {
+            SkIRect displacementBounds = SkIRect::MakeXYWH(displacementOrigin.x(),
+                                                           displacementOrigin.y(),
+                                                           resolvedDisplacement->width(),
+                                                           resolvedDisplacement->height());
+            SkIRect colorBounds = SkIRect::MakeXYWH(colorOrigin.x(),
+                                                    colorOrigin.y(),
+                                                    resolvedColor->width(),
+                                                    resolvedColor->height());
+            if (sk_sp<SkSpecialImage> result = cpu_displacement(ctx,
+                                                                resolvedDisplacement,
+                                                                displacementBounds,
+                                                                resolvedColor,
+                                                                colorBounds,
+                                                                SkIRect(outputBounds),
+                                                                scale, fXChannel, fYChannel)) {
+                return skif::FilterResult{std::move(result), outputBounds.topLeft()};
+            }
+        }
+    }
+
     skif::FilterResult::Builder builder{ctx};
     builder.add(displacementOutput, /*sampleBounds=*/outputBounds);
     builder.add(colorOutput,
@@ -7,10 +7,15 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkRect.h"
@@ -19,19 +24,32 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 #include <utility>
 
+class SkDiscardableMemory;
+
 struct SkISize;
 
 namespace {
@@ -216,6 +234,38 @@ sk_sp<SkShader> make_normal_shader(sk_sp<SkShader> alphaMap,
     return builder.makeShader();
 }
 
+// Pre-normalize the light direction, but this can be (0,0,0) for point lights, which won't use
+// it anyways. Avoid a division by 0 to keep ASAN happy or in the event that a spot/dir light has
+// bad user input.
+SkV3 normalized_light_direction(skif::LayerSpace<skif::Vector> directionXY,
+                                skif::LayerSpace<ZValue> directionZ) {
+    SkV3 dir{directionXY.x(), directionXY.y(), directionZ.val()};
+    float invDirLen = dir.length();
+    invDirLen = invDirLen ? 1.0f / invDirLen : 0.f;
+    return invDirLen * dir;
+}
+
+// Historically, the Skia lighting image filter did not apply any color space transformation to
+// the light's color. The SVG spec for the lighting effects does not stipulate how to interpret
+// the color for a light. Overall, it does not have a principled physically based approach, but
+// the closest way to interpret it, is:
+//  - the material's K is a uniformly distributed reflectance coefficient
+//  - lighting *should* be calculated in a linear color space, which is the default for SVG
+//    filters. Chromium manages these color transformations using SkImageFilters::ColorFilter
+//    so it's not necessarily reflected in the Context's color space.
+//  - it's unspecified in the SVG spec if the light color should be transformed to linear or
+//    interpreted as linear already. Regardless, if there was any transformation that needed to
+//    occur, Blink took care of it in the past so adding color space management to the light
+//    color would be a breaking change.
+//  - so for now, leave the color un-modified and apply K up front since no color space
+//    transforms need to be performed on the original light color.
+SkV3 scaled_light_color(SkColor lightColor, float k) {
+    const float colorScale = k / 255.f;
+    return SkV3{SkColorGetR(lightColor) * colorScale,
+                SkColorGetG(lightColor) * colorScale,
+                SkColorGetB(lightColor) * colorScale};
+}
+
 sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
                                      Light::Type lightType,
                                      SkColor lightColor,
@@ -245,37 +295,335 @@ sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
     builder.uniform("lightPosAndSpotFalloff") =
             SkV4{locationXY.x(), locationXY.y(), locationZ.val(), falloffExponent};
 
-    // Pre-normalize the light direction, but this can be (0,0,0) for point lights, which won't use
-    // the uniform anyways. Avoid a division by 0 to keep ASAN happy or in the event that a spot/dir
-    // light have bad user input.
-    SkV3 dir{directionXY.x(), directionXY.y(), directionZ.val()};
-    float invDirLen = dir.length();
-    invDirLen = invDirLen ? 1.0f / invDirLen : 0.f;
-    builder.uniform("lightDirAndSpotCutoff") =
-            SkV4{invDirLen*dir.x, invDirLen*dir.y, invDirLen*dir.z, cosCutoffAngle};
-
-    // Historically, the Skia lighting image filter did not apply any color space transformation to
-    // the light's color. The SVG spec for the lighting effects does not stipulate how to interpret
-    // the color for a light. Overall, it does not have a principled physically based approach, but
-    // the closest way to interpret it, is:
-    //  - the material's K is a uniformly distributed reflectance coefficient
-    //  - lighting *should* be calculated in a linear color space, which is the default for SVG
-    //    filters. Chromium manages these color transformations using SkImageFilters::ColorFilter
-    //    so it's not necessarily reflected in the Context's color space.
-    //  - it's unspecified in the SVG spec if the light color should be transformed to linear or
-    //    interpreted as linear already. Regardless, if there was any transformation that needed to
-    //    occur, Blink took care of it in the past so adding color space management to the light
-    //    color would be a breaking change.
-    //  - so for now, leave the color un-modified and apply K up front since no color space
-    //    transforms need to be performed on the original light color.
-    const float colorScale = k / 255.f;
-    builder.uniform("lightColor") = SkV3{SkColorGetR(lightColor) * colorScale,
-                                         SkColorGetG(lightColor) * colorScale,
-                                         SkColorGetB(lightColor) * colorScale};
+    const SkV3 dir = normalized_light_direction(directionXY, directionZ);
+    builder.uniform("lightDirAndSpotCutoff") = SkV4{dir.x, dir.y, dir.z, cosCutoffAngle};
+
+    builder.uniform("lightColor") = scaled_light_color(lightColor, k);
 
     return builder.makeShader();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// The raster backend evaluates the normal and lighting shaders directly, on 8 pixels at a time.
+
+using F8 = skvx::float8;
+
+// Must match kConeAAThreshold in the lighting shader
+static constexpr float kConeAAThreshold = 0.016f;
+static constexpr float kConeScale = 1.f / kConeAAThreshold;
+
+// Evaluates pow(x, exponent) for x in [0, 1] by linear interpolation into a table, since the
+// exponent is fixed for the whole image. Exponents below 1 have an unbounded slope at 0, which a
+// table would represent poorly, so those are computed directly.
+class PowTable {
+public:
+    explicit PowTable(float exponent)
+            : fExponent(exponent)
+            , fMode(exponent == 1.f ? Mode::kIdentity
+                                    : exponent > 1.f ? Mode::kTable : Mode::kDirect) {
+        if (fMode == Mode::kTable) {
+            for (int i = 0; i <= kSize; ++i) {
+                fTable[i] = std::pow(i / (float) kSize, exponent);
+            }
+        }
+    }
+
+    F8 eval(F8 x) const {
+        x = pin(x, F8(0.f), F8(1.f));
+        F8 result = x;
+        if (fMode == Mode::kTable) {
+            const F8 scaled = x * kSize;
+            const skvx::int8 index = skvx::cast<int32_t>(min(scaled, F8(kSize - 1)));
+            const F8 t = scaled - skvx::cast<float>(index);
+            for (int i = 0; i < 8; ++i) {
+                const float lo = fTable[index[i]], hi = fTable[index[i] + 1];
+                result[i] = lo + t[i] * (hi - lo);
+            }
+        } else if (fMode == Mode::kDirect) {
+            for (int i = 0; i < 8; ++i) {
+                result[i] = std::pow(x[i], fExponent);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr int kSize = 1024;
+    enum class Mode { kIdentity, kTable, kDirect };
+
+    float fExponent;
+    Mode fMode;
+    std::array<float, kSize + 1> fTable;
+};
+
+// The layer-space equivalent of the lighting shader's uniforms
+struct CpuLight {
+    Light::Type fType;
+    SkV3 fColor;     // The material's K has already been multiplied in
+    SkV3 fLocation;  // Spot and point lights only
+    SkV3 fDirection; // Normalized, spot and distant lights only
+    float fCosCutoffAngle;
+    PowTable fSpotFalloff;
+
+    Material::Type fMaterialType;
+    PowTable fShininess;
+};
+
+// The normal map is stored as four planes of floats: the X, Y and Z components of the surface
+// normal and the surface height (alpha scaled by the surface depth). Rows are padded to a multiple
+// of 8 floats so that every row can be processed with full vectors.
+static constexpr int kNormalPlanes = 4;
+
+int normal_map_stride(const SkIRect& bounds) { return SkAlign8(bounds.width()); }
+
+// Matches the normal shader: a Sobel filter over the input's alpha, where the sampled coordinates
+// are clamped to 'clampRect' and anything outside of 'srcBounds' is transparent.
+void compute_normals(const SkPixmap& src, const SkIRect& srcBounds, const SkIRect& clampRect,
+                     const SkIRect& bounds, float surfaceDepth, float* normals) {
+    const int w = bounds.width(),
+              h = bounds.height(),
+              stride = normal_map_stride(bounds);
+
+    // The alpha of the input around 'bounds', with a pixel of padding on every side.
+    const int alphaStride = stride + 2;
+    skia_private::AutoTMalloc<float> alpha(alphaStride * (h + 2));
+    for (int y = 0; y < h + 2; ++y) {
+        const int sy = SkTPin(bounds.fTop - 1 + y, clampRect.fTop, clampRect.fBottom - 1);
+        float* row = alpha.get() + y * alphaStride;
+        for (int x = 0; x < alphaStride; ++x) {
+            const int sx = SkTPin(bounds.fLeft - 1 + x, clampRect.fLeft, clampRect.fRight - 1);
+            row[x] = srcBounds.contains(sx, sy)
+                    ? SkGetPackedA32(*src.addr32(sx - srcBounds.fLeft, sy - srcBounds.fTop)) / 255.f
+                    : 0.f;
+        }
+    }
+
+    const float negSurfaceDepth = -surfaceDepth;
+    float* nx = normals;
+    float* ny = nx + stride * h;
+    float* nz = ny + stride * h;
+    float* height = nz + stride * h;
+    for (int y = 0; y < h; ++y) {
+        const float* r0 = alpha.get() + y * alphaStride;
+        const float* r1 = r0 + alphaStride;
+        const float* r2 = r1 + alphaStride;
+        for (int x = 0; x < w; x += 8) {
+            // The right column (or bottom row) terms of the Sobel filter; the left (or top) terms
+            // are their negative and the middle column (or row) is all zeros.
+            auto column = [&](int dx) {
+                return F8::Load(r0 + x + dx) + 2 * F8::Load(r1 + x + dx) + F8::Load(r2 + x + dx);
+            };
+            auto row = [&](const float* r) {
+                return F8::Load(r + x) + 2 * F8::Load(r + x + 1) + F8::Load(r + x + 2);
+            };
+            const F8 sobelX = negSurfaceDepth * 0.25f * (column(2) - column(0)),
+                     sobelY = negSurfaceDepth * 0.25f * (row(r2) - row(r0));
+            const F8 invLength = 1.f / sqrt(sobelX * sobelX + sobelY * sobelY + 1.f);
+
+            const int i = y * stride + x;
+            (sobelX * invLength).store(nx + i);
+            (sobelY * invLength).store(ny + i);
+            invLength.store(nz + i);
+            (surfaceDepth * F8::Load(r1 + x + 1)).store(height + i);
+        }
+    }
+}
+
+// Matches the lighting shader, writing premul N32 pixels for 'bounds' into 'dst'.
+void compute_lighting(const float* normals, const SkIRect& bounds, const CpuLight& light,
+                      const SkPixmap& dst) {
+    const int w = bounds.width(),
+              h = bounds.height(),
+              stride = normal_map_stride(bounds);
+    const float* nxPlane = normals;
+    const float* nyPlane = nxPlane + stride * h;
+    const float* nzPlane = nyPlane + stride * h;
+    const float* heightPlane = nzPlane + stride * h;
+
+    auto normalize = [](F8& x, F8& y, F8& z) {
+        const F8 length = sqrt(x * x + y * y + z * z);
+        const F8 invLength = if_then_else(length > 0.f, 1.f / length, F8(0.f));
+        x *= invLength;
+        y *= invLength;
+        z *= invLength;
+    };
+
+    const F8 lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+    for (int y = 0; y < h; ++y) {
+        uint32_t* out = dst.writable_addr32(0, y);
+        for (int x = 0; x < w; x += 8) {
+            const int i = y * stride + x;
+            const F8 nx = F8::Load(nxPlane + i),
+                     ny = F8::Load(nyPlane + i),
+                     nz = F8::Load(nzPlane + i);
+
+            // Surface to light
+            F8 lx, ly, lz;
+            if (light.fType == Light::Type::kDistant) {
+                lx = light.fDirection.x;
+                ly = light.fDirection.y;
+                lz = light.fDirection.z;
+            } else {
+                lx = light.fLocation.x - (lanes + (bounds.fLeft + x + 0.5f));
+                ly = light.fLocation.y - (bounds.fTop + y + 0.5f);
+                lz = light.fLocation.z - F8::Load(heightPlane + i);
+                normalize(lx, ly, lz);
+            }
+
+            // Spotlights fade based on the angle away from their direction
+            F8 scale = 1.f;
+            if (light.fType == Light::Type::kSpot) {
+                const F8 cosAngle = -(lx * light.fDirection.x +
+                                      ly * light.fDirection.y +
+                                      lz * light.fDirection.z);
+                const float cosCutoff = light.fCosCutoffAngle;
+                const F8 falloff = light.fSpotFalloff.eval(cosAngle);
+                scale = if_then_else(cosAngle < cosCutoff, F8(0.f),
+                        if_then_else(cosAngle < cosCutoff + kConeAAThreshold,
+                                     falloff * (cosAngle - cosCutoff) * kConeScale,
+                                     falloff));
+            }
+
+            F8 coeff;
+            if (light.fMaterialType == Material::Type::kDiffuse) {
+                coeff = nx * lx + ny * ly + nz * lz;
+            } else {
+                F8 hx = lx, hy = ly, hz = lz + 1.f;
+                normalize(hx, hy, hz);
+                coeff = light.fShininess.eval(nx * hx + ny * hy + nz * hz);
+            }
+            coeff *= scale;
+
+            const F8 r = pin(coeff * light.fColor.x, F8(0.f), F8(1.f)),
+                     g = pin(coeff * light.fColor.y, F8(0.f), F8(1.f)),
+                     b = pin(coeff * light.fColor.z, F8(0.f), F8(1.f));
+            const F8 a = light.fMaterialType == Material::Type::kDiffuse ? F8(1.f)
+                                                                          : max(r, max(g, b));
+            auto to_byte = [](F8 v) { return skvx::cast<uint32_t>(v * 255.f + 0.5f); };
+            const skvx::Vec<8, uint32_t> px = to_byte(r) << SK_R32_SHIFT |
+                                              to_byte(g) << SK_G32_SHIFT |
+                                              to_byte(b) << SK_B32_SHIFT |
+                                              to_byte(a) << SK_A32_SHIFT;
+            if (x + 8 <= w) {
+                px.store(out + x);
+            } else {
+                for (int j = 0; j < w - x; ++j) {
+                    out[x + j] = px[j];
+                }
+            }
+        }
+    }
+}
+
+// SVG filters commonly light the same input with several lights (e.g. a diffuse and a specular
+// lighting filter that are merged), where each lighting filter would derive the same normal map,
+// so the normal maps are kept in the resource cache keyed by the input image.
+static unsigned gNormalMapKeyNamespaceLabel;
+
+struct NormalMapKey : public SkResourceCache::Key {
+    NormalMapKey(uint32_t imageID, const SkIRect& imageSubset, const SkIRect& srcBounds,
+                 const SkIRect& clampRect, const SkIRect& bounds, float surfaceDepth)
+            : fImageID(imageID)
+            , fSurfaceDepth(surfaceDepth)
+            , fImageSubset(imageSubset)
+            , fSrcBounds(srcBounds)
+            , fClampRect(clampRect)
+            , fBounds(bounds) {
+        this->init(&gNormalMapKeyNamespaceLabel, imageID,
+                   sizeof(fImageID) + sizeof(fSurfaceDepth) + 4 * sizeof(SkIRect));
+    }
+
+    uint32_t fImageID;
+    float    fSurfaceDepth;
+    SkIRect  fImageSubset;
+    SkIRect  fSrcBounds;
+    SkIRect  fClampRect;
+    SkIRect  fBounds;
+};
+
+struct NormalMapRec : public SkResourceCache::Rec {
+    NormalMapRec(const NormalMapKey& key, SkCachedData* data) : fKey(key), fData(data) {
+        fData->attachToCacheAndRef();
+    }
+    ~NormalMapRec() override {
+        fData->detachFromCacheAndUnref();
+    }
+
+    NormalMapKey  fKey;
+    SkCachedData* fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "lighting-normals"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const NormalMapRec& rec = static_cast<const NormalMapRec&>(baseRec);
+        SkCachedData** result = static_cast<SkCachedData**>(contextData);
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+
+// Lights 'dstBounds' given the input alpha in 'input' (which covers 'srcBounds' and may be null
+// when there is no input). Returns null if the input can't be read or memory can't be allocated.
+sk_sp<SkSpecialImage> cpu_lighting(const skif::Context& ctx,
+                                   const sk_sp<SkSpecialImage>& input,
+                                   const SkIRect& srcBounds,
+                                   const SkIRect& clampRect,
+                                   const SkIRect& dstBounds,
+                                   float surfaceDepth,
+                                   const CpuLight& light) {
+    SkBitmap src;
+    if (input && (!SkSpecialImages::AsBitmap(input.get(), &src) ||
+                  src.colorType() != kN32_SkColorType)) {
+        return nullptr;
+    }
+    SkASSERT(!input || (input->width() == srcBounds.width() &&
+                        input->height() == srcBounds.height()));
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::MakeN32Premul(dstBounds.width(), dstBounds.height()))) {
+        return nullptr;
+    }
+
+    NormalMapKey key(input ? input->uniqueID() : SK_InvalidUniqueID,
+                     input ? input->subset() : SkIRect::MakeEmpty(),
+                     srcBounds, clampRect, dstBounds, surfaceDepth);
+    SkCachedData* cachedNormals = nullptr;
+    sk_sp<SkCachedData> normals;
+    if (input && SkResourceCache::Find(key, NormalMapRec::Visitor, &cachedNormals)) {
+        normals.reset(cachedNormals);
+    } else {
+        const size_t normalBytes = kNormalPlanes * sizeof(float) *
+                                   normal_map_stride(dstBounds) * dstBounds.height();
+        normals.reset(SkResourceCache::NewCachedData(normalBytes));
+        if (!normals || !normals->writable_data()) {
+            return nullptr;
+        }
+        compute_normals(src.pixmap(), srcBounds, clampRect, dstBounds, surfaceDepth,
+                        static_cast<float*>(normals->writable_data()));
+        if (input) {
+            SkResourceCache::Add(new NormalMapRec(key, normals.get()));
+        }
+    }
+
+    compute_lighting(static_cast<const float*>(normals->data()), dstBounds, light, dst.pixmap());
+
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                           dst,
+                                           ctx.backend()->surfaceProps());
+}
+
 sk_sp<SkImageFilter> make_lighting(const Light& light,
                                    const Material& material,
                                    sk_sp<SkImageFilter> input,
@@ -551,6 +899,34 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
                 edgeClamp(inputRect.bottom(), requiredInput.bottom(), clampTo.bottom())});
     }
 
+    if (!ctx.backend()->getBlurEngine()) {
+        auto [resolvedChildOutput, origin] =
+                childOutput.imageAndOffset(ctx.withNewDesiredOutput(requiredInput));
+        SkIRect srcBounds = SkIRect::MakeEmpty();
+        if (resolvedChildOutput) {
+            srcBounds = SkIRect::MakeXYWH(origin.x(), origin.y(),
+                                          resolvedChildOutput->width(),
+                                          resolvedChildOutput->height());
+        }
+
+        const bool isSpecular = fMaterial.fType == Material::Type::kSpecular;
+        const CpuLight light{fLight.fType,
+                             scaled_light_color(fLight.fLightColor, fMaterial.fK),
+                             SkV3{lightLocationXY.x(), lightLocationXY.y(), lightLocationZ.val()},
+                             normalized_light_direction(lightDirXY, lightDirZ),
+                             fLight.fCosCutoffAngle,
+                             PowTable(fLight.fType == Light::Type::kSpot ? fLight.fFalloffExponent
+                                                                         : 1.f),
+                             fMaterial.fType,
+                             PowTable(isSpecular ? fMaterial.fShininess : 1.f)};
+        if (sk_sp<SkSpecialImage> result = cpu_lighting(ctx, resolvedChildOutput, srcBounds,
+                                                        SkIRect(clampRect),
+                                                        SkIRect(ctx.desiredOutput()),
+                                                        surfaceDepth.val(), light)) {
+            return skif::FilterResult{std::move(result), ctx.desiredOutput().topLeft()};
+        }
+    }
+
     skif::FilterResult::Builder builder{ctx};
     builder.add(childOutput, /*sampleBounds=*/clampRect, ShaderFlags::kSampledRepeatedly);
     return builder.eval([&](SkSpan<sk_sp<SkShader>> input) {
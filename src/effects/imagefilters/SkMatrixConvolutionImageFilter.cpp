@@ -31,14 +31,18 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <optional>
@@ -58,6 +62,9 @@ static_assert(kMaxUniformKernelSize % 4 == 0, "Must be a multiple of 4");
 SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
                               float* innerGain, float* innerBias);
 
+bool decompose_kernel(const SkISize& kernelSize, const float* kernel,
+                      TArray<float>* kernelX, TArray<float>* kernelY);
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -78,6 +85,8 @@ public:
 
         // Does nothing for small kernels, otherwise encodes kernel into an A8 image.
         fKernelBitmap = create_kernel_bitmap(kernelSize, kernel, &fInnerGain, &fInnerBias);
+        // Factors the kernel into 1D passes for the CPU, when that is cheaper than the 2D kernel.
+        fSeparable = decompose_kernel(kernelSize, kernel, &fKernelX, &fKernelY);
     }
 
     SkRect computeFastBounds(const SkRect& bounds) const override;
@@ -123,6 +132,13 @@ private:
 
     sk_sp<SkShader> createShader(const skif::Context& ctx, sk_sp<SkShader> input) const;
 
+    // Evaluates the convolution directly on the pixels of 'input' (which covers 'srcBounds') for
+    // the raster backend. Returns null if the input can't be read or memory couldn't be allocated.
+    sk_sp<SkSpecialImage> cpuConvolve(const skif::Context& ctx,
+                                      const sk_sp<SkSpecialImage>& input,
+                                      const skif::LayerSpace<SkIRect>& srcBounds,
+                                      const skif::LayerSpace<SkIRect>& dstBounds) const;
+
     // Original kernel data, preserved for serialization even if it was encoded into fKernelBitmap
     TArray<float> fKernel;
 
@@ -141,6 +157,13 @@ private:
     SkBitmap fKernelBitmap;
     float fInnerBias;
     float fInnerGain;
+
+    // Also derived from fKernel: when fSeparable is true, the kernel is equal to the sum of the
+    // outer products of the corresponding fKernelY and fKernelX vectors (of the kernel's height
+    // and width respectively), so the CPU can apply it as a sequence of 1D passes.
+    bool fSeparable;
+    TArray<float> fKernelX;
+    TArray<float> fKernelY;
 };
 
 // LayerSpace doesn't have a clean type to represent 4 separate edge deltas, but the result
@@ -175,10 +198,9 @@ SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
 
 
     // The convolution kernel is "big". The SVG spec has no upper limit on what's supported so
-    // store the kernel in a SkBitmap that will be uploaded to a data texture. We could
-    // implement a more straight forward evaluation loop for the CPU backend, but kernels of
-    // this size are already going to be very slow so we accept the extra indirection to
-    // keep the code paths consolidated.
+    // store the kernel in a SkBitmap that will be uploaded to a data texture. The CPU backend
+    // evaluates the original float kernel directly (see cpuConvolve()), so this is only used on
+    // the GPU.
     //
     // We store the data in A8 for universal support, but this requires normalizing the values
     // and adding an extra inner bias operation to the shader. We could store values in A16 or
@@ -223,6 +245,153 @@ SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
     return kernelBM;
 }
 
+// Cyclic Jacobi eigenvalue decomposition of the symmetric n x n matrix 'a' (row-major), which is
+// diagonalized in place so that a[i*n+i] holds the i-th eigenvalue and the i-th column of 'v'
+// holds its eigenvector.
+void jacobi_eigen(int n, double* a, double* v) {
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            v[i*n + j] = i == j ? 1.0 : 0.0;
+        }
+    }
+
+    static constexpr int kMaxSweeps = 32;
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        double offDiagonal = 0.0, diagonal = 0.0;
+        for (int p = 0; p < n; ++p) {
+            diagonal += a[p*n + p] * a[p*n + p];
+            for (int q = p + 1; q < n; ++q) {
+                offDiagonal += a[p*n + q] * a[p*n + q];
+            }
+        }
+        if (offDiagonal <= 1e-24 * diagonal) {
+            return;
+        }
+
+        for (int p = 0; p < n; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                const double apq = a[p*n + q];
+                if (apq == 0.0) {
+                    continue;
+                }
+                // Rotate by the angle that zeroes a[p][q]: A' = J^T A J
+                const double theta = (a[q*n + q] - a[p*n + p]) / (2 * apq);
+                const double t = std::copysign(1.0, theta) /
+                                 (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const double c = 1 / std::sqrt(t * t + 1),
+                             s = t * c;
+                for (int k = 0; k < n; ++k) {
+                    const double akp = a[k*n + p], akq = a[k*n + q];
+                    a[k*n + p] = c * akp - s * akq;
+                    a[k*n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const double apk = a[p*n + k], aqk = a[q*n + k];
+                    a[p*n + k] = c * apk - s * aqk;
+                    a[q*n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const double vkp = v[k*n + p], vkq = v[k*n + q];
+                    v[k*n + p] = c * vkp - s * vkq;
+                    v[k*n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Writes the kernel as a sum of rank-1 (separable) kernels, i.e. the outer products of vectors in
+// 'kernelY' (of the kernel height) and 'kernelX' (of the kernel width), using its singular value
+// decomposition. Only as many terms are kept as are needed to reproduce the kernel, which is a
+// single term for common kernels like box or Gaussian blurs. Returns false if the kernel's rank
+// is high enough that the 1D passes would take more samples than the 2D kernel.
+bool decompose_kernel(const SkISize& kernelSize, const float* kernel,
+                      TArray<float>* kernelX, TArray<float>* kernelY) {
+    const int w = kernelSize.width(),
+              h = kernelSize.height();
+    // Decompose M, which is either the kernel or its transpose so that it has no more columns than
+    // rows. With G = M^T M = V S^2 V^T, M = sum(M*v_i * v_i^T) over the eigenvectors of G, and G
+    // is at most 16x16 since the kernel has at most kLargeKernelSize entries.
+    const bool transpose = w > h;
+    const int rows = transpose ? w : h,
+              cols = transpose ? h : w;
+    auto m = [&](int row, int col) -> double {
+        return transpose ? kernel[col*w + row] : kernel[row*w + col];
+    };
+
+    double maxCoeff = 0.0;
+    for (int i = 0; i < w * h; ++i) {
+        maxCoeff = std::max(maxCoeff, (double) std::abs(kernel[i]));
+    }
+
+    AutoSTArray<16*16, double> gram(cols * cols), eigenvectors(cols * cols);
+    for (int i = 0; i < cols; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            double dot = 0.0;
+            for (int k = 0; k < rows; ++k) {
+                dot += m(k, i) * m(k, j);
+            }
+            gram[i*cols + j] = dot;
+        }
+    }
+    jacobi_eigen(cols, gram.get(), eigenvectors.get());
+
+    AutoSTArray<16, int> order(cols);
+    for (int i = 0; i < cols; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.get(), order.get() + cols, [&](int a, int b) {
+        return gram[a*cols + a] > gram[b*cols + b];
+    });
+
+    // Add terms in order of decreasing singular value until the kernel is reproduced.
+    const double tolerance = 1e-5 * maxCoeff;
+    AutoSTArray<16*16, double> residual(rows * cols);
+    AutoSTArray<16, double> mv(rows);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            residual[i*cols + j] = m(i, j);
+        }
+    }
+    kernelX->clear();
+    kernelY->clear();
+    for (int rank = 0; rank <= cols; ++rank) {
+        double maxResidual = 0.0;
+        for (int i = 0; i < rows * cols; ++i) {
+            maxResidual = std::max(maxResidual, std::abs(residual[i]));
+        }
+        if (maxResidual <= tolerance) {
+            return true;
+        }
+        if (rank == cols || (rank + 1) * (w + h) >= w * h) {
+            break;
+        }
+
+        const double* v = eigenvectors.get() + order[rank];  // strided by 'cols'
+        for (int i = 0; i < rows; ++i) {
+            double dot = 0.0;
+            for (int j = 0; j < cols; ++j) {
+                dot += m(i, j) * v[j*cols];
+            }
+            mv[i] = dot;
+            for (int j = 0; j < cols; ++j) {
+                residual[i*cols + j] -= dot * v[j*cols];
+            }
+        }
+        // The column factor of M is M*v and its row factor is v, which swap for the transpose.
+        for (int j = 0; j < cols; ++j) {
+            (transpose ? kernelY : kernelX)->push_back((float) v[j*cols]);
+        }
+        for (int i = 0; i < rows; ++i) {
+            (transpose ? kernelX : kernelY)->push_back((float) mv[i]);
+        }
+    }
+
+    kernelX->clear();
+    kernelY->clear();
+    return false;
+}
+
 } // anonymous namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -388,6 +557,116 @@ sk_sp<SkShader> SkMatrixConvolutionImageFilter::createShader(const skif::Context
     return builder.makeShader();
 }
 
+sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::cpuConvolve(
+        const skif::Context& ctx,
+        const sk_sp<SkSpecialImage>& input,
+        const skif::LayerSpace<SkIRect>& srcBounds,
+        const skif::LayerSpace<SkIRect>& dstBounds) const {
+    using F4 = skvx::float4;
+
+    SkBitmap src;
+    if (!SkSpecialImages::AsBitmap(input.get(), &src) || src.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+    SkASSERT(input->width() == srcBounds.width() && input->height() == srcBounds.height());
+
+    // The color channels are convolved as floats. 'padded' holds every pixel sampled by the kernel,
+    // with transparent black outside of the input, so that the passes need no edge handling.
+    const SkIRect sampled = SkIRect(this->boundsSampledByKernel(dstBounds));
+    const int dstW = dstBounds.width(),
+              dstH = dstBounds.height();
+    const SkImageInfo floatInfo = SkImageInfo::Make(1, 1, kRGBA_F32_SkColorType,
+                                                    kUnpremul_SkAlphaType);
+    SkBitmap padded, tmp, sum, dst;
+    if (!padded.tryAllocPixels(floatInfo.makeDimensions(sampled.size())) ||
+        !sum.tryAllocPixels(floatInfo.makeWH(dstW, dstH)) ||
+        (fSeparable && !tmp.tryAllocPixels(floatInfo.makeWH(dstW, sampled.height()))) ||
+        !dst.tryAllocPixels(src.info().makeWH(dstW, dstH))) {
+        return nullptr;
+    }
+    padded.eraseColor(SK_ColorTRANSPARENT);
+    sum.eraseColor(SK_ColorTRANSPARENT);
+
+    auto row = [](SkBitmap& bm, int y) { return static_cast<float*>(bm.getAddr(0, y)); };
+
+    SkIRect overlap = SkIRect(srcBounds);
+    if (overlap.intersect(sampled)) {
+        for (int y = overlap.fTop; y < overlap.fBottom; ++y) {
+            const uint32_t* s = src.getAddr32(overlap.fLeft - srcBounds.left(),
+                                              y - srcBounds.top());
+            float* d = row(padded, y - sampled.fTop) + 4 * (overlap.fLeft - sampled.fLeft);
+            for (int x = 0; x < overlap.width(); ++x, d += 4) {
+                // N32 is either RGBA or BGRA, but the kernel treats R, G and B the same anyway.
+                F4 c = skvx::cast<float>(skvx::byte4::Load(s + x)) * (1 / 255.f);
+                if (!fConvolveAlpha && c[3] > 0.f) {
+                    c = F4(c[0] / c[3], c[1] / c[3], c[2] / c[3], c[3]);
+                }
+                c.store(d);
+            }
+        }
+    }
+
+    // Accumulates weights[i] * src[i*stride] into 'dst', over n floats.
+    auto accumulate = [](float* dst, const float* src, int n, const float* weights, int count,
+                         int stride) {
+        for (int i = 0; i < count; ++i, src += stride) {
+            const float w = weights[i];
+            if (w == 0.f) {
+                continue;
+            }
+            for (int k = 0; k < n; ++k) {
+                dst[k] += w * src[k];
+            }
+        }
+    };
+
+    const int kw = fKernelSize.width(),
+              kh = fKernelSize.height();
+    const int n = 4 * dstW;
+    if (fSeparable) {
+        const int stride = static_cast<int>(tmp.rowBytes() / sizeof(float));
+        for (int r = 0; r < fKernelX.size() / kw; ++r) {
+            tmp.eraseColor(SK_ColorTRANSPARENT);
+            for (int y = 0; y < sampled.height(); ++y) {
+                accumulate(row(tmp, y), row(padded, y), n, fKernelX.data() + r*kw, kw, 4);
+            }
+            for (int y = 0; y < dstH; ++y) {
+                accumulate(row(sum, y), row(tmp, y), n, fKernelY.data() + r*kh, kh, stride);
+            }
+        }
+    } else {
+        for (int y = 0; y < dstH; ++y) {
+            for (int ky = 0; ky < kh; ++ky) {
+                accumulate(row(sum, y), row(padded, y + ky), n, fKernel.data() + ky*kw, kw, 4);
+            }
+        }
+    }
+
+    // Matches the footer of the matrix convolution shaders
+    const F4 gain = fGain,
+             bias = fBias / 255.f;
+    for (int y = 0; y < dstH; ++y) {
+        const float* s = row(sum, y);
+        const float* center = row(padded, y + fKernelOffset.y()) + 4 * fKernelOffset.x();
+        uint32_t* d = dst.getAddr32(0, y);
+        for (int x = 0; x < dstW; ++x, s += 4, center += 4) {
+            F4 c = F4::Load(s) * gain + bias;
+            if (!fConvolveAlpha) {
+                const float origAlpha = center[3];
+                c = F4(c[0] * origAlpha, c[1] * origAlpha, c[2] * origAlpha, origAlpha);
+            } else {
+                c[3] = std::clamp(c[3], 0.f, 1.f);
+            }
+            c = skvx::pin(c, F4(0.f), F4(c[3]));
+            skvx::cast<uint8_t>(c * 255.f + 0.5f).store(d + x);
+        }
+    }
+
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                           dst,
+                                           ctx.backend()->surfaceProps());
+}
+
 skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         const skif::Context& context) const {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
@@ -409,6 +688,23 @@ skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         }
     }
 
+    if (!context.backend()->getBlurEngine()) {
+        // On the CPU, convolve the pixels directly instead of evaluating the kernel in a shader.
+        skif::LayerSpace<SkIRect> sampledBounds = this->boundsSampledByKernel(outputBounds);
+        auto [resolvedChildOutput, origin] =
+                childOutput.imageAndOffset(context.withNewDesiredOutput(sampledBounds));
+        if (resolvedChildOutput) {
+            skif::LayerSpace<SkIRect> srcBounds{SkIRect::MakeXYWH(origin.x(),
+                                                                  origin.y(),
+                                                                  resolvedChildOutput->width(),
+                                                                  resolvedChildOutput->height())};
+            if (sk_sp<SkSpecialImage> result = this->cpuConvolve(context, resolvedChildOutput,
+                                                                 srcBounds, outputBounds)) {
+                return skif::FilterResult{std::move(result), outputBounds.topLeft()};
+            }
+        }
+    }
+
     skif::FilterResult::Builder builder{context};
     builder.add(childOutput,
                 this->boundsSampledByKernel(outputBounds),
@@ -11,11 +11,12 @@
 namespace MatrixConvolutionImageFilter {
 
 // The matrix convolution image filter applies the convolution naively, it does not use any DFT to
-// convert the input images into the frequency domain. As such, kernels can quickly become too
-// slow to run in a reasonable amount of time (and anyone using a giant kernel should not be
-// relying on Skia to perform the calculations). 256 as a limit on the kernel size is somewhat
-// arbitrary but should, hopefully, not cause existing clients/websites to fail when historically
-// there was no upper limit.
+// convert the input images into the frequency domain (on the CPU, kernels with a low rank are
+// factored into 1D passes, but that only helps e.g. blur-like kernels). As such, kernels can
+// quickly become too slow to run in a reasonable amount of time (and anyone using a giant kernel
+// should not be relying on Skia to perform the calculations). 256 as a limit on the kernel size is
+// somewhat arbitrary but should, hopefully, not cause existing clients/websites to fail when
+// historically there was no upper limit.
 // Note: SkSL balks (w/ a "program is too large" error) whenever the number of kernel values
 // is >= 2048 (e.g., 8x256, 16x128, ...) so that should be a pretty good upper limit for what
 // is being seen in the wild.
@@ -7,8 +7,12 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -18,14 +22,18 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -222,6 +230,121 @@ skif::FilterResult morphology_pass(const skif::Context& ctx, const skif::FilterR
     return childOutput;
 }
 
+// The CPU implementation uses the van Herk/Gil-Werman algorithm, which computes the min or max
+// over a window of any size with three comparisons per pixel. Each pass works on four adjacent
+// rows (the X pass) or columns (the Y pass) at once, with all four channels of each N32 pixel.
+using MorphLane = skvx::Vec<16, uint8_t>;
+
+template <MorphType kType>
+SK_ALWAYS_INLINE MorphLane morph(const MorphLane& a, const MorphLane& b) {
+    return kType == MorphType::kDilate ? max(a, b) : min(a, b);
+}
+
+// Sets out[i] to the aggregate of in[i] through in[i + 2*radius], for 'count' outputs. 'in' holds
+// count + 2*radius values, and 'g' and 'h' are scratch space of the same size.
+template <MorphType kType>
+void van_herk_gil_werman(const MorphLane* in, int count, int radius,
+                         MorphLane* g, MorphLane* h, MorphLane* out) {
+    const int window = 2 * radius + 1;
+    const int length = count + 2 * radius;
+
+    // 'g' accumulates forward from the start of each window-sized block, 'h' backward from the
+    // end of it. Any window then spans at most two blocks: the tail of one and the head of the next.
+    for (int i = 0; i < length; ++i) {
+        g[i] = (i % window == 0) ? in[i] : morph<kType>(g[i - 1], in[i]);
+    }
+    for (int i = length - 1; i >= 0; --i) {
+        h[i] = (i % window == window - 1 || i == length - 1) ? in[i] : morph<kType>(h[i + 1], in[i]);
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i] = morph<kType>(h[i], g[i + 2 * radius]);
+    }
+}
+
+// Morphs 'src' (covering 'srcBounds') along 'dir' into 'dst' (covering 'dstBounds'). Pixels
+// outside of 'srcBounds' are transparent black.
+template <MorphType kType>
+void cpu_morphology_pass(MorphDirection dir, int radius,
+                         const SkPixmap& src, const SkIRect& srcBounds,
+                         const SkPixmap& dst, const SkIRect& dstBounds) {
+    // Along the pass, each output depends on 2*radius more inputs; across it, lines are
+    // independent and are processed four at a time.
+    const bool isX = dir == MorphDirection::kX;
+    const int count = isX ? dstBounds.width() : dstBounds.height();
+    const int lines = isX ? dstBounds.height() : dstBounds.width();
+    const int length = count + 2 * radius;
+
+    skia_private::AutoTArray<MorphLane> in(length), g(length), h(length), out(count);
+
+    // Returns the source pixel at 'along' and 'across' in dst's coordinates, as in the pass.
+    auto srcPixel = [&](int along, int across) -> uint32_t {
+        int x = isX ? along : across,
+            y = isX ? across : along;
+        return srcBounds.contains(x, y) ? *src.addr32(x - srcBounds.fLeft, y - srcBounds.fTop)
+                                        : 0;
+    };
+
+    const int firstAlong = (isX ? dstBounds.fLeft : dstBounds.fTop) - radius;
+    const int firstAcross = isX ? dstBounds.fTop : dstBounds.fLeft;
+    for (int line = 0; line < lines; line += 4) {
+        const int n = std::min(4, lines - line);
+        for (int i = 0; i < length; ++i) {
+            uint32_t px[4] = {0, 0, 0, 0};
+            for (int k = 0; k < n; ++k) {
+                px[k] = srcPixel(firstAlong + i, firstAcross + line + k);
+            }
+            in[i] = MorphLane::Load(px);
+        }
+
+        van_herk_gil_werman<kType>(in.get(), count, radius, g.get(), h.get(), out.get());
+
+        for (int i = 0; i < count; ++i) {
+            uint32_t px[4];
+            out[i].store(px);
+            for (int k = 0; k < n; ++k) {
+                if (isX) {
+                    *dst.writable_addr32(i, line + k) = px[k];
+                } else {
+                    *dst.writable_addr32(line + k, i) = px[k];
+                }
+            }
+        }
+    }
+}
+
+sk_sp<SkSpecialImage> cpu_morphology(const skif::Context& ctx,
+                                     MorphType type,
+                                     skif::LayerSpace<SkISize> radii,
+                                     const sk_sp<SkSpecialImage>& input,
+                                     skif::LayerSpace<SkIRect> srcBounds,
+                                     skif::LayerSpace<SkIRect> dstBounds) {
+    SkBitmap src;
+    if (!SkSpecialImages::AsBitmap(input.get(), &src) || src.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+    SkASSERT(input->width() == srcBounds.width() && input->height() == srcBounds.height());
+
+    // The X pass has to preserve the extra rows to later be consumed by the Y pass.
+    SkIRect dstBoundsX = SkIRect(dstBounds).makeOutset(0, radii.height());
+
+    SkBitmap tmp, dst;
+    if (!tmp.tryAllocPixels(src.info().makeWH(dstBoundsX.width(), dstBoundsX.height())) ||
+        !dst.tryAllocPixels(src.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return nullptr;
+    }
+
+    auto passes = type == MorphType::kDilate ? cpu_morphology_pass<MorphType::kDilate>
+                                             : cpu_morphology_pass<MorphType::kErode>;
+    passes(MorphDirection::kX, radii.width(),
+           src.pixmap(), SkIRect(srcBounds), tmp.pixmap(), dstBoundsX);
+    passes(MorphDirection::kY, radii.height(),
+           tmp.pixmap(), dstBoundsX, dst.pixmap(), SkIRect(dstBounds));
+
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()),
+                                           dst,
+                                           ctx.backend()->surfaceProps());
+}
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::Dilate(SkScalar radiusX, SkScalar radiusY,
@@ -282,8 +405,28 @@ skif::FilterResult SkMorphologyImageFilter::onFilterImage(const skif::Context& c
         return {};
     }
 
-    // The X pass has to preserve the extra rows to later be consumed by the Y pass.
     skif::LayerSpace<SkISize> radii = this->radii(ctx.mapping());
+
+    // As in SkBlurImageFilter, a backend without a blur engine is the CPU. There, the
+    // van Herk/Gil-Werman passes cost the same for any radius, unlike the shader passes below.
+    if (!ctx.backend()->getBlurEngine()) {
+        skif::Context inputCtx = ctx.withNewDesiredOutput(requiredInput);
+        auto [resolvedChildOutput, origin] = childOutput.imageAndOffset(inputCtx);
+        if (!resolvedChildOutput) {
+            return {};
+        }
+        skif::LayerSpace<SkIRect> srcBounds{SkIRect::MakeXYWH(origin.x(),
+                                                              origin.y(),
+                                                              resolvedChildOutput->width(),
+                                                              resolvedChildOutput->height())};
+        if (sk_sp<SkSpecialImage> result = cpu_morphology(ctx, fType, radii,
+                                                          resolvedChildOutput,
+                                                          srcBounds, maxOutput)) {
+            return skif::FilterResult{std::move(result), maxOutput.topLeft()};
+        }
+    }
+
+    // The X pass has to preserve the extra rows to later be consumed by the Y pass.
     skif::LayerSpace<SkIRect> maxOutputX = maxOutput;
     maxOutputX.outset(skif::LayerSpace<SkISize>({0, radii.height()}));
     childOutput = morphology_pass(ctx.withNewDesiredOutput(maxOutputX), childOutput, fType,
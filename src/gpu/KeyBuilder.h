@@ -59,6 +59,27 @@ public:
         this->addBits(32, v, label);
     }
 
+    // Appends 'numBits' bits that another KeyBuilder packed into 'words', as though they had been
+    // added to this builder one field at a time. Labels are not available, so this should only be
+    // used when building keys that won't be described.
+    void addPackedBits(const uint32_t* words, uint32_t numBits) {
+        const uint32_t numWords = numBits / 32;
+        if (fBitsUsed == 0) {
+            fData->push_back_n(numWords, words);
+        } else {
+            for (uint32_t i = 0; i < numWords; ++i) {
+                fData->push_back(fCurValue | (words[i] << fBitsUsed));
+                fCurValue = words[i] >> (32 - fBitsUsed);
+            }
+        }
+        if (uint32_t tailBits = numBits % 32) {
+            this->KeyBuilder::addBits(tailBits, words[numWords], "packed");
+        }
+    }
+
+    // The number of bits added since the last flush, plus 32 for every word already in the key.
+    uint32_t numBits() const { return fData->size() * 32 + fBitsUsed; }
+
     virtual void appendComment(const char* comment) {}
 
     // Introduces a word-boundary in the key. Must be called before using the key with any cache,
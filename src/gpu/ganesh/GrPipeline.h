@@ -9,6 +9,7 @@
 #define GrPipeline_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/gpu/ganesh/GrTypesPriv.h"
 #include "src/gpu/ganesh/GrColor.h"
 #include "src/gpu/ganesh/GrDstProxyView.h"
@@ -202,6 +203,8 @@ public:
                                GrGLSLBuiltinUniformHandles* fBuiltinUniformHandles) const;
 
 private:
+    friend class GrProgramDesc; // to cache the pipeline's portion of the program key
+
     inline static constexpr uint8_t kLastInputFlag =
             (uint8_t)InputFlags::kSnapVerticesToPixelCenters;
 
@@ -229,6 +232,17 @@ private:
     int fNumColorProcessors = 0;
 
     skgpu::Swizzle fWriteSwizzle;
+
+    // The bits GrProgramDesc::Build generates for this pipeline's processors, swizzle and flags.
+    // They only depend on the pipeline (which is immutable) and the caps, so an op that keys the
+    // same pipeline for several draws, or a DDL that keys it at record and at replay time, only
+    // walks the processor trees once.
+    struct KeyFragment {
+        const GrCaps* fCaps = nullptr;
+        uint32_t fNumBits = 0;
+        skia_private::STArray<8, uint32_t, true> fWords;
+    };
+    mutable KeyFragment fKeyFragment;
 };
 
 GR_MAKE_BITFIELD_CLASS_OPS(GrPipeline::InputFlags)
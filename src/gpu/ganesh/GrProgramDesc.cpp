@@ -148,12 +148,9 @@ static void gen_fp_key(const GrFragmentProcessor& fp,
     }
 }
 
-static void gen_key(skgpu::KeyBuilder* b,
-                    const GrProgramInfo& programInfo,
-                    const GrCaps& caps) {
-    gen_geomproc_key(programInfo.geomProc(), caps, b);
-
-    const GrPipeline& pipeline = programInfo.pipeline();
+static void gen_pipeline_key(const GrPipeline& pipeline,
+                             const GrCaps& caps,
+                             skgpu::KeyBuilder* b) {
     b->addBits(2, pipeline.numFragmentProcessors(),      "numFPs");
     b->addBits(1, pipeline.numColorFragmentProcessors(), "numColorFPs");
     for (int i = 0; i < pipeline.numFragmentProcessors(); ++i) {
@@ -164,6 +161,9 @@ static void gen_key(skgpu::KeyBuilder* b,
 
     b->addBits(16, pipeline.writeSwizzle().asKey(), "writeSwizzle");
     b->addBool(pipeline.snapVerticesToPixelCenters(), "snapVertices");
+}
+
+static void finish_key(const GrProgramInfo& programInfo, skgpu::KeyBuilder* b) {
     // The base descriptor only stores whether or not the primitiveType is kPoints. Backend-
     // specific versions (e.g., Vulkan) require more detail
     b->addBool((programInfo.primitiveType() == GrPrimitiveType::kPoints), "isPoints");
@@ -173,15 +173,50 @@ static void gen_key(skgpu::KeyBuilder* b,
     b->flush();
 }
 
+static void gen_key(skgpu::KeyBuilder* b,
+                    const GrProgramInfo& programInfo,
+                    const GrCaps& caps) {
+    gen_geomproc_key(programInfo.geomProc(), caps, b);
+    gen_pipeline_key(programInfo.pipeline(), caps, b);
+    finish_key(programInfo, b);
+}
+
 void GrProgramDesc::Build(GrProgramDesc* desc,
                           const GrProgramInfo& programInfo,
                           const GrCaps& caps) {
     desc->reset();
     skgpu::KeyBuilder b(desc->key());
-    gen_key(&b, programInfo, caps);
+
+    // Geometry processors can change their samplers between draws (e.g. when a text atlas grows),
+    // so their part of the key is always regenerated. The pipeline's part is generated once per
+    // pipeline and then appended as packed bits, which produces exactly the same key.
+    gen_geomproc_key(programInfo.geomProc(), caps, &b);
+
+    const GrPipeline& pipeline = programInfo.pipeline();
+    GrPipeline::KeyFragment& fragment = pipeline.fKeyFragment;
+    if (fragment.fCaps != &caps) {
+        fragment.fWords.clear();
+        skgpu::KeyBuilder fragmentBuilder(&fragment.fWords);
+        gen_pipeline_key(pipeline, caps, &fragmentBuilder);
+        fragment.fNumBits = fragmentBuilder.numBits();
+        fragmentBuilder.flush();
+        fragment.fCaps = &caps;
+    }
+    b.addPackedBits(fragment.fWords.data(), fragment.fNumBits);
+
+    finish_key(programInfo, &b);
     desc->fInitialKeyLength = desc->keyLength();
 }
 
+GrProgramDesc GrProgramDesc::MakeUncachedForTesting(const GrProgramInfo& programInfo,
+                                                    const GrCaps& caps) {
+    GrProgramDesc desc;
+    skgpu::KeyBuilder b(desc.key());
+    gen_key(&b, programInfo, caps);
+    desc.fInitialKeyLength = desc.keyLength();
+    return desc;
+}
+
 SkString GrProgramDesc::Describe(const GrProgramInfo& programInfo,
                                  const GrCaps& caps) {
     GrProgramDesc desc;
@@ -55,6 +55,10 @@ public:
     // function), so other backends can include their information in the description.
     static SkString Describe(const GrProgramInfo&, const GrCaps&);
 
+    // Returns the key Build would produce, generated by walking every processor rather than
+    // reusing the key fragment Build caches on the GrPipeline.
+    static GrProgramDesc MakeUncachedForTesting(const GrProgramInfo&, const GrCaps&);
+
 protected:
     friend class GrDawnCaps;
     friend class GrD3DCaps;
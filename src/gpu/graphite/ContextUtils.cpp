@@ -7,8 +7,11 @@
 
 #include "src/gpu/graphite/ContextUtils.h"
 
+#include <cstring>
 #include <string>
+#include "include/core/SkM44.h"
 #include "src/core/SkBlenderBase.h"
+#include "src/core/SkChecksum.h"
 #include "src/gpu/BlendFormula.h"
 #include "src/gpu/graphite/Caps.h"
 #include "src/gpu/graphite/GraphicsPipelineDesc.h"
@@ -72,6 +75,83 @@ std::tuple<UniquePaintParamsID, const UniformDataBlock*, const TextureDataBlock*
     return { paintID, uniforms, textures };
 }
 
+namespace {
+
+// Only shaders, and blenders or color filters that may hold them, read the transform.
+bool is_transform_independent(const PaintParams& paint) {
+    auto isMode = [](const SkBlender* blender) {
+        return !blender || as_BB(blender)->asBlendMode().has_value();
+    };
+    return !paint.shader() && !paint.clipShader() && !paint.colorFilter() &&
+           isMode(paint.finalBlender()) && isMode(paint.primitiveBlender());
+}
+
+}  // anonymous namespace
+
+PaintDataCache::Key::Key(const PaintParams& paint,
+                         const SkM44& local2Dev,
+                         bool optimizeSampling,
+                         const TextureProxy* dstTexture,
+                         SkIPoint dstOffset) {
+    // Zero everything, padding included, so that keys can be hashed and compared as bytes.
+    sk_bzero(this, sizeof(*this));
+    fShader = paint.shader();
+    fColorFilter = paint.colorFilter();
+    fFinalBlender = paint.finalBlender();
+    fPrimitiveBlender = paint.primitiveBlender();
+    fClipShader = paint.clipShader();
+    fDstTexture = dstTexture;
+    fColor = paint.color();
+    if (!is_transform_independent(paint)) {
+        local2Dev.getColMajor(fLocal2Dev);
+    }
+    fDstOffset = dstOffset;
+    fDstReadReq = static_cast<uint8_t>(paint.dstReadRequirement());
+    fSkipColorXform = paint.skipColorXform();
+    fDither = paint.dither();
+    fOptimizeSampling = optimizeSampling;
+}
+
+bool PaintDataCache::Key::operator==(const Key& that) const {
+    return !memcmp(this, &that, sizeof(Key));
+}
+
+uint32_t PaintDataCache::Key::Hash::operator()(const Key& k) const {
+    return SkChecksum::Hash32(&k, sizeof(Key));
+}
+
+PaintDataCache::PaintData PaintDataCache::extract(Recorder* recorder,
+                                                  PipelineDataGatherer* gatherer,
+                                                  PaintParamsKeyBuilder* builder,
+                                                  const Layout layout,
+                                                  const SkM44& local2Dev,
+                                                  const PaintParams& p,
+                                                  const Geometry& geometry,
+                                                  sk_sp<TextureProxy> dstTexture,
+                                                  SkIPoint dstOffset,
+                                                  const SkColorInfo& targetColorInfo) {
+    const Key key{p,
+                  local2Dev,
+                  geometry.isShape() || geometry.isEdgeAAQuad(),
+                  dstTexture.get(),
+                  dstOffset};
+    if (const PaintData* data = fData.find(key)) {
+        return *data;
+    }
+    PaintData data = ExtractPaintData(recorder,
+                                      gatherer,
+                                      builder,
+                                      layout,
+                                      local2Dev,
+                                      p,
+                                      geometry,
+                                      std::move(dstTexture),
+                                      dstOffset,
+                                      targetColorInfo);
+    fData.set(key, data);
+    return data;
+}
+
 std::tuple<const UniformDataBlock*, const TextureDataBlock*> ExtractRenderStepData(
         UniformDataCache* uniformDataCache,
         TextureDataCache* textureDataCache,
@@ -8,16 +8,25 @@
 #ifndef skgpu_graphite_ContextUtils_DEFINED
 #define skgpu_graphite_ContextUtils_DEFINED
 
+#include "include/core/SkColor.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+#include "src/core/SkTHash.h"
 #include "src/gpu/Blend.h"
 #include "src/gpu/graphite/PaintParamsKey.h"
 #include "src/gpu/graphite/PipelineDataCache.h"
+#include "src/gpu/graphite/UniquePaintParamsID.h"
 
 #include <optional>
 #include <tuple>
 
+class SkBlender;
+class SkColorFilter;
 class SkColorInfo;
 class SkM44;
 class SkPaint;
+class SkShader;
 
 namespace skgpu {
 class Swizzle;
@@ -38,7 +47,7 @@ struct RenderPassDesc;
 class RenderStep;
 class RuntimeEffectDictionary;
 class ShaderNode;
-class UniquePaintParamsID;
+class TextureProxy;
 
 struct ResourceBindingRequirements;
 
@@ -76,6 +85,70 @@ std::tuple<UniquePaintParamsID, const UniformDataBlock*, const TextureDataBlock*
         SkIPoint dstOffset,
         const SkColorInfo& targetColorInfo);
 
+/**
+ * Remembers what ExtractPaintData() returned for each distinct paint, so that draws within a
+ * DrawPass that repeat a paint skip walking its shader, color filter and blender trees to rebuild
+ * the key and uniforms, and skip the dictionary lookup of the finished key. Paints are matched by
+ * the identity of their effects, which are immutable, and by every KeyContext input the walk
+ * reads.
+ *
+ * A cache must only be used with one gatherer, layout and target color info. The gatherer's
+ * gradient buffer is per-pass, so offsets into it that are cached in the uniforms stay valid.
+ */
+class PaintDataCache {
+public:
+    using PaintData = std::tuple<UniquePaintParamsID,
+                                 const UniformDataBlock*,
+                                 const TextureDataBlock*>;
+
+    // Returns what ExtractPaintData() would for the same arguments, calling it only for the first
+    // draw of each distinct paint.
+    PaintData extract(Recorder*,
+                      PipelineDataGatherer*,
+                      PaintParamsKeyBuilder*,
+                      const Layout layout,
+                      const SkM44& local2Dev,
+                      const PaintParams&,
+                      const Geometry&,
+                      sk_sp<TextureProxy> dstTexture,
+                      SkIPoint dstOffset,
+                      const SkColorInfo& targetColorInfo);
+
+    // The number of distinct paints seen so far.
+    int count() const { return fData.count(); }
+
+private:
+    struct Key {
+        Key(const PaintParams&,
+            const SkM44& local2Dev,
+            bool optimizeSampling,
+            const TextureProxy* dstTexture,
+            SkIPoint dstOffset);
+
+        bool operator==(const Key& that) const;
+
+        struct Hash {
+            uint32_t operator()(const Key& k) const;
+        };
+
+        const SkShader*      fShader;
+        const SkColorFilter* fColorFilter;
+        const SkBlender*     fFinalBlender;
+        const SkBlender*     fPrimitiveBlender;
+        const SkShader*      fClipShader;
+        const TextureProxy*  fDstTexture;
+        SkColor4f            fColor;
+        SkScalar             fLocal2Dev[16];
+        SkIPoint             fDstOffset;
+        uint8_t              fDstReadReq;
+        bool                 fSkipColorXform;
+        bool                 fDither;
+        bool                 fOptimizeSampling;
+    };
+
+    skia_private::THashMap<Key, PaintData, Key::Hash> fData;
+};
+
 std::tuple<const UniformDataBlock*, const TextureDataBlock*> ExtractRenderStepData(
         UniformDataCache* uniformDataCache,
         TextureDataCache* textureDataCache,
@@ -504,6 +504,7 @@ std::unique_ptr<DrawPass> DrawPass::Make(Recorder* recorder,
     }
 
     GraphicsPipelineCache pipelineCache;
+    PaintDataCache paintDataCache;
 
     // Geometry uniforms are currently always UBO-backed.
     const bool useStorageBuffers = recorder->priv().caps()->storageBufferPreferred();
@@ -541,16 +542,16 @@ std::unique_ptr<DrawPass> DrawPass::Make(Recorder* recorder,
                             ? dstCopy
                             : nullptr;
             std::tie(shaderID, shadingUniforms, paintTextures) =
-                    ExtractPaintData(recorder,
-                                     &gatherer,
-                                     &builder,
-                                     uniformLayout,
-                                     draw.fDrawParams.transform(),
-                                     draw.fPaintParams.value(),
-                                     draw.fDrawParams.geometry(),
-                                     curDst,
-                                     dstCopyOffset,
-                                     targetInfo.colorInfo());
+                    paintDataCache.extract(recorder,
+                                           &gatherer,
+                                           &builder,
+                                           uniformLayout,
+                                           draw.fDrawParams.transform(),
+                                           draw.fPaintParams.value(),
+                                           draw.fDrawParams.geometry(),
+                                           curDst,
+                                           dstCopyOffset,
+                                           targetInfo.colorInfo());
         } // else depth-only
 
         for (int stepIndex = 0; stepIndex < draw.fRenderer->numRenderSteps(); ++stepIndex) {
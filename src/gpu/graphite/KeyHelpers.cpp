@@ -1043,15 +1043,11 @@ static void gather_runtime_effect_uniforms(const KeyContext& keyContext,
     SkSpan<const SkRuntimeEffect::Uniform> rtsUniforms = effect->uniforms();
 
     if (!rtsUniforms.empty() && uniformData) {
-        // Collect all the other uniforms from the provided SkData.
-        const uint8_t* uniformBase = uniformData->bytes();
-        for (size_t index = 0; index < rtsUniforms.size(); ++index) {
-            const Uniform& uniform = graphiteUniforms[index];
-            // Get a pointer to the offset in our data for this uniform.
-            const uint8_t* uniformPtr = uniformBase + rtsUniforms[index].offset;
-            // Pass the uniform data to the gatherer.
-            gatherer->write(uniform, uniformPtr);
-        }
+        // Collect all the other uniforms from the provided SkData. SkRuntimeEffect packs them
+        // tightly in declaration order, so the gatherer can copy runs of them at once.
+        SkASSERT(rtsUniforms.back().offset + rtsUniforms.back().sizeInBytes() <=
+                 uniformData->size());
+        gatherer->write(graphiteUniforms.first(rtsUniforms.size()), uniformData->data());
     }
 
     if (SkRuntimeEffectPriv::UsesColorTransform(effect)) {
@@ -59,6 +59,8 @@ public:
     SkBlender* primitiveBlender() const { return fPrimitiveBlender.get(); }
     sk_sp<SkBlender> refPrimitiveBlender() const;
 
+    SkShader* clipShader() const { return fClipShader.get(); }
+
     DstReadRequirement dstReadRequirement() const { return fDstReadReq; }
     bool skipColorXform() const { return fSkipColorXform; }
     bool dither() const { return fDither; }
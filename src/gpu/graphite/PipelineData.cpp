@@ -38,14 +38,10 @@ UniformDataBlock* UniformDataBlock::Make(const UniformDataBlock& other, SkArenaA
     memcpy(mem, other.data(), other.size());
 
     return arena->make([&](void* ptr) {
-        return new (ptr) UniformDataBlock(SkSpan<const char>(mem, other.size()));
+        return new (ptr) UniformDataBlock(SkSpan<const char>(mem, other.size()), other.hash());
     });
 }
 
-uint32_t UniformDataBlock::hash() const {
-    return SkChecksum::Hash32(fData.data(), fData.size());
-}
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 TextureDataBlock* TextureDataBlock::Make(const TextureDataBlock& other,
                                              SkArenaAlloc* arena) {
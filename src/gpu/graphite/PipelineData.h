@@ -17,6 +17,7 @@
 #include "include/core/SkTileMode.h"
 #include "include/private/SkColorData.h"
 #include "src/base/SkEnumBitMask.h"
+#include "src/core/SkChecksum.h"
 #include "src/gpu/graphite/Caps.h"
 #include "src/gpu/graphite/DrawTypes.h"
 #include "src/gpu/graphite/TextureProxy.h"
@@ -32,22 +33,29 @@ class UniformDataBlock {
 public:
     static UniformDataBlock* Make(const UniformDataBlock&, SkArenaAlloc*);
 
-    UniformDataBlock(SkSpan<const char> data) : fData(data) {}
-    UniformDataBlock() = default;
+    // UniformManager hashes the data as it finishes a block and passes that hash along.
+    UniformDataBlock(SkSpan<const char> data)
+            : UniformDataBlock(data, SkChecksum::Hash32(data.data(), data.size())) {}
+    UniformDataBlock(SkSpan<const char> data, uint32_t hash) : fData(data), fHash(hash) {
+        SkASSERT(hash == SkChecksum::Hash32(data.data(), data.size()));
+    }
+    UniformDataBlock() : UniformDataBlock(SkSpan<const char>()) {}
 
     const char* data() const { return fData.data(); }
     size_t size() const { return fData.size(); }
 
-    uint32_t hash() const;
+    uint32_t hash() const { return fHash; }
 
     bool operator==(const UniformDataBlock& that) const {
-        return fData.size() == that.fData.size() &&
+        return fHash == that.fHash &&
+               fData.size() == that.fData.size() &&
                !memcmp(fData.data(), that.fData.data(), fData.size());
     }
     bool operator!=(const UniformDataBlock& that) const { return !(*this == that); }
 
 private:
     SkSpan<const char> fData;
+    uint32_t fHash;
 };
 
 class TextureDataBlock {
@@ -119,6 +127,9 @@ public:
     }
 
     void write(const Uniform& u, const void* data) { fUniformManager.write(u, data); }
+    void write(SkSpan<const Uniform> uniforms, const void* data) {
+        fUniformManager.write(uniforms, data);
+    }
 
     void writePaintColor(const SkPMColor4f& color) { fUniformManager.writePaintColor(color); }
 
@@ -7,6 +7,7 @@
 
 #include "src/gpu/graphite/UniformManager.h"
 
+#include "src/core/SkChecksum.h"
 #include "src/gpu/graphite/PipelineData.h"
 
 // ensure that these types are the sizes the uniform data is expecting
@@ -55,7 +56,10 @@ UniformDataBlock UniformManager::finishUniformDataBlock() {
         char* padding = fStorage.append(paddingSize);
         memset(padding, 0, paddingSize);
     }
-    return UniformDataBlock(SkSpan(fStorage.begin(), size));
+    // Hash once here, while the data is still in cache, so that deduplicating the block in a
+    // UniformDataCache and comparing it against other blocks never has to touch the data again.
+    return UniformDataBlock(SkSpan(fStorage.begin(), size),
+                            SkChecksum::Hash32(fStorage.begin(), size));
 }
 
 void UniformManager::resetWithNewLayout(Layout layout) {
@@ -132,6 +136,75 @@ void UniformManager::write(const Uniform& u, const void* data) {
     }
 }
 
+void UniformManager::write(SkSpan<const Uniform> uniforms, const void* src) {
+    const char* srcBytes = static_cast<const char*>(src);
+
+    // The pending run of uniforms that are stored in `src` exactly as the Layout wants them, so
+    // that they can be copied with one memcpy. Nothing else is appended while a run is pending, so
+    // its final offset in storage is already known.
+    const char* runSrc = srcBytes;
+    size_t runBegin = 0, runEnd = 0; // indices into 'uniforms'
+    int runStart = 0, runSize = 0;
+    int runAlignment = 0, runMaxAlignment = 0;
+
+    auto flushRun = [&]() {
+        if (!runSize) {
+            return;
+        }
+        char* dst = this->append(runAlignment, runSize);
+        SkASSERT(dst == fStorage.begin() + runStart);
+#ifdef SK_DEBUG
+        for (size_t i = runBegin, offset = 0; i < runEnd; ++i) {
+            auto [type, count] = adjust_for_matrix_type(uniforms[i].type(), uniforms[i].count());
+            const int dimension = SkSLTypeVecLength(type);
+            fReqAlignment = std::max(fReqAlignment, SkNextPow2(dimension) * 4);
+            SkASSERT(this->checkExpected(dst + offset, type, count));
+            offset += dimension * 4 * std::max(count, 1);
+        }
+#endif
+        fReqAlignment = std::max(fReqAlignment, runMaxAlignment);
+        memcpy(dst, runSrc, runSize);
+        runSize = 0;
+    };
+
+    for (size_t i = 0; i < uniforms.size(); ++i) {
+        SkASSERT(!uniforms[i].isPaintColor()); // Must go through writePaintColor()
+
+        auto [type, count] = adjust_for_matrix_type(uniforms[i].type(), uniforms[i].count());
+        const int dimension = SkSLTypeVecLength(type);
+        const bool isArray = count > Uniform::kNonArray;
+        // Tightly packed source data stores every primitive, even halfs, in 4 bytes.
+        const int size = dimension * 4 * std::max(count, 1);
+
+        if ((IsHalfVector(type) && !LayoutRules::UseFullPrecision(fLayout)) ||
+            (isArray && dimension != 4 && LayoutRules::AlignArraysAsVec4(fLayout)) ||
+            (dimension == 3 && (isArray || LayoutRules::PadVec3Size(fLayout)))) {
+            // Needs conversion or padding, so write it on its own.
+            flushRun();
+            this->write(uniforms[i], srcBytes);
+        } else {
+            const int alignment = SkNextPow2(dimension) * 4;
+            const int runOffset = runStart + runSize;
+            if (runSize && SkToInt(SkAlignTo(runOffset, alignment)) == runOffset) {
+                // Starts exactly where the run ends, so extend it.
+                runSize += size;
+                runEnd = i + 1;
+                runMaxAlignment = std::max(runMaxAlignment, alignment);
+            } else {
+                flushRun();
+                runSrc = srcBytes;
+                runBegin = i;
+                runEnd = i + 1;
+                runStart = SkToInt(SkAlignTo(fStorage.size(), alignment));
+                runSize = size;
+                runAlignment = runMaxAlignment = alignment;
+            }
+        }
+        srcBytes += size;
+    }
+    flushRun();
+}
+
 #ifdef SK_DEBUG
 
 bool UniformManager::checkExpected(const void* dst, SkSLType type, int count) {
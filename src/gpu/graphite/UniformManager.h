@@ -298,6 +298,11 @@ public:
     // Copy from `src` using Uniform array-count semantics.
     void write(const Uniform&, const void* src);
 
+    // Copy all of `uniforms` from `src`, which holds their values tightly packed in declaration
+    // order (the way SkRuntimeEffect lays out its uniform data). Consecutive uniforms that need
+    // neither padding nor conversion in this Layout are copied with a single memcpy.
+    void write(SkSpan<const Uniform>, const void* src);
+
     // Debug-only functions to control uniform expectations.
 #ifdef SK_DEBUG
     bool isReset() const;
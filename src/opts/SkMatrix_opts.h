@@ -0,0 +1,149 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_DEFINED
+#define SkMatrix_opts_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "src/base/SkVx.h"
+
+#include <limits>
+#include <utility>
+
+// The matrices passed to these functions are the 9 values of an SkMatrix, in SkMatrix's row-major
+// order: scaleX, skewX, transX, skewY, scaleY, transY, persp0, persp1, persp2.
+
+namespace SK_OPTS_NS {
+
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    // Two 8-wide registers of interleaved xy, or one 8-wide register per rect edge.
+    static constexpr int kMatrixLanes = 8;
+#else
+    static constexpr int kMatrixLanes = 4;
+#endif
+
+// Points are mapped while still interleaved as xyxy...; 'kIx' indexes those floats.
+template <int... kIx>
+static skvx::Vec<sizeof...(kIx), float> matrix_swap_xy(
+        const skvx::Vec<sizeof...(kIx), float>& v, std::integer_sequence<int, kIx...>) {
+    return skvx::shuffle<(kIx ^ 1)...>(v);
+}
+
+template <int... kIx>
+static skvx::Vec<sizeof...(kIx), float> matrix_xy_pairs(
+        float x, float y, std::integer_sequence<int, kIx...>) {
+    return skvx::shuffle<(kIx & 1)...>(skvx::float2{x, y});
+}
+
+// Maps as many whole groups of N points as fit in 'count', and returns how many were mapped.
+// The arithmetic is the same as SkMatrix's scalar Persp_pts(), so results don't depend on 'count'.
+template <int N, bool kPersp>
+static int matrix_map_points_n(const SkScalar m[9], SkPoint dst[], const SkPoint src[], int count) {
+    using V = skvx::Vec<2*N, float>;
+    constexpr auto kFloats = std::make_integer_sequence<int, 2*N>{};
+
+    // For the x lanes, 'p' holds x and 'swapped' holds y; the y lanes are the other way around.
+    const V scale = matrix_xy_pairs(m[0], m[4], kFloats),
+            skew  = matrix_xy_pairs(m[1], m[3], kFloats),
+            trans = matrix_xy_pairs(m[2], m[5], kFloats);
+    [[maybe_unused]] const V persp        = matrix_xy_pairs(m[6], m[7], kFloats),
+                             perspSwapped = matrix_xy_pairs(m[7], m[6], kFloats);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        const V p = V::Load(src + i);
+        const V swapped = matrix_swap_xy(p, kFloats);
+        V mapped = p * scale + swapped * skew + trans;
+        if constexpr (kPersp) {
+            // Both lanes of a point compute the same z.
+            const V z = p * persp + swapped * perspSwapped + m[8];
+            mapped = mapped * skvx::if_then_else(z != 0, 1 / z, V(0));
+        }
+        mapped.store(dst + i);
+    }
+    return i;
+}
+
+/*not static*/ inline void matrix_map_points_affine(const SkScalar m[9], SkPoint dst[],
+                                                    const SkPoint src[], int count) {
+    int mapped = matrix_map_points_n<kMatrixLanes, false>(m, dst, src, count);
+    matrix_map_points_n<1, false>(m, dst + mapped, src + mapped, count - mapped);
+}
+
+/*not static*/ inline void matrix_map_points_persp(const SkScalar m[9], SkPoint dst[],
+                                                   const SkPoint src[], int count) {
+    int mapped = matrix_map_points_n<kMatrixLanes, true>(m, dst, src, count);
+    matrix_map_points_n<1, true>(m, dst + mapped, src + mapped, count - mapped);
+}
+
+// Maps the four corners of N rects at a time, one edge per vector, and writes their bounds. With
+// perspective, the bounds of any rect with a corner at w < minW are set to NaN instead, so that
+// the caller can map those rects again with clipping.
+template <int N, bool kPersp>
+static int matrix_map_rects_n(const SkScalar m[9], float minW,
+                              SkRect dst[], const SkRect src[], int count) {
+    using F = skvx::Vec<N, float>;
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        F l, t, r, b;
+        skvx::strided_load4(&src[i].fLeft, l, t, r, b);
+
+        F xs[4] = {l, r, r, l},
+          ys[4] = {t, t, b, b};
+        [[maybe_unused]] F minZ(std::numeric_limits<float>::infinity());
+        for (int c = 0; c < 4; ++c) {
+            const F x = xs[c] * m[0] + ys[c] * m[1] + m[2],
+                    y = xs[c] * m[3] + ys[c] * m[4] + m[5];
+            if constexpr (kPersp) {
+                const F z = xs[c] * m[6] + ys[c] * m[7] + m[8];
+                const F invZ = skvx::if_then_else(z != 0, 1 / z, F(0));
+                minZ = min(minZ, z);
+                xs[c] = x * invZ;
+                ys[c] = y * invZ;
+            } else {
+                xs[c] = x;
+                ys[c] = y;
+            }
+        }
+
+        F minX = min(min(xs[0], xs[1]), min(xs[2], xs[3])),
+          minY = min(min(ys[0], ys[1]), min(ys[2], ys[3])),
+          maxX = max(max(xs[0], xs[1]), max(xs[2], xs[3])),
+          maxY = max(max(ys[0], ys[1]), max(ys[2], ys[3]));
+        if constexpr (kPersp) {
+            const auto clipped = minZ < minW;
+            const F nan(std::numeric_limits<float>::quiet_NaN());
+            minX = skvx::if_then_else(clipped, nan, minX);
+            minY = skvx::if_then_else(clipped, nan, minY);
+            maxX = skvx::if_then_else(clipped, nan, maxX);
+            maxY = skvx::if_then_else(clipped, nan, maxY);
+        }
+        for (int j = 0; j < N; ++j) {
+            dst[i + j] = {minX[j], minY[j], maxX[j], maxY[j]};
+        }
+    }
+    return i;
+}
+
+/*not static*/ inline void matrix_map_rects_affine(const SkScalar m[9], SkRect dst[],
+                                                   const SkRect src[], int count) {
+    int mapped = matrix_map_rects_n<kMatrixLanes, false>(m, 0, dst, src, count);
+    matrix_map_rects_n<1, false>(m, 0, dst + mapped, src + mapped, count - mapped);
+}
+
+/*not static*/ inline void matrix_map_rects_persp(const SkScalar m[9], float minW, SkRect dst[],
+                                                  const SkRect src[], int count) {
+    int mapped = matrix_map_rects_n<kMatrixLanes, true>(m, minW, dst, src, count);
+    matrix_map_rects_n<1, true>(m, minW, dst + mapped, src + mapped, count - mapped);
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif  // SkMatrix_opts_DEFINED
@@ -8,6 +8,8 @@
 #define SkBitmapKey_DEFINED
 
 #include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
+#include "src/core/SkMD5.h"
 
 #include <cstdint>
 
@@ -20,5 +22,21 @@ struct SkBitmapKey {
     bool operator!=(const SkBitmapKey& rhs) const { return !(*this == rhs); }
 };
 
+/** Identifies an image by what it looks like rather than by its ID: separate SkImages made from
+    the same pixels or the same encoded data have the same SkImageContentKey. */
+struct SkImageContentKey {
+    SkMD5::Digest fDigest;     // of the pixels, or of the encoded data
+    uint64_t fColorSpaceHash;
+    SkISize fSize;
+    uint32_t fColorType;
+    uint32_t fAlphaType;
+    bool operator==(const SkImageContentKey& rhs) const {
+        return fDigest == rhs.fDigest && fColorSpaceHash == rhs.fColorSpaceHash &&
+               fSize == rhs.fSize && fColorType == rhs.fColorType &&
+               fAlphaType == rhs.fAlphaType;
+    }
+    bool operator!=(const SkImageContentKey& rhs) const { return !(*this == rhs); }
+};
+
 
 #endif  // SkBitmapKey_DEFINED
@@ -8,12 +8,23 @@
 #include "src/pdf/SkKeyedImage.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
+
+class SkDiscardableMemory;
 
 SkBitmapKey SkBitmapKeyFromImage(const SkImage* image) {
     if (!image) {
@@ -53,3 +64,109 @@ sk_sp<SkImage> SkKeyedImage::release() {
     fKey = {{0, 0, 0, 0}, 0};
     return image;
 }
+
+namespace {
+// The key is an MD5 digest rather than a fast hash, so that images with the same key can share an
+// XObject without being kept around to compare. Different tags keep an image's pixels from ever
+// matching some other image's encoded data.
+constexpr uint8_t kPixelsTag = 'P';
+constexpr uint8_t kEncodedTag = 'E';
+
+// Pixels are hashed in bands of about this many bytes, each band on its own task. The band size
+// does not depend on the executor, so the hash does not either.
+constexpr size_t kHashBandBytes = 256 * 1024;
+
+SkMD5::Digest hash_pixels(const SkPixmap& pixmap, SkExecutor* executor) {
+    const size_t rowBytes = pixmap.info().minRowBytes();
+    const int rowsPerBand = std::max(1, SkToInt(kHashBandBytes / std::max<size_t>(rowBytes, 1)));
+    const int bandCount = (pixmap.height() + rowsPerBand - 1) / rowsPerBand;
+
+    std::vector<SkMD5::Digest> bandDigests(bandCount);
+    auto hashBand = [&](int band) {
+        const int bottom = std::min(pixmap.height(), (band + 1) * rowsPerBand);
+        SkMD5 md5;
+        for (int y = band * rowsPerBand; y < bottom; ++y) {
+            md5.write(pixmap.addr(0, y), rowBytes);
+        }
+        bandDigests[band] = md5.finish();
+    };
+    if (executor && bandCount > 1) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.batch(bandCount, hashBand);
+        taskGroup.wait();
+    } else {
+        for (int band = 0; band < bandCount; ++band) {
+            hashBand(band);
+        }
+    }
+    SkMD5 md5;
+    md5.write8(kPixelsTag);
+    md5.write(bandDigests.data(), bandDigests.size() * sizeof(SkMD5::Digest));
+    return md5.finish();
+}
+
+// Images are immutable, so the content key of an image (or of a subset of a bitmap) can be
+// cached by its SkBitmapKey for as long as the resource cache cares to keep it.
+static unsigned gImageContentKeyNamespaceLabel;
+
+struct ImageContentCacheKey : public SkResourceCache::Key {
+    ImageContentCacheKey(const SkBitmapKey& key) : fKey(key) {
+        this->init(&gImageContentKeyNamespaceLabel, key.fID, sizeof(fKey));
+    }
+
+    SkBitmapKey fKey;
+};
+
+struct ImageContentRec : public SkResourceCache::Rec {
+    ImageContentRec(const ImageContentCacheKey& key, const SkImageContentKey& contentKey)
+            : fKey(key), fContentKey(contentKey) {}
+
+    ImageContentCacheKey fKey;
+    SkImageContentKey fContentKey;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this); }
+    const char* getCategory() const override { return "pdf-image-content-key"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const ImageContentRec& rec = static_cast<const ImageContentRec&>(baseRec);
+        *static_cast<SkImageContentKey*>(contextData) = rec.fContentKey;
+        return true;
+    }
+};
+}  // namespace
+
+bool SkKeyedImage::contentKey(SkExecutor* executor, SkImageContentKey* contentKey) const {
+    SkASSERT(contentKey);
+    if (!fImage || fImage->isTextureBacked()) {
+        return false;
+    }
+    ImageContentCacheKey cacheKey(fKey);
+    if (SkResourceCache::Find(cacheKey, ImageContentRec::Visitor, contentKey)) {
+        return true;
+    }
+
+    SkMD5::Digest digest;
+    SkPixmap pixmap;
+    if (sk_sp<SkData> encoded = fImage->refEncodedData()) {
+        SkMD5 md5;
+        md5.write8(kEncodedTag);
+        md5.write(encoded->data(), encoded->size());
+        digest = md5.finish();
+    } else if (fImage->peekPixels(&pixmap)) {
+        digest = hash_pixels(pixmap, executor);
+    } else {
+        // Generating the pixels just to hash them would cost about as much as encoding them.
+        return false;
+    }
+
+    SkColorSpace* colorSpace = fImage->colorSpace();
+    *contentKey = {digest,
+                   colorSpace ? colorSpace->hash() : 0,
+                   fImage->dimensions(),
+                   SkToU32(fImage->colorType()),
+                   SkToU32(fImage->alphaType())};
+    SkResourceCache::Add(new ImageContentRec(cacheKey, *contentKey));
+    return true;
+}
@@ -12,6 +12,7 @@
 #include "src/pdf/SkBitmapKey.h"
 
 class SkBitmap;
+class SkExecutor;
 struct SkIRect;
 
 /**
@@ -36,6 +37,13 @@ public:
     sk_sp<SkImage> release();
     SkKeyedImage subset(SkIRect subset) const;
 
+    /**
+     *  Computes the key of the image's contents, hashing large images in bands on 'executor' if
+     *  it is not null. The result is cached, so each image is only hashed once. Returns false for
+     *  images that would need to be generated or read back first; those keep their ID key only.
+     */
+    bool contentKey(SkExecutor* executor, SkImageContentKey*) const;
+
 private:
     sk_sp<SkImage> fImage;
     SkBitmapKey fKey = {{0, 0, 0, 0}, 0};
@@ -1736,8 +1736,20 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
     if (!pdfimagePtr) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
+        // Separate SkImages with the same contents, e.g. the same logo decoded for every page,
+        // are only encoded once.
+        SkImageContentKey contentKey;
+        const bool hasContentKey = imageSubset.contentKey(fDocument->executor(), &contentKey);
+        if (SkPDFIndirectReference* contentPtr =
+                    hasContentKey ? fDocument->fPDFImageContentMap.find(contentKey) : nullptr) {
+            pdfimage = *contentPtr;
+        } else {
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality);
+            if (hasContentKey) {
+                fDocument->fPDFImageContentMap.set(contentKey, pdfimage);
+            }
+        }
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
         fDocument->fPDFBitmapMap.set(key, pdfimage);
     }
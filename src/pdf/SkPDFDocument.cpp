@@ -399,6 +399,7 @@ void SkPDFDocument::onEndPage() {
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
     page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
+    fTagTree.endPage(this, SkToUInt(this->currentPageIndex()));
     fPages.emplace_back(std::move(page));
 }
 
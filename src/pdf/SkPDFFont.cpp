@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDrawable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontMetrics.h"
 #include "include/core/SkFontStyle.h"
@@ -288,6 +289,50 @@ void SkPDFFont::PopulateCommonFontDescriptor(SkPDFDict* descriptor,
 //  Type0Font
 ///////////////////////////////////////////////////////////////////////////////
 
+// Writes the FontFile2 stream for a subsettable font into 'ref': the subset of 'face' to the
+// glyphs in 'glyphUsage', or the original 'fontAsset' if subsetting fails.
+static void serialize_font_file2(const SkTypeface& face,
+                                 const SkPDFGlyphUse& glyphUsage,
+                                 std::unique_ptr<SkStreamAsset> fontAsset,
+                                 SkPDFDocument* doc,
+                                 SkPDFIndirectReference ref) {
+    std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
+    std::unique_ptr<SkStreamAsset> fontFile;
+    if (sk_sp<SkData> subsetFontData = SkPDFSubsetFont(face, glyphUsage)) {
+        tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
+        fontFile = SkMemoryStream::Make(std::move(subsetFontData));
+    } else {
+        tmp->insertInt("Length1", fontAsset->getLength());
+        fontFile = std::move(fontAsset);
+    }
+    SkPDFSerializeStream(std::move(tmp), std::move(fontFile), doc, ref,
+                         SkPDFSteamCompressionEnabled::Yes);
+}
+
+// Subsetting is by far the most expensive part of emitting a font, so like images and streams,
+// it is done on the document's executor (if any) so that fonts are subset in parallel.
+static SkPDFIndirectReference emit_font_file2(const SkPDFFont& font,
+                                              std::unique_ptr<SkStreamAsset> fontAsset,
+                                              SkPDFDocument* doc) {
+    SkPDFIndirectReference ref = doc->reserveRef();
+    if (SkExecutor* executor = doc->executor()) {
+        // The font, and so its glyph usage, outlives the document's jobs.
+        SkTypeface* face = SkRef(font.typeface());
+        const SkPDFGlyphUse* glyphUsage = &font.glyphUsage();
+        SkStreamAsset* fontAssetPtr = fontAsset.release();
+        doc->incrementJobCount();
+        executor->add([face, glyphUsage, fontAssetPtr, doc, ref]() {
+            serialize_font_file2(*face, *glyphUsage, std::unique_ptr<SkStreamAsset>(fontAssetPtr),
+                                 doc, ref);
+            face->unref();
+            doc->signalJobComplete();
+        });
+        return ref;
+    }
+    serialize_font_file2(*font.typeface(), font.glyphUsage(), std::move(fontAsset), doc, ref);
+    return ref;
+}
+
 static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     const SkAdvancedTypefaceMetrics* metricsPtr =
         SkPDFFont::GetMetrics(font.typeface(), doc);
@@ -317,18 +362,9 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(*face, font.glyphUsage());
-                    if (subsetFontData) {
-                        std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                        tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
-                        descriptor->insertRef(
-                                "FontFile2",
-                                SkPDFStreamOut(std::move(tmp),
-                                               SkMemoryStream::Make(std::move(subsetFontData)),
-                                               doc, SkPDFSteamCompressionEnabled::Yes));
-                        break;
-                    }
-                    // If subsetting fails, fall back to original font data.
+                    descriptor->insertRef("FontFile2",
+                                          emit_font_file2(font, std::move(fontAsset), doc));
+                    break;
                 }
                 std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
                 tmp->insertInt("Length1", fontSize);
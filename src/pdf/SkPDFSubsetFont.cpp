@@ -12,14 +12,20 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkResourceCache.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
 #include "hb.h"  // NO_G3_REWRITE
 #include "hb-subset.h"  // NO_G3_REWRITE
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
+
+class SkDiscardableMemory;
 
 namespace {
 
@@ -71,7 +77,7 @@ HBFace make_subset(hb_subset_input_t* input, hb_face_t* face, bool retainZeroGly
     return HBFace(hb_subset_or_fail(face, input));
 }
 
-sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
+sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const std::vector<SkGlyphID>& glyphs) {
     int index = 0;
     std::unique_ptr<SkStreamAsset> typefaceAsset = typeface.openStream(&index);
     HBFace face;
@@ -92,10 +98,14 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
     if (!face || !input) {
         return nullptr;
     }
-    hb_set_t* glyphs = hb_subset_input_glyph_set(input.get());
-    glyphUsage.getSetValues([&glyphs](unsigned gid) { hb_set_add(glyphs, gid);});
+    hb_set_t* hbGlyphs = hb_subset_input_glyph_set(input.get());
+    for (SkGlyphID gid : glyphs) {
+        hb_set_add(hbGlyphs, gid);
+    }
 
-    HBFace subset = make_subset(input.get(), face.get(), glyphUsage.has(0));
+    // The glyphs are sorted, so glyph 0 would be first.
+    const bool retainZeroGlyph = !glyphs.empty() && glyphs.front() == 0;
+    HBFace subset = make_subset(input.get(), face.get(), retainZeroGlyph);
     if (!subset) {
         return nullptr;
     }
@@ -103,10 +113,73 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
     return to_data(std::move(result));
 }
 
+// Documents generated from the same templates subset the same fonts to the same glyphs, so the
+// subset font programs are kept in the resource cache, across documents, keyed by the typeface
+// and a hash of the glyph set. The full glyph set is kept in the record to rule out collisions.
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+struct SubsetFontKey : public SkResourceCache::Key {
+    SubsetFontKey(SkTypefaceID typefaceID, const std::vector<SkGlyphID>& glyphs)
+            : fTypefaceID(typefaceID)
+            , fGlyphCount(SkToU32(glyphs.size()))
+            , fGlyphHash(SkChecksum::Hash32(glyphs.data(), glyphs.size() * sizeof(SkGlyphID))) {
+        this->init(&gSubsetFontKeyNamespaceLabel, typefaceID,
+                   sizeof(fTypefaceID) + sizeof(fGlyphCount) + sizeof(fGlyphHash));
+    }
+
+    SkTypefaceID fTypefaceID;
+    uint32_t     fGlyphCount;
+    uint32_t     fGlyphHash;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SubsetFontKey& key, std::vector<SkGlyphID> glyphs, sk_sp<SkData> data)
+            : fKey(key), fGlyphs(std::move(glyphs)), fData(std::move(data)) {}
+
+    SubsetFontKey          fKey;
+    std::vector<SkGlyphID> fGlyphs;
+    sk_sp<SkData>          fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fGlyphs.size() * sizeof(SkGlyphID) + fData->size();
+    }
+    const char* getCategory() const override { return "pdf-subset-font"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    struct Context {
+        const std::vector<SkGlyphID>* fGlyphs;
+        sk_sp<SkData> fData;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        Context* context = static_cast<Context*>(contextData);
+        if (rec.fGlyphs != *context->fGlyphs) {
+            return false;
+        }
+        context->fData = rec.fData;
+        return true;
+    }
+};
+
 }  // namespace
 
 sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
-    return subset_harfbuzz(typeface, glyphUsage);
+    std::vector<SkGlyphID> glyphs;
+    glyphUsage.getSetValues([&glyphs](unsigned gid) { glyphs.push_back(SkToU16(gid)); });
+
+    SubsetFontKey key(typeface.uniqueID(), glyphs);
+    SubsetFontRec::Context context{&glyphs, nullptr};
+    if (SkResourceCache::Find(key, SubsetFontRec::Visitor, &context)) {
+        return context.fData;
+    }
+
+    sk_sp<SkData> subset = subset_harfbuzz(typeface, glyphs);
+    if (subset) {
+        SkResourceCache::Add(new SubsetFontRec(key, std::move(glyphs), subset));
+    }
+    return subset;
 }
 
 #else
@@ -72,12 +72,16 @@ struct SkPDFTagNode {
     SkPDFTagNode* fChildren = nullptr;
     size_t fChildCount = 0;
     struct MarkedContentInfo {
-        Location fLocation;
+        unsigned fPageIndex;
         int fMarkId;
     };
     TArray<MarkedContentInfo> fMarkedContent;
+    // Only nodes which may contribute to an outline entry keep the location
+    // of each of their marks, parallel to fMarkedContent.
+    TArray<SkPoint> fMarkPoints;
     int fNodeId;
     bool fWantTitle;
+    bool fWantLocation;
     SkString fTypeString;
     SkString fTitle;
     SkString fAlt;
@@ -183,6 +187,7 @@ void SkPDFTagTree::Copy(SkPDF::StructureElementNode& node,
     wantTitle |= fOutline == SkPDF::Metadata::Outline::StructureElementHeaders &&
                  type[0] == 'H' && '1' <= type[1] && type[1] <= '6';
     dst->fWantTitle = wantTitle;
+    dst->fWantLocation = wantTitle;
 
     dst->fTypeString = node.fTypeString;
     dst->fAlt = node.fAlt;
@@ -212,7 +217,7 @@ int SkPDFTagTree::Mark::id() {
 }
 
 SkPoint& SkPDFTagTree::Mark::point() {
-    return fNode->fMarkedContent[fMarkIndex].fLocation.fPoint;
+    return fNode->fWantLocation ? fNode->fMarkPoints[fMarkIndex] : fUnusedPoint;
 }
 
 auto SkPDFTagTree::createMarkIdForNodeId(int nodeId, unsigned pageIndex, SkPoint point) -> Mark {
@@ -225,16 +230,34 @@ auto SkPDFTagTree::createMarkIdForNodeId(int nodeId, unsigned pageIndex, SkPoint
     }
     SkPDFTagNode* tag = *tagPtr;
     SkASSERT(tag);
-    while (SkToUInt(fMarksPerPage.size()) < pageIndex + 1) {
-        fMarksPerPage.push_back();
-    }
-    TArray<SkPDFTagNode*>& pageMarks = fMarksPerPage[pageIndex];
-    int markId = pageMarks.size();
-    tag->fMarkedContent.push_back({{point, pageIndex}, markId});
-    pageMarks.push_back(tag);
+    SkASSERT(fParentTreePageEntries.empty() ||
+             fParentTreePageEntries.back().pageIndex < pageIndex);
+    int markId = fCurrentPageMarks.size();
+    tag->fMarkedContent.push_back({pageIndex, markId});
+    if (tag->fWantLocation) {
+        tag->fMarkPoints.push_back(point);
+    }
+    fCurrentPageMarks.push_back(tag);
     return Mark(tag, tag->fMarkedContent.size() - 1);
 }
 
+void SkPDFTagTree::endPage(SkPDFDocument* doc, unsigned pageIndex) {
+    if (fCurrentPageMarks.empty()) {
+        return;
+    }
+    // The structure elements themselves can't be written until the document
+    // is closed, but their references can be reserved now.
+    SkPDFArray markToTagArray;
+    for (SkPDFTagNode* mark : fCurrentPageMarks) {
+        if (!mark->fRef) {
+            mark->fRef = doc->reserveRef();
+        }
+        markToTagArray.appendRef(mark->fRef);
+    }
+    fParentTreePageEntries.push_back({pageIndex, doc->emit(markToTagArray)});
+    fCurrentPageMarks.clear();
+}
+
 int SkPDFTagTree::createStructParentKeyForNodeId(int nodeId, unsigned pageIndex) {
     if (!fRoot) {
         return -1;
@@ -278,7 +301,9 @@ static bool can_discard(SkPDFTagNode* node) {
 SkPDFIndirectReference SkPDFTagTree::PrepareTagTreeToEmit(SkPDFIndirectReference parent,
                                                           SkPDFTagNode* node,
                                                           SkPDFDocument* doc) {
-    SkPDFIndirectReference ref = doc->reserveRef();
+    // Nodes with marked content already had their reference reserved by endPage().
+    SkPDFIndirectReference ref = node->fRef ? node->fRef : doc->reserveRef();
+    node->fRef = ref;
     std::unique_ptr<SkPDFArray> kids = SkPDFMakeArray();
     SkPDFTagNode* children = node->fChildren;
     size_t childCount = node->fChildCount;
@@ -288,9 +313,19 @@ SkPDFIndirectReference SkPDFTagTree::PrepareTagTreeToEmit(SkPDFIndirectReference
             kids->appendRef(PrepareTagTreeToEmit(ref, child, doc));
         }
     }
+    // Marks on the page of the element's first mark are written as plain
+    // MCIDs, relative to the element's Pg; only the others need an MCR.
+    SkPDFIndirectReference markPage;
+    if (!node->fMarkedContent.empty()) {
+        markPage = doc->getPage(node->fMarkedContent.front().fPageIndex);
+    }
     for (const SkPDFTagNode::MarkedContentInfo& info : node->fMarkedContent) {
+        if (info.fPageIndex == node->fMarkedContent.front().fPageIndex) {
+            kids->appendInt(info.fMarkId);
+            continue;
+        }
         std::unique_ptr<SkPDFDict> mcr = SkPDFMakeDict("MCR");
-        mcr->insertRef("Pg", doc->getPage(info.fLocation.fPageIndex));
+        mcr->insertRef("Pg", doc->getPage(info.fPageIndex));
         mcr->insertInt("MCID", info.fMarkId);
         kids->appendObject(std::move(mcr));
     }
@@ -300,9 +335,11 @@ SkPDFIndirectReference SkPDFTagTree::PrepareTagTreeToEmit(SkPDFIndirectReference
         annotationDict->insertRef("Pg", doc->getPage(annotationInfo.fPageIndex));
         kids->appendObject(std::move(annotationDict));
     }
-    node->fRef = ref;
     SkPDFDict dict("StructElem");
     dict.insertName("S", node->fTypeString.isEmpty() ? "NonStruct" : node->fTypeString.c_str());
+    if (markPage) {
+        dict.insertRef("Pg", markPage);
+    }
     if (!node->fAlt.isEmpty()) {
         dict.insertTextString("Alt", node->fAlt);
     }
@@ -383,17 +420,12 @@ SkPDFIndirectReference SkPDFTagTree::makeStructTreeRoot(SkPDFDocument* doc) {
     SkPDFDict parentTree("ParentTree");
     auto parentTreeNums = SkPDFMakeArray();
 
-    // First, one entry per page.
-    SkASSERT(SkToUInt(fMarksPerPage.size()) <= pageCount);
-    for (int j = 0; j < fMarksPerPage.size(); ++j) {
-        const TArray<SkPDFTagNode*>& pageMarks = fMarksPerPage[j];
-        SkPDFArray markToTagArray;
-        for (SkPDFTagNode* mark : pageMarks) {
-            SkASSERT(mark->fRef);
-            markToTagArray.appendRef(mark->fRef);
-        }
-        parentTreeNums->appendInt(j);
-        parentTreeNums->appendRef(doc->emit(markToTagArray));
+    // First, one entry per page with marks, already written by endPage().
+    SkASSERT(fCurrentPageMarks.empty());
+    for (const ParentTreePageEntry& entry : fParentTreePageEntries) {
+        SkASSERT(entry.pageIndex < pageCount);
+        parentTreeNums->appendInt(SkToInt(entry.pageIndex));
+        parentTreeNums->appendRef(entry.ref);
     }
 
     // Then, one entry per annotation.
@@ -512,9 +544,10 @@ OutlineEntry::Content create_outline_entry_content(SkPDFTagNode* const node) {
     }
 
     // The uppermost/leftmost point on the earliest page of this node's marks.
+    SkASSERT(node->fWantLocation);
     Location markPoint;
-    for (auto&& mark : node->fMarkedContent) {
-        markPoint.accumulate(mark.fLocation);
+    for (int i = 0; i < node->fMarkPoints.size(); ++i) {
+        markPoint.accumulate({node->fMarkPoints[i], node->fMarkedContent[i].fPageIndex});
     }
 
     OutlineEntry::Content content{std::move(text), std::move(markPoint)};
@@ -8,6 +8,8 @@
 #ifndef SkPDFTag_DEFINED
 #define SkPDFTag_DEFINED
 
+#include "include/core/SkPoint.h"
+#include "include/core/SkScalar.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkString.h"
 #include "include/docs/SkPDFDocument.h"
@@ -21,7 +23,6 @@
 
 class SkPDFDocument;
 struct SkPDFTagNode;
-struct SkPoint;
 
 class SkPDFTagTree {
 public:
@@ -32,6 +33,8 @@ public:
     class Mark {
         SkPDFTagNode *const fNode;
         size_t const fMarkIndex;
+        // Where the mark is only matters for outline entries; other marks accumulate here.
+        SkPoint fUnusedPoint = {SK_ScalarNaN, SK_ScalarNaN};
     public:
         Mark(SkPDFTagNode* node, size_t index) : fNode(node), fMarkIndex(index) {}
         Mark() : Mark(nullptr, 0) {}
@@ -52,6 +55,9 @@ public:
     // tree node, via the struct parent tree. Returns -1 if no struct parent
     // key.
     int createStructParentKeyForNodeId(int nodeId, unsigned pageIndex);
+    // Writes out the parent tree entry for the marks on the page that just
+    // ended, so they don't have to be kept until the document is closed.
+    void endPage(SkPDFDocument* doc, unsigned pageIndex);
 
     void addNodeAnnotation(int nodeId, SkPDFIndirectReference annotationRef, unsigned pageIndex);
     void addNodeTitle(int nodeId, SkSpan<const char>);
@@ -66,6 +72,12 @@ private:
         int nodeId;
         SkPDFIndirectReference ref;
     };
+    // An entry in the parent tree mapping a page's marked content IDs to
+    // their structure element nodes, already emitted by endPage().
+    struct ParentTreePageEntry {
+        unsigned pageIndex;
+        SkPDFIndirectReference ref;
+    };
 
     void Copy(SkPDF::StructureElementNode& node,
               SkPDFTagNode* dst,
@@ -80,7 +92,8 @@ private:
     skia_private::THashMap<int, SkPDFTagNode*> fNodeMap;
     SkPDFTagNode* fRoot = nullptr;
     SkPDF::Metadata::Outline fOutline;
-    skia_private::TArray<skia_private::TArray<SkPDFTagNode*>> fMarksPerPage;
+    skia_private::TArray<SkPDFTagNode*> fCurrentPageMarks;
+    std::vector<ParentTreePageEntry> fParentTreePageEntries;
     std::vector<IDTreeEntry> fIdTreeEntries;
     std::vector<int> fParentTreeAnnotationNodeIds;
 
@@ -610,3 +610,11 @@ SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
     serialize_stream(dict.get(), content.get(), compress, doc, ref);
     return ref;
 }
+
+void SkPDFSerializeStream(std::unique_ptr<SkPDFDict> dict,
+                          std::unique_ptr<SkStreamAsset> content,
+                          SkPDFDocument* doc,
+                          SkPDFIndirectReference ref,
+                          SkPDFSteamCompressionEnabled compress) {
+    serialize_stream(dict.get(), content.get(), compress, doc, ref);
+}
@@ -206,4 +206,13 @@ SkPDFIndirectReference SkPDFStreamOut(
     std::unique_ptr<SkStreamAsset> stream,
     SkPDFDocument* doc,
     SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Default);
+
+// Like SkPDFStreamOut(), but compresses and writes the stream on the calling thread, into a 'ref'
+// previously returned by SkPDFDocument::reserveRef(). For work already running on the executor.
+void SkPDFSerializeStream(
+    std::unique_ptr<SkPDFDict> dict,
+    std::unique_ptr<SkStreamAsset> stream,
+    SkPDFDocument* doc,
+    SkPDFIndirectReference ref,
+    SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Default);
 #endif
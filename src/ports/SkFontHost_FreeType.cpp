@@ -1717,17 +1717,45 @@ SkTypeface_FreeType::~SkTypeface_FreeType() {
 // Just made up, so we don't end up storing 1000s of entries
 constexpr int kMaxC2GCacheCount = 512;
 
+// Maps a page of unichars by walking just the mapped characters of that part of the cmap.
+static void fill_glyph_page(FT_Face face, SkUnichar base, SkGlyphID glyphs[]) {
+    constexpr int kPageSize = SkCharToGlyphPages::kPageSize;
+    sk_bzero(glyphs, kPageSize * sizeof(glyphs[0]));
+
+    glyphs[0] = SkToU16(FT_Get_Char_Index(face, base));
+    FT_UInt glyphIndex;
+    FT_ULong charCode = FT_Get_Next_Char(face, base, &glyphIndex);
+    while (glyphIndex && charCode < (FT_ULong)(base + kPageSize)) {
+        glyphs[charCode - base] = SkToU16(glyphIndex);
+        charCode = FT_Get_Next_Char(face, charCode, &glyphIndex);
+    }
+}
+
 void SkTypeface_FreeType::onCharsToGlyphs(const SkUnichar uni[], int count,
                                           SkGlyphID glyphs[]) const {
-    // Try the cache first, *before* accessing freetype lib/face, as that
+    // Try the caches first, *before* accessing freetype lib/face, as that
     // can be very slow. If we do need to compute a new glyphID, then
     // access those freetype objects and continue the loop.
 
-    int i;
+    // Loaded pages of the BMP need no lock at all.
+    int i = 0;
+    while (i < count && fC2GPages.find(uni[i], &glyphs[i])) {
+        ++i;
+    }
+    if (i == count) {
+        return;
+    }
+
     {
         // Optimistically use a shared lock.
         SkAutoSharedMutexShared ama(fC2GCacheMutex);
-        for (i = 0; i < count; ++i) {
+        for (; i < count; ++i) {
+            if (fC2GPages.find(uni[i], &glyphs[i])) {
+                continue;
+            }
+            if (SkCharToGlyphPages::Covers(uni[i])) {
+                break;  // its page needs loading
+            }
             int index = fC2GCache.findGlyphIndex(uni[i]);
             if (index < 0) {
                 break;
@@ -1740,7 +1768,7 @@ void SkTypeface_FreeType::onCharsToGlyphs(const SkUnichar uni[], int count,
         }
     }
 
-    // Need to add more so grab an exclusive lock.
+    // Need to add more so grab an exclusive lock, which also serializes loading pages.
     SkAutoSharedMutexExclusive ama(fC2GCacheMutex);
     AutoFTAccess fta(this);
     FT_Face face = fta.face();
@@ -1751,6 +1779,12 @@ void SkTypeface_FreeType::onCharsToGlyphs(const SkUnichar uni[], int count,
 
     for (; i < count; ++i) {
         SkUnichar c = uni[i];
+        if (SkCharToGlyphPages::Covers(c)) {
+            glyphs[i] = fC2GPages.loadPage(c, [face](SkUnichar base, SkGlyphID pageGlyphs[]) {
+                fill_glyph_page(face, base, pageGlyphs);
+            });
+            continue;
+        }
         int index = fC2GCache.findGlyphIndex(c);
         if (index >= 0) {
             glyphs[i] = SkToU16(index);
@@ -80,6 +80,8 @@ private:
     mutable SkOnce fFTFaceOnce;
     mutable std::unique_ptr<FaceRec> fFaceRec;
 
+    // BMP unichars are mapped in whole pages, read without locking. The rest use fC2GCache.
+    mutable SkCharToGlyphPages fC2GPages;
     mutable SkSharedMutex fC2GCacheMutex;
     mutable SkCharToGlyphCache fC2GCache;
 
@@ -127,3 +127,9 @@ void SkCharToGlyphCache::insertCharAndGlyph(int index, SkUnichar unichar, SkGlyp
     }
 #endif
 }
+
+SkCharToGlyphPages::~SkCharToGlyphPages() {
+    for (std::atomic<const Page*>& page : fPages) {
+        delete page.load(std::memory_order_relaxed);
+    }
+}
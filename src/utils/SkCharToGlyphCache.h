@@ -12,6 +12,7 @@
 #include "include/private/base/SkTDArray.h"
 #include "include/private/base/SkTo.h"
 
+#include <atomic>
 #include <cstdint>
 
 class SkCharToGlyphCache {
@@ -62,4 +63,72 @@ private:
     double               fDenom;
 };
 
+/**
+ *  A direct-mapped table of the Basic Multilingual Plane, split into pages of 256 unichars.
+ *  Each page is filled in all at once, from a walk over that part of the cmap, and once
+ *  published is never changed, so lookups need no lock.
+ *
+ *  SkGlyphID glyph;
+ *  if (!pages.find(unichar, &glyph) && SkCharToGlyphPages::Covers(unichar)) {
+ *      // with loads serialized by the caller
+ *      glyph = pages.loadPage(unichar, [&](SkUnichar base, SkGlyphID glyphs[]) {
+ *          fill_glyphs_for_unichars_base_to_base_plus_255(base, glyphs);
+ *      });
+ *  }
+ */
+class SkCharToGlyphPages {
+public:
+    static constexpr int kPageBits = 8;
+    static constexpr int kPageSize = 1 << kPageBits;
+    static constexpr int kPageCount = 0x10000 >> kPageBits;
+
+    SkCharToGlyphPages() = default;
+    SkCharToGlyphPages(const SkCharToGlyphPages&) = delete;
+    SkCharToGlyphPages& operator=(const SkCharToGlyphPages&) = delete;
+    ~SkCharToGlyphPages();
+
+    // Is this unichar in the BMP, and so in one of our pages?
+    static bool Covers(SkUnichar c) {
+        return (uint32_t)c < 0x10000;
+    }
+
+    // Safe to call from any thread, at any time. Returns false if the unichar is outside the BMP
+    // or its page hasn't been loaded yet.
+    bool find(SkUnichar c, SkGlyphID* glyph) const {
+        if (!Covers(c)) {
+            return false;
+        }
+        const Page* page = fPages[c >> kPageBits].load(std::memory_order_acquire);
+        if (!page) {
+            return false;
+        }
+        *glyph = page->fGlyphs[c & (kPageSize - 1)];
+        return true;
+    }
+
+    // Loads the page holding c, which must be in the BMP, by calling fill(base, glyphs) to map
+    // the kPageSize unichars starting at base. Returns c's glyph. Calls to loadPage() must be
+    // serialized with each other, but not with find().
+    template <typename Fill>
+    SkGlyphID loadPage(SkUnichar c, Fill&& fill) {
+        SkASSERT(Covers(c));
+        std::atomic<const Page*>& slot = fPages[c >> kPageBits];
+        const Page* page = slot.load(std::memory_order_relaxed);
+        if (!page) {
+            Page* newPage = new Page;
+            fill(c & ~(kPageSize - 1), newPage->fGlyphs);
+            slot.store(newPage, std::memory_order_release);
+            page = newPage;
+        }
+        return page->fGlyphs[c & (kPageSize - 1)];
+    }
+
+private:
+    struct Page {
+        SkGlyphID fGlyphs[kPageSize];
+    };
+
+    std::atomic<const Page*> fPages[kPageCount] = {};
+};
+
 #endif
@@ -403,3 +403,11 @@ void SkNWayCanvas::onDrawEdgeAAImageSet2(const ImageSetEntry set[], int count,
                 set, count, dstClips, preViewMatrices, sampling, paint, constraint);
     }
 }
+
+void SkNWayCanvas::onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[], int count,
+                                  const SkMatrix preViewMatrices[], const SkPaint& paint) {
+    Iter iter(fList);
+    while (iter.next()) {
+        iter->experimental_DrawRRectSet(rrects, colors, count, preViewMatrices, paint);
+    }
+}
@@ -267,6 +267,15 @@ void SkPaintFilterCanvas::onDrawEdgeAAImageSet2(const ImageSetEntry set[], int c
     }
 }
 
+void SkPaintFilterCanvas::onDrawRRectSet(const SkRRect rrects[], const SkColor4f colors[],
+                                         int count, const SkMatrix preViewMatrices[],
+                                         const SkPaint& paint) {
+    AutoPaintFilter apf(this, paint);
+    if (apf.shouldDraw()) {
+        this->SkNWayCanvas::onDrawRRectSet(rrects, colors, count, preViewMatrices, apf.paint());
+    }
+}
+
 sk_sp<SkSurface> SkPaintFilterCanvas::onNewSurface(const SkImageInfo& info,
                                                    const SkSurfaceProps& props) {
     return this->proxy()->makeSurface(info, &props);
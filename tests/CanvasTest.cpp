@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkDocument.h"
@@ -30,6 +31,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTypes.h"
 #include "include/core/SkVertices.h"
 #include "include/effects/SkImageFilters.h"
@@ -733,6 +735,105 @@ DEF_TEST(canvas_savelayer_destructor, reporter) {
     check_pixels(SK_ColorRED);
 }
 
+// Raster layers without filters aren't allocated until something draws into them. The canvas
+// should report the same clip and layer state, and render the same, as if they were allocated.
+DEF_TEST(Canvas_saveLayer_deferred, reporter) {
+    auto surf = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(8, 8));
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    // A layer that is never drawn to leaves the canvas untouched, but still has pixels to access.
+    const SkRect layerBounds = SkRect::MakeLTRB(2, 2, 6, 6);
+    canvas->saveLayer(&layerBounds, nullptr);
+    REPORTER_ASSERT(reporter, canvas->getDeviceClipBounds() == SkIRect::MakeLTRB(2, 2, 6, 6));
+    SkImageInfo info;
+    SkIPoint origin;
+    REPORTER_ASSERT(reporter, canvas->accessTopLayerPixels(&info, nullptr, &origin));
+    REPORTER_ASSERT(reporter, info.dimensions() == SkISize::Make(4, 4));
+    REPORTER_ASSERT(reporter, origin == SkIPoint::Make(2, 2));
+    canvas->restore();
+    REPORTER_ASSERT(reporter, canvas->getDeviceClipBounds() == SkIRect::MakeWH(8, 8));
+
+    // Clips applied before the first draw restrict the layer, and are undone by the restore.
+    SkPaint layerPaint;
+    layerPaint.setAlphaf(0.5f);
+    canvas->saveLayer(&layerBounds, &layerPaint);
+    canvas->clipRect(SkRect::MakeLTRB(3, 3, 8, 8));
+    REPORTER_ASSERT(reporter, canvas->getDeviceClipBounds() == SkIRect::MakeLTRB(3, 3, 6, 6));
+    canvas->translate(1, 1);
+    canvas->drawColor(SK_ColorRED);
+    REPORTER_ASSERT(reporter, canvas->getDeviceClipBounds() == SkIRect::MakeLTRB(3, 3, 6, 6));
+    canvas->restore();
+    REPORTER_ASSERT(reporter, canvas->getDeviceClipBounds() == SkIRect::MakeWH(8, 8));
+    REPORTER_ASSERT(reporter, canvas->getTotalMatrix().isIdentity());
+
+    SkBitmap bm;
+    bm.allocN32Pixels(8, 8);
+    REPORTER_ASSERT(reporter, surf->readPixels(bm, 0, 0));
+    REPORTER_ASSERT(reporter, bm.getColor(2, 2) == SK_ColorWHITE);
+    REPORTER_ASSERT(reporter, bm.getColor(6, 6) == SK_ColorWHITE);
+    const SkColor blended = bm.getColor(4, 4);
+    REPORTER_ASSERT(reporter, SkColorGetR(blended) == 0xFF);
+    REPORTER_ASSERT(reporter, SkColorGetG(blended) >= 0x7E && SkColorGetG(blended) <= 0x81);
+}
+
+// A layer that is never drawn to is never restored either, so only layers whose restore would
+// leave the prior device unchanged can be deferred. Layers restored with kClear, kDstIn, or a color
+// filter that affects transparent black must render the same as when they're allocated eagerly.
+DEF_TEST(Canvas_saveLayer_deferredEmptyRestore, reporter) {
+    SkPaint srcOver;
+    srcOver.setAlphaf(0.5f);
+    SkPaint clear;
+    clear.setBlendMode(SkBlendMode::kClear);
+    SkPaint dstIn;
+    dstIn.setBlendMode(SkBlendMode::kDstIn);
+    SkPaint colorFilter;
+    colorFilter.setColorFilter(SkColorFilters::Blend(SK_ColorBLUE, SkBlendMode::kSrcOver));
+    const struct {
+        const char* fName;
+        SkPaint     fPaint;
+        SkColor     fExpectedInLayer;
+    } kCases[] = {
+        {"src-over",     srcOver,     SK_ColorWHITE},
+        {"clear",        clear,       SK_ColorTRANSPARENT},
+        {"dst-in",       dstIn,       SK_ColorTRANSPARENT},
+        {"color filter", colorFilter, SK_ColorBLUE},
+    };
+
+    const SkRect layerBounds = SkRect::MakeLTRB(2, 2, 6, 6);
+    auto render = [&](const SkPaint& layerPaint, SkPixelGeometry geometry) {
+        // These layers don't preserve LCD text, so they're never deferred on a surface that has a
+        // pixel geometry.
+        const SkSurfaceProps props(0, geometry);
+        auto surf = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(8, 8), &props);
+        SkCanvas* canvas = surf->getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        canvas->saveLayer(&layerBounds, &layerPaint);
+        // A culled draw leaves the layer empty.
+        canvas->drawRect(SkRect::MakeLTRB(20, 20, 30, 30), SkPaint());
+        canvas->restore();
+
+        SkBitmap bm;
+        bm.allocN32Pixels(8, 8);
+        REPORTER_ASSERT(reporter, surf->readPixels(bm, 0, 0));
+        return bm;
+    };
+
+    for (const auto& c : kCases) {
+        SkBitmap eager = render(c.fPaint, kRGB_H_SkPixelGeometry);
+        SkBitmap deferrable = render(c.fPaint, kUnknown_SkPixelGeometry);
+        for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                REPORTER_ASSERT(reporter, eager.getColor(x, y) == deferrable.getColor(x, y),
+                                "%s: (%d, %d) is %08x eagerly, %08x deferred", c.fName, x, y,
+                                eager.getColor(x, y), deferrable.getColor(x, y));
+            }
+        }
+        REPORTER_ASSERT(reporter, deferrable.getColor(3, 3) == c.fExpectedInLayer,
+                        "%s: %08x", c.fName, deferrable.getColor(3, 3));
+    }
+}
+
 DEF_TEST(Canvas_saveLayer_colorSpace, reporter) {
     SkColor pixels[1];
     const SkImageInfo info = SkImageInfo::MakeN32(1, 1, kOpaque_SkAlphaType);
@@ -838,6 +838,75 @@ static void test_is_rrect_deep_rect_stack(skiatest::Reporter* reporter) {
     SkRRect rrect;
     bool isAA;
     REPORTER_ASSERT(reporter, !stack.isRRect(kTargetBounds, &rrect, &isAA));
+
+    // An rrect inside a deep stack of clips that all contain it is still found, no matter how deep
+    // the stack is.
+    SkClipStack deepStack;
+    for (int i = 0; i <= 100; ++i) {
+        deepStack.save();
+        deepStack.clipRect(SkRect::MakeLTRB(i, i + 0.5f, kTargetBounds.width() - i,
+                                            kTargetBounds.height() - i),
+                           SkMatrix::I(), SkClipOp::kIntersect, i & 0b1);
+    }
+    const SkRRect inner = SkRRect::MakeRectXY(SkRect::MakeLTRB(200, 200, 300, 300), 10, 10);
+    deepStack.save();
+    deepStack.clipRRect(inner, SkMatrix::I(), SkClipOp::kIntersect, true);
+    if (deepStack.isRRect(kTargetBounds, &rrect, &isAA)) {
+        REPORTER_ASSERT(reporter, rrect == inner);
+        REPORTER_ASSERT(reporter, isAA);
+    } else {
+        ERRORF(reporter, "Expected a deep stack ending in a contained rrect to be an rrect.");
+    }
+}
+
+// The clip stack keeps an anti-aliasing flag and an interior rect for the elements below each
+// one, so that queries don't walk the stack. Check them against walking it.
+static void test_cached_summary(skiatest::Reporter* reporter) {
+    static constexpr SkIRect kBounds = SkIRect::MakeWH(400, 400);
+    const SkRect kInside = SkRect::MakeLTRB(150, 150, 250, 250);
+
+    SkClipStack stack;
+    for (int i = 0; i < 60; ++i) {
+        stack.save();
+        const SkRect r = SkRect::MakeLTRB(i, i, 400 - i, 400 - i);
+        switch (i % 4) {
+            case 0: stack.clipRect(r, SkMatrix::I(), SkClipOp::kIntersect, false); break;
+            case 1: stack.clipRRect(SkRRect::MakeRectXY(r, 10, 10), SkMatrix::I(),
+                                    SkClipOp::kIntersect, false); break;
+            case 2: stack.clipRect(r.makeInset(0.5f, 0.5f), SkMatrix::I(),
+                                   SkClipOp::kIntersect, i == 30); break;
+            case 3: stack.clipRect(r, SkMatrix::Translate(0.25f, 0), SkClipOp::kIntersect,
+                                   false); break;
+        }
+
+        bool anyAA = false;
+        SkClipStack::B2TIter iter(stack);
+        while (const SkClipStack::Element* element = iter.next()) {
+            anyAA |= element->isAA();
+        }
+        REPORTER_ASSERT(reporter, stack.isAnyAA() == anyAA, "depth %d", i);
+
+        // Everything here is an intersection, so the middle stays inside and corners don't.
+        REPORTER_ASSERT(reporter, stack.quickContains(kInside), "depth %d", i);
+        REPORTER_ASSERT(reporter, i == 0 || !stack.quickContains(SkRect::Make(kBounds)),
+                        "depth %d", i);
+    }
+
+    // A difference means nothing is known to be inside without looking at it.
+    stack.clipRect(SkRect::MakeLTRB(190, 190, 210, 210), SkMatrix::I(), SkClipOp::kDifference,
+                   false);
+    REPORTER_ASSERT(reporter, !stack.quickContains(kInside));
+    SkRegion region;
+    set_region_to_stack(stack, kBounds, &region);
+    REPORTER_ASSERT(reporter, !region.contains(kInside.round()));
+
+    // Popping back to the start restores the summary of the lower elements.
+    stack.restore();
+    REPORTER_ASSERT(reporter, stack.quickContains(kInside));
+    while (stack.getSaveCount() > 30) {
+        stack.restore();
+    }
+    REPORTER_ASSERT(reporter, !stack.isAnyAA());
 }
 
 DEF_TEST(ClipStack, reporter) {
@@ -887,4 +956,5 @@ DEF_TEST(ClipStack, reporter) {
     test_quickContains(reporter);
     test_invfill_diff_bug(reporter);
     test_is_rrect_deep_rect_stack(reporter);
+    test_cached_summary(reporter);
 }
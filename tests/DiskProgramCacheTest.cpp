@@ -0,0 +1,292 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/core/SkTypes.h"
+#include "include/gpu/GrContextOptions.h"
+#include "include/gpu/GrDirectContext.h"
+#include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/gpu/GrTypes.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/gpu/ganesh/GrPersistentCacheUtils.h"
+#include "src/sksl/ir/SkSLProgram.h"
+#include "src/utils/SkOSPath.h"
+#include "tests/Test.h"
+#include "tools/gpu/DiskProgramCache.h"
+#include "tools/gpu/ContextType.h"
+#include "tools/gpu/GrContextFactory.h"
+
+#include <climits>
+#include <string>
+
+using sk_gpu_test::DiskProgramCache;
+
+static SkString make_cache_dir(const char* name) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return tmpDir;
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), name);
+    // Start from an empty cache.
+    SkString index = SkOSPath::Join(dir.c_str(), "index.skpc");
+    remove(index.c_str());
+    return dir;
+}
+
+static sk_sp<SkData> make_key(int i) {
+    std::string key = "program key " + std::to_string(i);
+    return SkData::MakeWithCopy(key.data(), key.size());
+}
+
+// Packs SkSL the same way GrGLProgramBuilder does for ShaderCacheStrategy::kSkSL.
+static sk_sp<SkData> make_sksl_program(int variant) {
+    std::string shaders[kGrShaderTypeCount];
+    shaders[kVertex_GrShaderType] = "in float2 position; void main() { sk_Position = "
+                                    "position.xy01; }";
+    shaders[kFragment_GrShaderType] = "uniform half4 color; void main() { sk_FragColor = color * "
+                                      "half(" + std::to_string(variant) + "); }";
+    SkSL::Program::Interface interfaces[kGrShaderTypeCount] = {};
+    return GrPersistentCacheUtils::PackCachedShaders(SkSetFourByteTag('S', 'K', 'S', 'L'),
+                                                     shaders, interfaces, kGrShaderTypeCount);
+}
+
+DEF_TEST(DiskProgramCache_Compression, r) {
+    std::string text;
+    for (int i = 0; text.size() < 5000; ++i) {
+        text += "half4 color" + std::to_string(i % 13) + " = sample(image, coords);\n";
+    }
+    for (size_t size : {size_t(0), size_t(3), size_t(17), size_t(300), text.size()}) {
+        sk_sp<SkData> compressed = DiskProgramCache::Compress(text.data(), size);
+        sk_sp<SkData> decompressed =
+                DiskProgramCache::Decompress(compressed->data(), compressed->size());
+        REPORTER_ASSERT(r, decompressed && decompressed->size() == size &&
+                           !memcmp(decompressed->data(), text.data(), size), "size %zu", size);
+        if (size == text.size()) {
+            REPORTER_ASSERT(r, compressed->size() < size / 4, "%zu -> %zu",
+                            size, compressed->size());
+        }
+
+        // Truncated blocks must be rejected rather than read out of bounds.
+        if (compressed->size() > 5) {
+            REPORTER_ASSERT(r, !DiskProgramCache::Decompress(compressed->data(),
+                                                             compressed->size() - 1));
+        }
+    }
+}
+
+DEF_TEST(DiskProgramCache_Persists, r) {
+    SkString dir = make_cache_dir("disk_program_cache");
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    constexpr int kPrograms = 40;
+    constexpr int kVariants = 8; // so that several keys share each program blob
+    {
+        DiskProgramCache cache(dir.c_str());
+        for (int i = 0; i < kPrograms; ++i) {
+            cache.store(*make_key(i), *make_sksl_program(i % kVariants), SkString("test"));
+        }
+        // Make the programs with higher indices hotter.
+        for (int i = 0; i < kPrograms; ++i) {
+            for (int load = 0; load < i; ++load) {
+                REPORTER_ASSERT(r, cache.load(*make_key(i)));
+            }
+        }
+        DiskProgramCache::Stats stats = cache.stats();
+        REPORTER_ASSERT(r, stats.fEntries == kPrograms);
+        REPORTER_ASSERT(r, stats.fBlobs == kVariants);
+        REPORTER_ASSERT(r, stats.fDiskBytes < stats.fDataBytes);
+        REPORTER_ASSERT(r, cache.flush());
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(1);
+    DiskProgramCache cache(dir.c_str(), executor.get());
+    cache.waitForPrefetch();
+
+    // The reopened cache ranks entries by how often they were loaded.
+    int lastHitCount = INT_MAX;
+    cache.foreach([&](sk_sp<const SkData>, sk_sp<SkData> data, const SkString&, int hitCount) {
+        REPORTER_ASSERT(r, data);
+        REPORTER_ASSERT(r, hitCount <= lastHitCount);
+        lastHitCount = hitCount;
+    });
+
+    for (int i = 0; i < kPrograms; ++i) {
+        sk_sp<SkData> data = cache.load(*make_key(i));
+        if (!data) {
+            ERRORF(r, "program %d was not persisted", i);
+            continue;
+        }
+        std::string expected[kGrShaderTypeCount], actual[kGrShaderTypeCount];
+        SkSL::Program::Interface interfaces[kGrShaderTypeCount];
+        sk_sp<SkData> original = make_sksl_program(i % kVariants);
+        SkReadBuffer expectedReader(original->data(), original->size());
+        SkReadBuffer actualReader(data->data(), data->size());
+        REPORTER_ASSERT(r, GrPersistentCacheUtils::GetType(&actualReader) ==
+                           GrPersistentCacheUtils::GetType(&expectedReader));
+        GrPersistentCacheUtils::UnpackCachedShaders(&expectedReader, expected, interfaces,
+                                                    kGrShaderTypeCount);
+        REPORTER_ASSERT(r, GrPersistentCacheUtils::UnpackCachedShaders(&actualReader, actual,
+                                                                       interfaces,
+                                                                       kGrShaderTypeCount));
+        REPORTER_ASSERT(r, actual[kFragment_GrShaderType] == expected[kFragment_GrShaderType]);
+    }
+    REPORTER_ASSERT(r, !cache.load(*make_key(kPrograms)));
+
+    DiskProgramCache::Stats stats = cache.stats();
+    REPORTER_ASSERT(r, stats.fMisses == 1);
+    REPORTER_ASSERT(r, stats.fDiskLoads == 0, "prefetch should have loaded every program");
+    INFOF(r, "%d programs in %d blobs (%zu -> %zu bytes): index %.2fms, prefetch %.2fms\n",
+          stats.fEntries, stats.fBlobs, stats.fDataBytes, stats.fDiskBytes, stats.fIndexLoadMs,
+          stats.fPrefetchMs);
+}
+
+static SkString blob_path(const SkString& dir, const SkData& program) {
+    SkMD5 md5;
+    md5.write(program.data(), program.size());
+    SkString name = md5.finish().toLowercaseHexString();
+    name.append(".skpc");
+    return SkOSPath::Join(dir.c_str(), name.c_str());
+}
+
+static void write_file(const SkString& path, const char* contents) {
+    SkFILEWStream out(path.c_str());
+    out.writeText(contents);
+}
+
+// A blob that can't be read must be written again when its program is stored, rather than left
+// broken because the cache thinks it already has it.
+DEF_TEST(DiskProgramCache_RewritesBadBlobs, r) {
+    SkString dir = make_cache_dir("disk_program_cache_bad_blob");
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    sk_sp<SkData> key = make_key(0);
+    sk_sp<SkData> program = make_sksl_program(0);
+    {
+        DiskProgramCache cache(dir.c_str());
+        cache.store(*key, *program, SkString("test"));
+        REPORTER_ASSERT(r, cache.flush());
+    }
+    write_file(blob_path(dir, *program), "not a compressed program");
+    {
+        DiskProgramCache cache(dir.c_str());
+        REPORTER_ASSERT(r, !cache.load(*key));
+        REPORTER_ASSERT(r, cache.stats().fBlobs == 0);
+        cache.store(*key, *program, SkString("test"));
+        REPORTER_ASSERT(r, cache.stats().fBlobs == 1);
+    }
+    DiskProgramCache cache(dir.c_str());
+    sk_sp<SkData> data = cache.load(*key);
+    REPORTER_ASSERT(r, data && data->equals(program.get()));
+}
+
+// Blobs that no entry refers to, whether replaced by a later store or left by an earlier run, are
+// deleted and not counted.
+DEF_TEST(DiskProgramCache_PrunesBlobs, r) {
+    SkString dir = make_cache_dir("disk_program_cache_prune");
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    sk_sp<SkData> key = make_key(0);
+    sk_sp<SkData> oldProgram = make_sksl_program(0);
+    sk_sp<SkData> newProgram = make_sksl_program(1);
+    {
+        DiskProgramCache cache(dir.c_str());
+        cache.store(*key, *oldProgram, SkString("test"));
+        cache.store(*make_key(1), *oldProgram, SkString("test"));
+        cache.store(*key, *newProgram, SkString("test"));
+        // The old blob is still used by the second key.
+        REPORTER_ASSERT(r, cache.stats().fBlobs == 2);
+        REPORTER_ASSERT(r, sk_exists(blob_path(dir, *oldProgram).c_str()));
+
+        cache.store(*make_key(1), *newProgram, SkString("test"));
+        REPORTER_ASSERT(r, cache.stats().fBlobs == 1);
+        REPORTER_ASSERT(r, !sk_exists(blob_path(dir, *oldProgram).c_str()));
+        REPORTER_ASSERT(r, sk_exists(blob_path(dir, *newProgram).c_str()));
+    }
+
+    SkString orphan = SkOSPath::Join(dir.c_str(), "0123456789abcdef0123456789abcdef.skpc");
+    SkString temp = SkOSPath::Join(dir.c_str(), "index.skpc.tmp");
+    write_file(orphan, "orphan");
+    write_file(temp, "partial index");
+    DiskProgramCache cache(dir.c_str());
+    REPORTER_ASSERT(r, !sk_exists(orphan.c_str()));
+    REPORTER_ASSERT(r, !sk_exists(temp.c_str()));
+    REPORTER_ASSERT(r, sk_exists(blob_path(dir, *newProgram).c_str()));
+    REPORTER_ASSERT(r, cache.stats().fBlobs == 1);
+    REPORTER_ASSERT(r, cache.load(*key) && cache.load(*make_key(1)));
+}
+
+static void draw_programs(GrDirectContext* dContext) {
+    sk_sp<SkSurface> surface = SkSurfaces::RenderTarget(
+            dContext, skgpu::Budgeted::kNo, SkImageInfo::MakeN32Premul(64, 64));
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paint;
+    canvas->drawRect(SkRect::MakeWH(32, 32), paint);
+    paint.setAntiAlias(true);
+    canvas->drawCircle(32, 32, 16, paint);
+    paint.setShader(SkShaders::Color(SkColors::kBlue, nullptr));
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(40, 40), 5, 5), paint);
+    dContext->flushAndSubmit(GrSyncCpu::kYes);
+}
+
+// Runs each GL-family context (GL, GLES and the ANGLE variants) against the cache twice. The
+// second context, like a second run of an app, must find every program it needs on disk. The mock
+// context never consults the persistent cache, so only the GL backend (which caches SkSL with
+// ShaderCacheStrategy::kSkSL) is exercised here.
+DEF_GANESH_TEST(DiskProgramCache_GL, r, originalOptions, CtsEnforcement::kNever) {
+    for (int i = 0; i < skgpu::kContextTypeCount; ++i) {
+        skgpu::ContextType contextType = static_cast<skgpu::ContextType>(i);
+        if (skgpu::ganesh::ContextTypeBackend(contextType) != GrBackendApi::kOpenGL) {
+            continue;
+        }
+        SkString dir = make_cache_dir(SkStringPrintf("disk_program_cache_gl_%d", i).c_str());
+        if (dir.isEmpty()) {
+            return;
+        }
+
+        for (int run = 0; run < 2; ++run) {
+            DiskProgramCache cache(dir.c_str());
+            GrContextOptions options = originalOptions;
+            options.fPersistentCache = &cache;
+            options.fShaderCacheStrategy = GrContextOptions::ShaderCacheStrategy::kSkSL;
+
+            sk_gpu_test::GrContextFactory factory(options);
+            GrDirectContext* dContext = factory.get(contextType);
+            if (!dContext) {
+                break;
+            }
+            draw_programs(dContext);
+
+            DiskProgramCache::Stats stats = cache.stats();
+            if (run == 0) {
+                REPORTER_ASSERT(r, stats.fStores > 0, "%s", skgpu::ContextTypeName(contextType));
+            } else {
+                REPORTER_ASSERT(r, stats.fMisses == 0 && stats.fStores == 0,
+                                "%s: misses %d, stores %d", skgpu::ContextTypeName(contextType),
+                                stats.fMisses, stats.fStores);
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTypes.h"
+#include "src/core/SkDistanceFieldGen.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if !defined(SK_DISABLE_SDF_TEXT)
+
+static constexpr int kSize = 20;
+static constexpr int kPadded = kSize + 2 * SK_DistanceFieldPad;
+
+// A solid square covering [lo, hi) in both directions, hard-edged.
+static void make_square(uint8_t image[kSize * kSize], int lo, int hi) {
+    memset(image, 0, kSize * kSize);
+    for (int y = lo; y < hi; ++y) {
+        memset(image + y * kSize + lo, 0xff, hi - lo);
+    }
+}
+
+// The field should hold the exact Euclidean distance to the square, clamped to the magnitude.
+DEF_TEST(DistanceFieldGen_Square, r) {
+    constexpr int kLo = 5, kHi = 15;
+    uint8_t image[kSize * kSize];
+    make_square(image, kLo, kHi);
+
+    uint8_t field[kPadded * kPadded];
+    REPORTER_ASSERT(r, SkGenerateDistanceFieldFromA8Image(field, image, kSize, kSize, kSize));
+
+    for (int y = 0; y < kPadded; ++y) {
+        for (int x = 0; x < kPadded; ++x) {
+            const float px = x - SK_DistanceFieldPad + 0.5f,
+                        py = y - SK_DistanceFieldPad + 0.5f;
+            const float dx = std::max({kLo - px, 0.f, px - kHi}),
+                        dy = std::max({kLo - py, 0.f, py - kHi});
+            float expected = dx > 0 || dy > 0
+                    ? -std::sqrt(dx * dx + dy * dy)
+                    : std::min({px - kLo, kHi - px, py - kLo, kHi - py});
+            expected = std::clamp(expected, -(float)SK_DistanceFieldMagnitude,
+                                             (float)SK_DistanceFieldMagnitude);
+
+            // Zero distance is stored at 128, with 128 steps per SK_DistanceFieldMagnitude.
+            const float actual = (field[y * kPadded + x] - 128) * SK_DistanceFieldMagnitude / 128.f;
+            REPORTER_ASSERT(r, std::fabs(actual - expected) < 0.25f,
+                            "(%d, %d): expected %g, got %g", x, y, expected, actual);
+        }
+    }
+}
+
+#endif // !defined(SK_DISABLE_SDF_TEXT)
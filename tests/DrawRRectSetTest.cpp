@@ -0,0 +1,191 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlurTypes.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/base/SkRandom.h"
+#include "tests/Test.h"
+
+#include <functional>
+#include <vector>
+
+namespace {
+
+constexpr int kSize = 128;
+
+// A mix of rects, ovals, circles and rrects, with some overlapping and some outside the canvas.
+struct RRectSet {
+    std::vector<SkRRect> fRRects;
+    std::vector<SkColor4f> fColors;
+    std::vector<SkMatrix> fMatrices;
+
+    RRectSet() {
+        SkRandom random;
+        const SkColor4f kSeries[] = {{1, 0, 0, 1}, {0, 0.5f, 1, 0.75f}, {0.2f, 0.8f, 0.2f, 0.5f}};
+        for (int i = 0; i < 60; ++i) {
+            SkRect r = SkRect::MakeXYWH(random.nextRangeF(-10, kSize),
+                                        random.nextRangeF(-10, kSize),
+                                        random.nextRangeF(0.5f, 30),
+                                        random.nextRangeF(0.5f, 30));
+            switch (i % 4) {
+                case 0:  fRRects.push_back(SkRRect::MakeRect(r));                             break;
+                case 1:  fRRects.push_back(SkRRect::MakeOval(r));                             break;
+                case 2:  fRRects.push_back(SkRRect::MakeOval(SkRect::MakeXYWH(
+                                 r.fLeft, r.fTop, r.width(), r.width())));                    break;
+                default: fRRects.push_back(SkRRect::MakeRectXY(r, r.width() / 4, r.height() / 3));
+            }
+            // Runs of the same color, as in a chart with several series.
+            fColors.push_back(kSeries[(i / 7) % std::size(kSeries)]);
+            SkMatrix m = SkMatrix::RotateDeg(random.nextRangeF(-30, 30), r.center());
+            m.preScale(random.nextRangeF(0.5f, 1.5f), 1, r.fLeft, r.fTop);
+            fMatrices.push_back(m);
+        }
+    }
+
+    int count() const { return static_cast<int>(fRRects.size()); }
+    const SkMatrix* matrices(bool useMatrices) const {
+        return useMatrices ? fMatrices.data() : nullptr;
+    }
+
+    void drawBatched(SkCanvas* canvas, const SkPaint& paint, bool useMatrices) const {
+        canvas->experimental_DrawRRectSet(fRRects.data(), fColors.data(), this->count(),
+                                          this->matrices(useMatrices), paint);
+    }
+
+    void drawEachEntry(SkCanvas* canvas, const SkPaint& paint, bool useMatrices) const {
+        SkPaint entryPaint = paint;
+        for (int i = 0; i < this->count(); ++i) {
+            entryPaint.setColor4f(fColors[i]);
+            canvas->save();
+            if (useMatrices) {
+                canvas->concat(fMatrices[i]);
+            }
+            canvas->drawRRect(fRRects[i], entryPaint);
+            canvas->restore();
+        }
+    }
+};
+
+SkBitmap draw(const std::function<void(SkCanvas*)>& drawFn) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kSize, kSize);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.translate(3.5f, -2.25f);
+    canvas.scale(1.25f, 1.1f);
+    drawFn(&canvas);
+    return bitmap;
+}
+
+bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            if (a.getColor(x, y) != b.getColor(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<std::pair<const char*, SkPaint>> test_paints() {
+    std::vector<std::pair<const char*, SkPaint>> paints;
+
+    SkPaint fill;
+    paints.push_back({"fill", fill});
+
+    SkPaint aaFill;
+    aaFill.setAntiAlias(true);
+    paints.push_back({"aa fill", aaFill});
+
+    SkPaint stroke = aaFill;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(3);
+    paints.push_back({"aa stroke", stroke});
+
+    SkPaint hairline;
+    hairline.setStyle(SkPaint::kStroke_Style);
+    paints.push_back({"hairline", hairline});
+
+    SkPaint blurred = aaFill;
+    blurred.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 2));
+    paints.push_back({"blurred fill", blurred});
+
+    SkPaint shaded = aaFill;
+    const SkPoint pts[] = {{0, 0}, {kSize, kSize}};
+    const SkColor gradientColors[] = {SK_ColorWHITE, SK_ColorBLACK};
+    shaded.setShader(SkGradientShader::MakeLinear(pts, gradientColors, nullptr, 2,
+                                                  SkTileMode::kClamp));
+    paints.push_back({"shaded fill", shaded});
+
+    return paints;
+}
+
+}  // namespace
+
+// Each entry of a set must draw exactly what drawRRect() draws with the entry's color, whether the
+// set takes the shared-blitter path for plain fills or draws each entry the ordinary way.
+DEF_TEST(DrawRRectSet_MatchesDrawRRect, r) {
+    const RRectSet set;
+    for (const auto& [name, paint] : test_paints()) {
+        for (bool useMatrices : {false, true}) {
+            SkBitmap expected = draw([&](SkCanvas* canvas) {
+                set.drawEachEntry(canvas, paint, useMatrices);
+            });
+            SkBitmap actual = draw([&](SkCanvas* canvas) {
+                set.drawBatched(canvas, paint, useMatrices);
+            });
+            REPORTER_ASSERT(r, same_pixels(expected, actual), "%s, %s matrices",
+                            name, useMatrices ? "with" : "without");
+        }
+    }
+}
+
+// The set is recorded as a single op, and survives serialization with its colors and matrices.
+DEF_TEST(DrawRRectSet_PictureRoundTrip, r) {
+    const RRectSet set;
+    for (const auto& [name, paint] : test_paints()) {
+        for (bool useMatrices : {false, true}) {
+            SkPictureRecorder recorder;
+            set.drawBatched(recorder.beginRecording(SkRect::MakeWH(kSize, kSize)), paint,
+                            useMatrices);
+            sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+            REPORTER_ASSERT(r, picture->approximateOpCount() == 1);
+
+            sk_sp<SkData> data = picture->serialize();
+            REPORTER_ASSERT(r, data);
+            sk_sp<SkPicture> copy = SkPicture::MakeFromData(data.get());
+            if (!copy) {
+                ERRORF(r, "%s: could not deserialize the picture", name);
+                continue;
+            }
+
+            SkBitmap expected = draw([&](SkCanvas* canvas) {
+                set.drawBatched(canvas, paint, useMatrices);
+            });
+            SkBitmap actual = draw([&](SkCanvas* canvas) { canvas->drawPicture(copy); });
+            REPORTER_ASSERT(r, same_pixels(expected, actual), "%s, %s matrices",
+                            name, useMatrices ? "with" : "without");
+        }
+    }
+}
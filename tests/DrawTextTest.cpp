@@ -16,8 +16,10 @@
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
@@ -28,6 +30,7 @@
 #include <array>
 #include <cmath>
 #include <cstring>
+#include <vector>
 
 static const SkColor bgColor = SK_ColorWHITE;
 
@@ -184,3 +187,59 @@ DEF_TEST(DrawText_noglyphs, r) {
             "\x0d\xf3\xf2\xf2\xe9\x0d\x0d\x0d\x05\x0d\x0d\xe3\xe3\xe3\xe3\xe3\xe3\xe3\xe3\xe3",
             10, 20, font, SkPaint());
 }
+
+// Neighbouring glyph masks are blitted together; that must match drawing them one at a time.
+DEF_TEST(DrawText_batchedMasks, r) {
+    const char text[] = "Keep your sentences short, but not overly so. fifl jjj";
+    SkFont font = ToolUtils::DefaultFont();
+    font.setSize(18);
+    font.setSubpixel(true);
+
+    const int count = font.countText(text, strlen(text), SkTextEncoding::kUTF8);
+    std::vector<SkGlyphID> glyphs(count);
+    std::vector<SkPoint> positions(count);
+    font.textToGlyphs(text, strlen(text), SkTextEncoding::kUTF8, glyphs.data(), count);
+    font.getPos(glyphs.data(), count, positions.data(), {0, 0});
+
+    SkPaint paint;
+    paint.setColor(0x80204080);
+
+    SkRegion complexClip;
+    complexClip.op(SkIRect::MakeLTRB(0, 0, 120, 100), SkRegion::kUnion_Op);
+    complexClip.op(SkIRect::MakeLTRB(150, 12, 400, 30), SkRegion::kUnion_Op);
+
+    const SkSurfaceProps lcdProps(0, kRGB_H_SkPixelGeometry);
+    for (SkFont::Edging edging : {SkFont::Edging::kAntiAlias, SkFont::Edging::kSubpixelAntiAlias})
+    for (int clip = 0; clip < 3; ++clip) {
+        font.setEdging(edging);
+        sk_sp<SkSurface> surfaces[2];
+        for (int perGlyph = 0; perGlyph < 2; ++perGlyph) {
+            surfaces[perGlyph] = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(400, 50),
+                                                    &lcdProps);
+            SkCanvas* canvas = surfaces[perGlyph]->getCanvas();
+            canvas->clear(SK_ColorWHITE);
+            if (clip == 1) {
+                canvas->clipRect(SkRect::MakeLTRB(30, 18, 300, 40));
+            } else if (clip == 2) {
+                canvas->clipRegion(complexClip);
+            }
+            if (perGlyph) {
+                for (int i = 0; i < count; ++i) {
+                    canvas->drawGlyphs(1, &glyphs[i], &positions[i], {10, 25}, font, paint);
+                }
+            } else {
+                canvas->drawGlyphs(count, glyphs.data(), positions.data(), {10, 25}, font, paint);
+            }
+        }
+
+        SkPixmap batched, perGlyph;
+        REPORTER_ASSERT(r, surfaces[0]->peekPixels(&batched));
+        REPORTER_ASSERT(r, surfaces[1]->peekPixels(&perGlyph));
+        bool same = true;
+        for (int y = 0; y < batched.height(); ++y) {
+            same &= 0 == memcmp(batched.addr(0, y), perGlyph.addr(0, y),
+                                batched.info().minRowBytes());
+        }
+        REPORTER_ASSERT(r, same, "edging %d, clip %d", (int)edging, clip);
+    }
+}
@@ -12,6 +12,7 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkAutoMalloc.h"
+#include "src/base/SkUTF.h"
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkPtrRecorder.h"
 #include "src/core/SkReadBuffer.h"
@@ -21,6 +22,9 @@
 #include "tools/fonts/FontToolUtils.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 
 static SkFont serialize_deserialize(const SkFont& font, skiatest::Reporter* reporter) {
     sk_sp<SkRefCntSet> typefaces = sk_make_sp<SkRefCntSet>();
@@ -114,3 +118,38 @@ DEF_TEST(Font_flatten, reporter) {
         }
     }
 }
+
+// UTF-8 and UTF-16 text, whether ASCII, other BMP characters or surrogate pairs, should map to
+// the same glyphs as the equivalent UTF-32.
+DEF_TEST(Font_textToGlyphs_encodings, reporter) {
+    const SkUnichar kText[] = {
+        'T', 'h', 'e', ' ', 'q', 'u', 'i', 'c', 'k', ' ', 'b', 'r', 'o', 'w', 'n', ' ', 'f', 'o',
+        'x', 0xE9, ' ', 0x4E2D, 0x6587, ' ', 0x1F600, 'j', 'u', 'm', 'p', 'e', 'd', ' ', 'o',
+        'v', 'e', 'r', ' ', 't', 'h', 'e', ' ', 'l', 'a', 'z', 'y', ' ', 'd', 'o', 'g', '.',
+    };
+    constexpr int kCount = std::size(kText);
+
+    char utf8[kCount * SkUTF::kMaxBytesInUTF8Sequence];
+    uint16_t utf16[kCount * 2];
+    size_t utf8Length = 0, utf16Length = 0;
+    for (SkUnichar c : kText) {
+        utf8Length += SkUTF::ToUTF8(c, utf8 + utf8Length);
+        utf16Length += SkUTF::ToUTF16(c, utf16 + utf16Length);
+    }
+
+    const SkFont font = ToolUtils::DefaultFont();
+    SkGlyphID expected[kCount], glyphs[kCount];
+    font.unicharsToGlyphs(kText, kCount, expected);
+    // Twice, so the second pass finds its characters already cached.
+    for (int pass = 0; pass < 2; ++pass) {
+        REPORTER_ASSERT(reporter, kCount == font.textToGlyphs(utf8, utf8Length,
+                                                              SkTextEncoding::kUTF8,
+                                                              glyphs, kCount));
+        REPORTER_ASSERT(reporter, !memcmp(expected, glyphs, sizeof(glyphs)));
+
+        REPORTER_ASSERT(reporter, kCount == font.textToGlyphs(utf16, utf16Length * 2,
+                                                              SkTextEncoding::kUTF16,
+                                                              glyphs, kCount));
+        REPORTER_ASSERT(reporter, !memcmp(expected, glyphs, sizeof(glyphs)));
+    }
+}
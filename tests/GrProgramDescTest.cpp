@@ -0,0 +1,189 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/gpu/GrDirectContext.h"
+#include "include/private/SkColorData.h"
+#include "include/private/base/SkTArray.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkRandom.h"
+#include "src/gpu/KeyBuilder.h"
+#include "src/gpu/SkBackingFit.h"
+#include "src/gpu/Swizzle.h"
+#include "src/gpu/ganesh/GrAppliedClip.h"
+#include "src/gpu/ganesh/GrCaps.h"
+#include "src/gpu/ganesh/GrDefaultGeoProcFactory.h"
+#include "src/gpu/ganesh/GrDirectContextPriv.h"
+#include "src/gpu/ganesh/GrDstProxyView.h"
+#include "src/gpu/ganesh/GrFragmentProcessor.h"
+#include "src/gpu/ganesh/GrProgramDesc.h"
+#include "src/gpu/ganesh/GrProgramInfo.h"
+#include "src/gpu/ganesh/GrUserStencilSettings.h"
+#include "src/gpu/ganesh/SurfaceDrawContext.h"
+#include "tests/Test.h"
+#include "tools/gpu/ProxyUtils.h"
+
+#include <utility>
+
+using namespace skia_private;
+
+// Appending the bits of one builder to another must give the same key as adding every field to a
+// single builder, no matter where in a word the appended bits start.
+DEF_TEST(KeyBuilder_AddPackedBits, r) {
+    SkRandom random;
+    for (int trial = 0; trial < 500; ++trial) {
+        const int numFields = random.nextRangeU(1, 40);
+        STArray<40, std::pair<uint32_t, uint32_t>> fields;
+        for (int i = 0; i < numFields; ++i) {
+            uint32_t numBits = random.nextRangeU(1, 32);
+            uint32_t value = numBits == 32 ? random.nextU()
+                                           : random.nextU() & ((1u << numBits) - 1);
+            fields.push_back({numBits, value});
+        }
+        const int split = random.nextULessThan(numFields + 1);
+
+        STArray<16, uint32_t, true> expected;
+        {
+            skgpu::KeyBuilder b(&expected);
+            for (auto [numBits, value] : fields) {
+                b.addBits(numBits, value, "field");
+            }
+            b.flush();
+        }
+
+        STArray<16, uint32_t, true> fragment;
+        uint32_t fragmentBits;
+        {
+            skgpu::KeyBuilder b(&fragment);
+            for (int i = split; i < numFields; ++i) {
+                b.addBits(fields[i].first, fields[i].second, "field");
+            }
+            fragmentBits = b.numBits();
+            b.flush();
+        }
+
+        STArray<16, uint32_t, true> actual;
+        {
+            skgpu::KeyBuilder b(&actual);
+            for (int i = 0; i < split; ++i) {
+                b.addBits(fields[i].first, fields[i].second, "field");
+            }
+            b.addPackedBits(fragment.data(), fragmentBits);
+            b.flush();
+        }
+
+        REPORTER_ASSERT(r, actual == expected, "trial %d: %d fields split at %d",
+                        trial, numFields, split);
+    }
+}
+
+static std::unique_ptr<GrFragmentProcessor> make_coverage_fp(int variant) {
+    static constexpr float kMatrix[20] = {0.3f, 0.6f, 0.1f, 0, 0,
+                                          0.3f, 0.6f, 0.1f, 0, 0,
+                                          0.3f, 0.6f, 0.1f, 0, 0,
+                                          0,    0,    0,    1, 0};
+    const SkPMColor4f color = {0.5f, 0.5f, 0.5f, 0.5f};
+    switch (variant) {
+        case 0:
+            return nullptr;
+        case 1:
+            return GrFragmentProcessor::ModulateRGBA(nullptr, color);
+        case 2:
+            return GrFragmentProcessor::Compose(
+                    GrFragmentProcessor::ClampOutput(GrFragmentProcessor::SwizzleOutput(
+                            GrFragmentProcessor::MakeColor(color), skgpu::Swizzle("aaa1"))),
+                    GrFragmentProcessor::ColorMatrix(GrFragmentProcessor::MakeColor(color),
+                                                     kMatrix,
+                                                     /*unpremulInput=*/true,
+                                                     /*clampRGBOutput=*/true,
+                                                     /*premulOutput=*/true));
+        default:
+            return GrFragmentProcessor::DeviceSpace(GrFragmentProcessor::OverrideInput(
+                    GrFragmentProcessor::ModulateRGBA(GrFragmentProcessor::MakeColor(color),
+                                                      color),
+                    color));
+    }
+}
+
+// Build reuses the key fragment it caches on each GrPipeline. Those keys, built the first time a
+// pipeline is seen and every time after, must match a key built by walking every processor.
+DEF_GANESH_TEST_FOR_MOCK_CONTEXT(GrProgramDesc_CachedPipelineKey, r, ctxInfo) {
+    using namespace GrDefaultGeoProcFactory;
+
+    auto dContext = ctxInfo.directContext();
+    const GrCaps* caps = dContext->priv().caps();
+    auto sdc = skgpu::ganesh::SurfaceDrawContext::Make(dContext,
+                                                       GrColorType::kRGBA_8888,
+                                                       nullptr,
+                                                       SkBackingFit::kExact,
+                                                       {16, 16},
+                                                       SkSurfaceProps(),
+                                                       /*label=*/{});
+    if (!sdc) {
+        ERRORF(r, "could not create render target context.");
+        return;
+    }
+
+    SkArenaAlloc arena(4096);
+    // Geometry processors with different key lengths, so that the pipeline's fragment is appended
+    // at several bit offsets.
+    GrGeometryProcessor* geomProcs[] = {
+        Make(&arena, Color({1, 0, 0, 1}), Coverage::kSolid_Type, LocalCoords::kUnused_Type,
+             SkMatrix::I()),
+        Make(&arena, Color::kPremulGrColorAttribute_Type, Coverage::kAttribute_Type,
+             LocalCoords::kUsePosition_Type, SkMatrix::Scale(2, 2)),
+        Make(&arena, Color::kPremulWideColorAttribute_Type, Coverage(0x80),
+             LocalCoords::kHasExplicit_Type, SkMatrix::Translate(1, 1)),
+    };
+
+    for (GrGeometryProcessor* geomProc : geomProcs)
+    for (int fpVariant = 0; fpVariant < 4; ++fpVariant)
+    for (SkBlendMode mode : {SkBlendMode::kSrcOver, SkBlendMode::kPlus})
+    for (GrPrimitiveType primitiveType : {GrPrimitiveType::kTriangles, GrPrimitiveType::kPoints}) {
+        GrAppliedClip clip = GrAppliedClip::Disabled();
+        if (auto fp = make_coverage_fp(fpVariant)) {
+            clip.addCoverageFP(std::move(fp));
+        }
+        GrProgramInfo* programInfo = sk_gpu_test::CreateProgramInfo(caps,
+                                                                    &arena,
+                                                                    sdc->writeSurfaceView(),
+                                                                    /*usesMSAASurface=*/false,
+                                                                    std::move(clip),
+                                                                    GrDstProxyView(),
+                                                                    geomProc,
+                                                                    mode,
+                                                                    primitiveType,
+                                                                    GrXferBarrierFlags::kNone,
+                                                                    GrLoadOp::kLoad);
+
+        GrProgramDesc expected = GrProgramDesc::MakeUncachedForTesting(*programInfo, *caps);
+        for (int build = 0; build < 2; ++build) {
+            GrProgramDesc desc = caps->makeDesc(/*rt=*/nullptr, *programInfo);
+            REPORTER_ASSERT(r, desc == expected, "%s, fp %d, build %d",
+                            geomProc->name(), fpVariant, build);
+            REPORTER_ASSERT(r, desc.initialKeyLength() == expected.initialKeyLength());
+        }
+
+        // Other geometry processors drawn with the same pipeline reuse its fragment.
+        for (GrGeometryProcessor* otherGeomProc : geomProcs) {
+            GrProgramInfo otherInfo(*caps,
+                                    sdc->writeSurfaceView(),
+                                    /*usesMSAASurface=*/false,
+                                    &programInfo->pipeline(),
+                                    &GrUserStencilSettings::kUnused,
+                                    otherGeomProc,
+                                    primitiveType,
+                                    GrXferBarrierFlags::kNone,
+                                    GrLoadOp::kLoad);
+            REPORTER_ASSERT(r, caps->makeDesc(/*rt=*/nullptr, otherInfo) ==
+                               GrProgramDesc::MakeUncachedForTesting(otherInfo, *caps));
+        }
+    }
+}
@@ -0,0 +1,451 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkPoint3.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkImageFilters.h"
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkBlurEngine.h"
+#include "src/core/SkDevice.h"
+#include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkSpecialImage.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+// The raster backend has no blur engine, so the image filters that have a CPU implementation use
+// it there instead of their shader passes. These tests check those implementations, against a
+// reference or against the shader passes run on the CPU.
+
+namespace {
+
+// Like the raster backend, but with a blur engine (that has no algorithms), so that filters take
+// the shader passes the GPU backends use instead of their CPU implementations. It has no filter
+// cache, so that it never returns a result from the other path.
+class ShaderPathBackend final : public skif::Backend, private SkBlurEngine {
+public:
+    ShaderPathBackend() : Backend(/*cache=*/nullptr, SkSurfaceProps(), kN32_SkColorType) {}
+
+    sk_sp<SkDevice> makeDevice(SkISize size,
+                               sk_sp<SkColorSpace> colorSpace,
+                               const SkSurfaceProps* props) const override {
+        SkImageInfo imageInfo = SkImageInfo::Make(size,
+                                                  this->colorType(),
+                                                  kPremul_SkAlphaType,
+                                                  std::move(colorSpace));
+        return SkBitmapDevice::Create(imageInfo, props ? *props : this->surfaceProps());
+    }
+
+    sk_sp<SkSpecialImage> makeImage(const SkIRect& subset, sk_sp<SkImage> image) const override {
+        return SkSpecialImages::MakeFromRaster(subset, image, this->surfaceProps());
+    }
+
+    sk_sp<SkImage> getCachedBitmap(const SkBitmap& data) const override {
+        return SkImages::RasterFromBitmap(data);
+    }
+
+    const SkBlurEngine* getBlurEngine() const override { return this; }
+
+private:
+    const Algorithm* findAlgorithm(SkSize, SkColorType) const override { return nullptr; }
+};
+
+enum class Path { kCpu, kShader };
+
+// A premultiplied N32 image with random colors, some of them transparent.
+SkBitmap make_source(int width, int height, uint32_t seed) {
+    SkRandom random(seed);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const uint32_t a = random.nextBool() ? 0xFF : random.nextU() & 0xFF;
+            *bitmap.getAddr32(x, y) = SkPackARGB32(a,
+                                                   random.nextULessThan(a + 1),
+                                                   random.nextULessThan(a + 1),
+                                                   random.nextULessThan(a + 1));
+        }
+    }
+    bitmap.setImmutable();
+    return bitmap;
+}
+
+// Returns the filter's output over 'bounds', which are in the source's coordinates, with
+// transparent black wherever the filter produced nothing.
+SkBitmap filter_image(const SkImageFilter* filter, const SkBitmap& src, const SkIRect& bounds,
+                      Path path = Path::kCpu) {
+    SkBitmap result;
+    result.allocN32Pixels(bounds.width(), bounds.height());
+    result.eraseColor(SK_ColorTRANSPARENT);
+
+    sk_sp<skif::Backend> backend = path == Path::kCpu
+            ? skif::MakeRasterBackend(SkSurfaceProps(), kN32_SkColorType)
+            : sk_make_sp<ShaderPathBackend>();
+    SkIRect outSubset;
+    SkIPoint offset;
+    sk_sp<SkImage> image = as_IFB(filter)->makeImageWithFilter(std::move(backend),
+                                                               src.asImage(),
+                                                               SkIRect::MakeSize(src.dimensions()),
+                                                               bounds,
+                                                               &outSubset,
+                                                               &offset);
+    SkPixmap dst;
+    if (image && result.pixmap().extractSubset(&dst,
+                                               SkIRect::MakeXYWH(offset.fX - bounds.fLeft,
+                                                                 offset.fY - bounds.fTop,
+                                                                 outSubset.width(),
+                                                                 outSubset.height()))) {
+        SkAssertResult(image->readPixels(nullptr, dst, outSubset.fLeft, outSubset.fTop));
+    }
+    return result;
+}
+
+// Reports the first pixel where 'actual' and 'expected' differ by more than 'tolerance' in any
+// channel.
+void check_match(skiatest::Reporter* r, const SkBitmap& actual, const SkBitmap& expected,
+                 int tolerance, const SkString& description) {
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            const uint32_t a = *actual.getAddr32(x, y), e = *expected.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (std::abs(int((a >> shift) & 0xFF) - int((e >> shift) & 0xFF)) > tolerance) {
+                    ERRORF(r, "%s: %08x instead of %08x at (%d, %d)",
+                           description.c_str(), a, e, x, y);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// Reports when more than 'maxMismatches' pixels of 'actual' and 'expected' differ at all.
+void check_mostly_match(skiatest::Reporter* r, const SkBitmap& actual, const SkBitmap& expected,
+                        int maxMismatches, const SkString& description) {
+    int mismatches = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            mismatches += *actual.getAddr32(x, y) != *expected.getAddr32(x, y) ? 1 : 0;
+        }
+    }
+    REPORTER_ASSERT(r, mismatches <= maxMismatches, "%s: %d of %d pixels differ",
+                    description.c_str(), mismatches, expected.width() * expected.height());
+}
+
+// Takes the min or max of each channel over the window, treating pixels outside 'src' as
+// transparent black.
+SkBitmap brute_force_morphology(bool dilate, int radiusX, int radiusY,
+                                const SkBitmap& src, const SkIRect& bounds) {
+    SkBitmap result;
+    result.allocN32Pixels(bounds.width(), bounds.height());
+    for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+        for (int x = bounds.fLeft; x < bounds.fRight; ++x) {
+            uint32_t pixel = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                uint32_t channel = dilate ? 0 : 0xFF;
+                for (int sy = y - radiusY; sy <= y + radiusY; ++sy) {
+                    for (int sx = x - radiusX; sx <= x + radiusX; ++sx) {
+                        const uint32_t s = SkIRect::MakeSize(src.dimensions()).contains(sx, sy)
+                                                   ? (*src.getAddr32(sx, sy) >> shift) & 0xFF
+                                                   : 0;
+                        channel = dilate ? std::max(channel, s) : std::min(channel, s);
+                    }
+                }
+                pixel |= channel << shift;
+            }
+            *result.getAddr32(x - bounds.fLeft, y - bounds.fTop) = pixel;
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+DEF_TEST(ImageFilterCpu_Morphology, r) {
+    const SkBitmap src = make_source(23, 17, /*seed=*/1);
+    const struct {
+        int fX, fY;
+    } kRadii[] = {
+        {0, 0},
+        {1, 1},
+        {3, 7},    // asymmetric
+        {7, 0},    // X only
+        {0, 5},    // Y only
+        {40, 30},  // larger than the image
+    };
+    const SkIRect kBounds[] = {
+        SkIRect::MakeSize(src.dimensions()).makeOutset(45, 45),  // all of the output
+        SkIRect::MakeXYWH(5, 3, 10, 9),                          // part of it
+    };
+
+    // Without a crop, a radius of (0, 0) makes no filter at all. This crop doesn't clip anything.
+    const SkImageFilters::CropRect crop(SkRect::Make(kBounds[0]));
+    for (bool dilate : {true, false}) {
+        for (auto [radiusX, radiusY] : kRadii) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radiusX, radiusY, nullptr, crop)
+                           : SkImageFilters::Erode(radiusX, radiusY, nullptr, crop);
+            for (const SkIRect& bounds : kBounds) {
+                check_match(r,
+                            filter_image(filter.get(), src, bounds),
+                            brute_force_morphology(dilate, radiusX, radiusY, src, bounds),
+                            /*tolerance=*/0,
+                            SkStringPrintf("%s radius (%d, %d), bounds %d,%d %dx%d",
+                                           dilate ? "dilate" : "erode", radiusX, radiusY,
+                                           bounds.fLeft, bounds.fTop,
+                                           bounds.width(), bounds.height()));
+            }
+        }
+    }
+}
+
+namespace {
+
+// The outer products of the 'ys' and 'xs' vectors, summed.
+std::vector<float> sum_of_outer_products(const std::vector<std::vector<float>>& ys,
+                                         const std::vector<std::vector<float>>& xs) {
+    std::vector<float> kernel(ys[0].size() * xs[0].size(), 0.f);
+    for (size_t term = 0; term < ys.size(); ++term) {
+        for (size_t y = 0; y < ys[term].size(); ++y) {
+            for (size_t x = 0; x < xs[term].size(); ++x) {
+                kernel[y * xs[term].size() + x] += ys[term][y] * xs[term][x];
+            }
+        }
+    }
+    return kernel;
+}
+
+}  // namespace
+
+// The CPU convolution, including its separable path for low-rank kernels, must match the shaders.
+DEF_TEST(ImageFilterCpu_MatrixConvolution, r) {
+    const SkBitmap src = make_source(29, 21, /*seed=*/2);
+    const struct {
+        const char* fName;
+        SkISize fSize;
+        std::vector<float> fKernel;
+        SkIPoint fOffset;
+    } kKernels[] = {
+        {"separable", {5, 3},
+         sum_of_outer_products({{1, 2, 1}}, {{1, 4, 6, 4, 1}}), {2, 1}},
+        {"rank 2", {7, 7},
+         sum_of_outer_products({{1, 2, 3, 4, 3, 2, 1}, {0, -1, 0, 2, 0, -1, 0}},
+                               {{1, 1, 2, 2, 2, 1, 1}, {1, 0, -1, 0, 1, 0, -1}}), {3, 3}},
+        {"non-separable", {3, 3},
+         {0, -1, 0,
+          -1, 5, -1,
+          0, -1, 2}, {0, 2}},
+    };
+    const SkIRect bounds = SkIRect::MakeSize(src.dimensions()).makeOutset(8, 8);
+    // Tile modes only apply inside a crop.
+    const SkImageFilters::CropRect crop(SkRect::MakeXYWH(3, 2, 20, 15));
+
+    for (const auto& kernel : kKernels) {
+        float total = 0;
+        for (float k : kernel.fKernel) {
+            total += k;
+        }
+        const float gain = total != 0.f ? 1 / total : 0.25f;
+        for (bool convolveAlpha : {false, true}) {
+            for (float bias : {0.f, 40.f}) {
+                for (SkTileMode tileMode : {SkTileMode::kClamp, SkTileMode::kRepeat,
+                                            SkTileMode::kMirror, SkTileMode::kDecal}) {
+                    sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                            kernel.fSize, kernel.fKernel.data(), gain, bias, kernel.fOffset,
+                            tileMode, convolveAlpha, nullptr, crop);
+                    check_match(r,
+                                filter_image(filter.get(), src, bounds, Path::kCpu),
+                                filter_image(filter.get(), src, bounds, Path::kShader),
+                                /*tolerance=*/2,
+                                SkStringPrintf("%s, convolveAlpha %d, bias %g, tile mode %d",
+                                               kernel.fName, convolveAlpha, bias,
+                                               static_cast<int>(tileMode)));
+                }
+            }
+            // Without a crop, the kernel reads transparent black outside of the image.
+            sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                    kernel.fSize, kernel.fKernel.data(), gain, /*bias=*/0.f, kernel.fOffset,
+                    SkTileMode::kDecal, convolveAlpha, nullptr);
+            check_match(r,
+                        filter_image(filter.get(), src, bounds, Path::kCpu),
+                        filter_image(filter.get(), src, bounds, Path::kShader),
+                        /*tolerance=*/2,
+                        SkStringPrintf("%s, convolveAlpha %d, no crop",
+                                       kernel.fName, convolveAlpha));
+        }
+    }
+}
+
+// The CPU displacement must pick the same color pixels as the shader with nearest sampling. Where
+// a displaced position lands within float rounding of a pixel edge, the two can pick neighboring
+// pixels, so a few differences are allowed.
+DEF_TEST(ImageFilterCpu_DisplacementMap, r) {
+    const SkBitmap color = make_source(64, 48, /*seed=*/3);
+
+    // A premultiplied displacement map with transparent, partially transparent and opaque pixels.
+    const SkBitmap displacement = make_source(36, 28, /*seed=*/4);
+    SkBitmap map;
+    map.allocN32Pixels(displacement.width(), displacement.height());
+    SkAssertResult(displacement.readPixels(map.pixmap()));
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); x += 5) {
+            *map.getAddr32(x, y) = 0;
+        }
+    }
+    map.setImmutable();
+    // Smaller than the output, and offset within it.
+    sk_sp<SkImageFilter> displacementInput =
+            SkImageFilters::Image(map.asImage(),
+                                  SkRect::Make(map.bounds()),
+                                  SkRect::Make(map.bounds().makeOffset(9, 7)),
+                                  SkSamplingOptions());
+
+    const SkIRect bounds = SkIRect::MakeSize(color.dimensions()).makeOutset(4, 4);
+    const int maxMismatches = bounds.width() * bounds.height() / 100;
+    constexpr SkColorChannel kChannels[] = {SkColorChannel::kR, SkColorChannel::kG,
+                                            SkColorChannel::kB, SkColorChannel::kA};
+    for (SkColorChannel xChannel : kChannels) {
+        for (SkColorChannel yChannel : kChannels) {
+            // Large scales shrink the CPU tiles down to their minimum size.
+            for (float scale : {13.3f, -23.3f, 301.7f}) {
+                sk_sp<SkImageFilter> filter = SkImageFilters::DisplacementMap(
+                        xChannel, yChannel, scale, displacementInput, /*color=*/nullptr);
+                check_mostly_match(r,
+                                   filter_image(filter.get(), color, bounds, Path::kCpu),
+                                   filter_image(filter.get(), color, bounds, Path::kShader),
+                                   maxMismatches,
+                                   SkStringPrintf("channels %d/%d, scale %g",
+                                                  static_cast<int>(xChannel),
+                                                  static_cast<int>(yChannel), scale));
+            }
+        }
+    }
+}
+
+namespace {
+
+enum class LightType { kDistant, kPoint, kSpot };
+
+sk_sp<SkImageFilter> make_light_filter(LightType type, bool specular, float shininess,
+                                       float surfaceScale) {
+    const SkColor color = SkColorSetRGB(0xE0, 0x90, 0x40);
+    const SkPoint3 location = SkPoint3::Make(10, -6, 25);
+    const float k = specular ? 1.3f : 0.8f;
+    switch (type) {
+        case LightType::kDistant: {
+            const SkPoint3 direction = SkPoint3::Make(1, -2, 3);
+            return specular ? SkImageFilters::DistantLitSpecular(direction, color, surfaceScale,
+                                                                 k, shininess, nullptr)
+                            : SkImageFilters::DistantLitDiffuse(direction, color, surfaceScale,
+                                                                k, nullptr);
+        }
+        case LightType::kPoint:
+            return specular ? SkImageFilters::PointLitSpecular(location, color, surfaceScale,
+                                                               k, shininess, nullptr)
+                            : SkImageFilters::PointLitDiffuse(location, color, surfaceScale,
+                                                              k, nullptr);
+        case LightType::kSpot: {
+            // The cone edge crosses the image, so its antialiasing is covered too.
+            const SkPoint3 target = SkPoint3::Make(14, 12, 0);
+            const float falloff = shininess;  // Also exercises exponents below 1
+            return specular ? SkImageFilters::SpotLitSpecular(location, target, falloff, 25.f,
+                                                              color, surfaceScale, k, shininess,
+                                                              nullptr)
+                            : SkImageFilters::SpotLitDiffuse(location, target, falloff, 25.f,
+                                                             color, surfaceScale, k, nullptr);
+        }
+    }
+    SkUNREACHABLE;
+}
+
+}  // namespace
+
+// The CPU normal map and lighting equation must match the shaders, for every light and material,
+// at the boundaries where onFilterImage clamps the normals and where it decals them, and when a
+// normal map is reused from the cache.
+DEF_TEST(ImageFilterCpu_Lighting, r) {
+    const SkBitmap src = make_source(27, 19, /*seed=*/5);
+    const SkIRect srcBounds = SkIRect::MakeSize(src.dimensions());
+    const struct {
+        const char* fName;
+        SkIRect fBounds;
+    } kBounds[] = {
+        // The input ends where the output does, so the normals are clamped to the output.
+        {"clamped edges", srcBounds},
+        // The output extends well past the input, so the input is decal-tiled.
+        {"decal edges", srcBounds.makeOutset(8, 8)},
+        {"clamped and decal edges", SkIRect::MakeLTRB(0, 0, src.width() + 6, src.height() + 6)},
+        // The input covers the output and the 1px border the normals need.
+        {"interior", SkIRect::MakeXYWH(5, 3, 10, 9)},
+    };
+    const struct {
+        const char* fName;
+        LightType fType;
+    } kLights[] = {
+        {"distant", LightType::kDistant},
+        {"point", LightType::kPoint},
+        {"spot", LightType::kSpot},
+    };
+
+    // Every filter here has the same surface scale, so after the first one the CPU path lights
+    // normal maps that it finds in the cache.
+    for (const auto& bounds : kBounds) {
+        for (const auto& light : kLights) {
+            for (bool specular : {false, true}) {
+                for (float shininess : {0.4f, 1.f, 12.f}) {
+                    sk_sp<SkImageFilter> filter =
+                            make_light_filter(light.fType, specular, shininess, 2.5f);
+                    check_match(r,
+                                filter_image(filter.get(), src, bounds.fBounds, Path::kCpu),
+                                filter_image(filter.get(), src, bounds.fBounds, Path::kShader),
+                                /*tolerance=*/2,
+                                SkStringPrintf("%s, %s %s, shininess %g", bounds.fName,
+                                               light.fName, specular ? "specular" : "diffuse",
+                                               shininess));
+                }
+            }
+        }
+    }
+
+    // Two lights on the same input share one normal map, but only when their surface scales match.
+    const SkIRect bounds = srcBounds.makeOutset(3, 3);
+    sk_sp<SkImageFilter> diffuse = make_light_filter(LightType::kDistant, false, 1.f, -4.f);
+    sk_sp<SkImageFilter> specular = make_light_filter(LightType::kPoint, true, 6.f, -4.f);
+    sk_sp<SkImageFilter> deeper = make_light_filter(LightType::kPoint, true, 6.f, 7.f);
+    sk_sp<SkImageFilter> merged = SkImageFilters::Merge(diffuse, specular);
+    for (const SkImageFilter* filter : {diffuse.get(), specular.get(), deeper.get(),
+                                        merged.get()}) {
+        check_match(r,
+                    filter_image(filter, src, bounds, Path::kCpu),
+                    filter_image(filter, src, bounds, Path::kShader),
+                    /*tolerance=*/2,
+                    SkString("shared normal map"));
+    }
+}
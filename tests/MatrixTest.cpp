@@ -22,6 +22,8 @@
 #include "src/core/SkPointPriv.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <initializer_list>
 #include <string>
@@ -1053,6 +1055,56 @@ DEF_TEST(Matrix_mapRect_skbug12335, r) {
     REPORTER_ASSERT(r, !out.isEmpty());
 }
 
+DEF_TEST(Matrix_MapRectsBatched, r) {
+    auto nearly_equal = [](const SkRect& a, const SkRect& b) {
+        auto close = [](float x, float y) {
+            return SkScalarNearlyEqual(x, y, 1e-4f * std::max({1.f, std::abs(x), std::abs(y)}));
+        };
+        return close(a.fLeft, b.fLeft) && close(a.fTop, b.fTop) &&
+               close(a.fRight, b.fRight) && close(a.fBottom, b.fBottom);
+    };
+
+    SkMatrix affine = SkMatrix::RotateDeg(30);
+    affine.postScale(2, 0.5f).postTranslate(10, -5);
+    SkMatrix persp = affine;
+    persp.setPerspX(0.001f).setPerspY(0.002f);
+    // Some corners of the rects below land behind the w = 0 plane, and need to be clipped.
+    SkM44 clipped;
+    clipped.setRow(3, {-.2f, -.6f, 0.f, 8.f});
+
+    // An odd count covers both the vector loops and their tails.
+    constexpr int kCount = 203;
+    SkRect src[kCount], dst[kCount];
+    SkRandom rand;
+    for (SkRect& rect : src) {
+        rect.setXYWH(rand.nextRangeScalar(-20, 20), rand.nextRangeScalar(-20, 20),
+                     rand.nextRangeScalar(0, 20), rand.nextRangeScalar(0, 20));
+    }
+
+    for (const SkMatrix& m : {SkMatrix::Translate(3, 4), SkMatrix::Scale(2, -3), affine, persp,
+                              clipped.asM33()}) {
+        SkMatrixPriv::MapRects(m, dst, src, kCount);
+        for (int i = 0; i < kCount; ++i) {
+            REPORTER_ASSERT(r, nearly_equal(dst[i], m.mapRect(src[i])));
+        }
+    }
+    for (const SkM44& m : {SkM44(affine), SkM44(persp), clipped}) {
+        SkMatrixPriv::MapRects(m, dst, src, kCount);
+        for (int i = 0; i < kCount; ++i) {
+            REPORTER_ASSERT(r, nearly_equal(dst[i], SkMatrixPriv::MapRect(m, src[i])));
+        }
+    }
+
+    // Mapping in place gives the same results.
+    SkRect inPlace[kCount];
+    std::copy_n(src, kCount, inPlace);
+    SkMatrixPriv::MapRects(clipped, inPlace, inPlace, kCount);
+    SkMatrixPriv::MapRects(clipped, dst, src, kCount);
+    for (int i = 0; i < kCount; ++i) {
+        REPORTER_ASSERT(r, inPlace[i] == dst[i]);
+    }
+}
+
 DEF_TEST(Matrix_Ctor, r) {
     REPORTER_ASSERT(r, SkMatrix{} == SkMatrix::I());
 }
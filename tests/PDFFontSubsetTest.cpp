@@ -0,0 +1,184 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkDocument.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
+#include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkResourceCache.h"
+#include "tests/Test.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Writes each text on a page of its own, uncompressed so that the font programs can be compared.
+std::string make_pdf(const sk_sp<SkTypeface>& typeface,
+                     const std::vector<const char*>& texts,
+                     SkExecutor* executor) {
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    metadata.fCompressionLevel = SkPDF::Metadata::CompressionLevel::None;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    const SkFont font(typeface, 24);
+    for (const char* text : texts) {
+        SkCanvas* canvas = doc->beginPage(400, 100);
+        canvas->drawString(text, 10, 50, font, SkPaint());
+        doc->endPage();
+    }
+    doc->close();
+    sk_sp<SkData> pdf = stream.detachAsData();
+    return std::string(static_cast<const char*>(pdf->data()), pdf->size());
+}
+
+struct FontFile {
+    int fLength1;
+    std::string fData;
+};
+
+// Finds every object through the cross-reference table, and returns the FontFile2 streams in the
+// order the font descriptors refer to them. Reports whatever does not parse.
+std::vector<FontFile> font_files(skiatest::Reporter* r, const std::string& pdf) {
+    std::vector<FontFile> files;
+    static constexpr char kEOF[] = "%%EOF\n";
+    if (pdf.compare(0, 5, "%PDF-") != 0 || pdf.size() < strlen(kEOF) ||
+        pdf.compare(pdf.size() - strlen(kEOF), strlen(kEOF), kEOF) != 0) {
+        ERRORF(r, "Missing PDF header or trailer");
+        return files;
+    }
+
+    size_t startXref = pdf.rfind("startxref\n");
+    size_t xref = 0;
+    int objectCount = 0;
+    if (startXref == std::string::npos ||
+        1 != sscanf(pdf.c_str() + startXref, "startxref\n%zu", &xref) || xref >= pdf.size() ||
+        1 != sscanf(pdf.c_str() + xref, "xref\n0 %d", &objectCount)) {
+        ERRORF(r, "Missing cross-reference table");
+        return files;
+    }
+    // Each entry after the free object 0 is the 20 bytes "nnnnnnnnnn 00000 n \n".
+    static constexpr char kFreeEntry[] = "65535 f \n";
+    const size_t freeEntry = pdf.find(kFreeEntry, xref);
+    if (freeEntry == std::string::npos ||
+        freeEntry + strlen(kFreeEntry) + 20 * (objectCount - 1) > pdf.size()) {
+        ERRORF(r, "Truncated cross-reference table");
+        return files;
+    }
+    std::vector<size_t> offsets(objectCount, 0);
+    for (int i = 1; i < objectCount; ++i) {
+        const size_t entry = freeEntry + strlen(kFreeEntry) + 20 * (i - 1);
+        int objectNumber = 0;
+        if (1 != sscanf(pdf.c_str() + entry, "%zu 00000 n", &offsets[i]) ||
+            offsets[i] >= pdf.size() ||
+            1 != sscanf(pdf.c_str() + offsets[i], "%d 0 obj", &objectNumber) ||
+            objectNumber != i) {
+            ERRORF(r, "Object %d is not where the cross-reference table says", i);
+            return files;
+        }
+    }
+
+    static constexpr char kFontFile2[] = "/FontFile2 ";
+    for (size_t found = pdf.find(kFontFile2); found != std::string::npos;
+         found = pdf.find(kFontFile2, found + 1)) {
+        int ref = 0;
+        if (1 != sscanf(pdf.c_str() + found, "/FontFile2 %d 0 R", &ref) ||
+            ref <= 0 || ref >= objectCount) {
+            ERRORF(r, "Bad FontFile2 reference");
+            continue;
+        }
+        static constexpr char kStream[] = " stream\n";
+        const size_t dictEnd = pdf.find(kStream, offsets[ref]);
+        if (dictEnd == std::string::npos) {
+            ERRORF(r, "FontFile2 object %d is not a stream", ref);
+            continue;
+        }
+        const std::string dict = pdf.substr(offsets[ref], dictEnd - offsets[ref]);
+        const size_t lengthKey = dict.find("/Length "), length1Key = dict.find("/Length1 ");
+        size_t length = 0;
+        FontFile file;
+        if (lengthKey == std::string::npos || length1Key == std::string::npos ||
+            1 != sscanf(dict.c_str() + lengthKey, "/Length %zu", &length) ||
+            1 != sscanf(dict.c_str() + length1Key, "/Length1 %d", &file.fLength1)) {
+            ERRORF(r, "FontFile2 object %d has no lengths", ref);
+            continue;
+        }
+        const size_t dataStart = dictEnd + strlen(kStream);
+        if (pdf.compare(dataStart + length, strlen("\nendstream"), "\nendstream") != 0) {
+            ERRORF(r, "FontFile2 object %d does not end after %zu bytes", ref, length);
+            continue;
+        }
+        file.fData = pdf.substr(dataStart, length);
+        files.push_back(std::move(file));
+    }
+    return files;
+}
+
+}  // namespace
+
+// Subsetting fonts on an executor, or finding them in the subset cache, must embed the same font
+// programs as subsetting them serially.
+DEF_TEST(SkPDF_FontSubsetExecutor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_FontSubsetExecutor, r);
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        INFOF(r, "fonts/Roboto-Regular.ttf not found; test skipped.");
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    // Two glyph sets for the same typeface, each alone and together in one document.
+    const std::vector<const char*> kDocuments[] = {
+        {"Hamburgefons"},
+        {"Quick zephyrs blow, vexing daft Jim"},
+        {"Hamburgefons", "Quick zephyrs blow, vexing daft Jim"},
+    };
+    std::vector<std::string> embedded;
+    for (const std::vector<const char*>& texts : kDocuments) {
+        SkResourceCache::PurgeAll();
+        const std::vector<FontFile> serial = font_files(r, make_pdf(typeface, texts, nullptr));
+        SkResourceCache::PurgeAll();
+        const std::vector<FontFile> threaded =
+                font_files(r, make_pdf(typeface, texts, executor.get()));
+        // From the subset cache this time.
+        const std::vector<FontFile> cached =
+                font_files(r, make_pdf(typeface, texts, executor.get()));
+
+        if (serial.size() != 1 || threaded.size() != 1 || cached.size() != 1) {
+            ERRORF(r, "%zu, %zu and %zu FontFile2 streams, expected one each",
+                   serial.size(), threaded.size(), cached.size());
+            continue;
+        }
+        REPORTER_ASSERT(r, serial[0].fLength1 == SkToInt(serial[0].fData.size()));
+        REPORTER_ASSERT(r, threaded[0].fLength1 == serial[0].fLength1);
+        REPORTER_ASSERT(r, threaded[0].fData == serial[0].fData);
+        REPORTER_ASSERT(r, cached[0].fLength1 == serial[0].fLength1);
+        REPORTER_ASSERT(r, cached[0].fData == serial[0].fData);
+        embedded.push_back(serial[0].fData);
+    }
+
+    // Without a subsetter, every document embeds the whole font.
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> fontStream = typeface->openStream(&ttcIndex);
+    if (embedded.size() == 3 && fontStream && embedded[0].size() < fontStream->getLength()) {
+        REPORTER_ASSERT(r, embedded[0] != embedded[1]);
+        REPORTER_ASSERT(r, embedded[2] != embedded[0]);
+        REPORTER_ASSERT(r, embedded[2] != embedded[1]);
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkDocument.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "include/docs/SkPDFDocument.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Draws each image on a page of its own and returns how many image XObjects the PDF has.
+int count_image_xobjects(const std::vector<sk_sp<SkImage>>& images,
+                         SkExecutor* executor = nullptr) {
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    for (const sk_sp<SkImage>& image : images) {
+        SkCanvas* canvas = doc->beginPage(image->width(), image->height());
+        canvas->drawImage(image, 0, 0);
+        doc->endPage();
+    }
+    doc->close();
+
+    sk_sp<SkData> pdf = stream.detachAsData();
+    const char* data = static_cast<const char*>(pdf->data());
+    static constexpr char kImage[] = "/Subtype /Image";
+    int count = 0;
+    for (size_t i = 0; i + strlen(kImage) <= pdf->size(); ++i) {
+        if (0 == memcmp(data + i, kImage, strlen(kImage))) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// A raster image of its own (so with its own ID) whose pixels depend only on 'seed'.
+sk_sp<SkImage> make_raster(int seed,
+                           int size = 16,
+                           SkAlphaType alphaType = kPremul_SkAlphaType,
+                           sk_sp<SkColorSpace> colorSpace = nullptr) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(size, size, alphaType, std::move(colorSpace)));
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(
+                    SkColorSetARGB(0xFF, (x * 16 + seed) & 0xFF, (y * 16) & 0xFF, seed & 0xFF));
+        }
+    }
+    bitmap.setImmutable();
+    return bitmap.asImage();
+}
+
+}  // namespace
+
+// Separate SkImages with the same contents share one XObject; anything that could look different
+// does not.
+DEF_TEST(SkPDF_ImageContentDedup, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_ImageContentDedup, r);
+
+    auto expectShared = [&](const char* name, sk_sp<SkImage> a, sk_sp<SkImage> b,
+                            SkExecutor* executor = nullptr) {
+        REPORTER_ASSERT(r, a->uniqueID() != b->uniqueID());
+        const int single = count_image_xobjects({a}, executor);
+        REPORTER_ASSERT(r, single > 0);
+        const int both = count_image_xobjects({a, b}, executor);
+        REPORTER_ASSERT(r, both == single, "%s: %d XObjects, expected %d", name, both, single);
+    };
+    auto expectDistinct = [&](const char* name, sk_sp<SkImage> a, sk_sp<SkImage> b) {
+        const int expected = count_image_xobjects({a}) + count_image_xobjects({b});
+        const int both = count_image_xobjects({a, b});
+        REPORTER_ASSERT(r, both == expected, "%s: %d XObjects, expected %d", name, both, expected);
+    };
+
+    expectShared("same pixels", make_raster(1), make_raster(1));
+    // Large enough to be hashed in several bands, on the executor when there is one.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    expectShared("same large pixels", make_raster(1, 600), make_raster(1, 600));
+    expectShared("same large pixels, with executor", make_raster(1, 600), make_raster(1, 600),
+                 executor.get());
+
+    if (sk_sp<SkData> jpeg = GetResourceAsData("images/mandrill_512_q075.jpg")) {
+        expectShared("same encoded data",
+                     SkImages::DeferredFromEncodedData(jpeg),
+                     SkImages::DeferredFromEncodedData(SkData::MakeWithCopy(jpeg->data(),
+                                                                           jpeg->size())));
+    } else {
+        INFOF(r, "images/mandrill_512_q075.jpg not found; skipping encoded images.");
+    }
+
+    expectDistinct("different pixels", make_raster(1), make_raster(2));
+    expectDistinct("different color space",
+                   make_raster(1),
+                   make_raster(1, 16, kPremul_SkAlphaType, SkColorSpace::MakeSRGB()));
+    expectDistinct("different alpha type",
+                   make_raster(1), make_raster(1, 16, kUnpremul_SkAlphaType));
+
+    // Subsets of one image are keyed by their own pixels, not by the image they came from.
+    sk_sp<SkImage> image = make_raster(1);
+    expectDistinct("different subsets",
+                   image->makeSubset(nullptr, SkIRect::MakeXYWH(0, 0, 8, 8)),
+                   image->makeSubset(nullptr, SkIRect::MakeXYWH(8, 8, 8, 8)));
+    expectShared("same subset of separate images",
+                 image->makeSubset(nullptr, SkIRect::MakeXYWH(4, 4, 8, 8)),
+                 make_raster(1)->makeSubset(nullptr, SkIRect::MakeXYWH(4, 4, 8, 8)));
+}
@@ -10,6 +10,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
@@ -24,7 +25,15 @@
 #include "tests/Test.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -196,4 +205,230 @@ DEF_TEST(SkPDF_tagged_doc, r) {
 
     outputStream.flush();
 }
+
+namespace {
+
+// The body of each indirect object, by object number, found through the cross-reference table.
+std::map<int, std::string> pdf_objects(const std::string& pdf) {
+    std::map<int, std::string> objects;
+    const size_t startXref = pdf.rfind("startxref\n");
+    size_t xref = 0;
+    int objectCount = 0;
+    if (startXref == std::string::npos ||
+        1 != sscanf(pdf.c_str() + startXref, "startxref\n%zu", &xref) || xref >= pdf.size() ||
+        1 != sscanf(pdf.c_str() + xref, "xref\n0 %d", &objectCount)) {
+        return objects;
+    }
+    // Each entry after the free object 0 is the 20 bytes "nnnnnnnnnn 00000 n \n".
+    static constexpr char kFreeEntry[] = "65535 f \n";
+    size_t entry = pdf.find(kFreeEntry, xref);
+    if (entry == std::string::npos) {
+        return objects;
+    }
+    entry += strlen(kFreeEntry);
+    for (int i = 1; i < objectCount && entry + 20 <= pdf.size(); ++i, entry += 20) {
+        size_t offset = 0;
+        int objectNumber = 0;
+        if (1 != sscanf(pdf.c_str() + entry, "%zu", &offset) || offset >= pdf.size() ||
+            1 != sscanf(pdf.c_str() + offset, "%d 0 obj", &objectNumber) || objectNumber != i) {
+            continue;
+        }
+        const size_t begin = pdf.find('\n', offset) + 1;
+        const size_t end = pdf.find("\nendobj\n", begin);
+        if (end != std::string::npos) {
+            objects[i] = pdf.substr(begin, end - begin);
+        }
+    }
+    return objects;
+}
+
+std::string ref_string(int objectNumber) { return std::to_string(objectNumber) + " 0 R"; }
+
+// Whether 'object' has 'entry' as a whole entry, and not just as the start of a longer one.
+bool has_entry(const std::string& object, const std::string& entry) {
+    for (size_t found = object.find(entry); found != std::string::npos;
+         found = object.find(entry, found + 1)) {
+        const size_t end = found + entry.size();
+        if (end == object.size() || strchr("\n >]", object[end])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The number of the one object that has all of 'entries', or 0.
+int find_object(const std::map<int, std::string>& objects,
+                std::initializer_list<std::string> entries) {
+    int result = 0;
+    for (const auto& [number, object] : objects) {
+        bool all = true;
+        for (const std::string& entry : entries) {
+            all = all && has_entry(object, entry);
+        }
+        if (all) {
+            if (result) {
+                return 0;
+            }
+            result = number;
+        }
+    }
+    return result;
+}
+
+// The "/K [...]" array of a structure element, which holds no nested arrays.
+std::string kids_of(const std::string& element) {
+    const size_t begin = element.find("/K [");
+    const size_t end = element.find(']', begin);
+    return begin == std::string::npos || end == std::string::npos
+                   ? std::string()
+                   : element.substr(begin + 3, end - begin - 2);
+}
+
+// The object numbers referred to by "n 0 R" in 'text'.
+std::set<int> refs_in(const std::string& text) {
+    std::set<int> refs;
+    for (size_t found = text.find(" 0 R"); found != std::string::npos;
+         found = text.find(" 0 R", found + 1)) {
+        size_t begin = found;
+        while (begin > 0 && isdigit(text[begin - 1])) {
+            --begin;
+        }
+        if (begin < found) {
+            refs.insert(std::stoi(text.substr(begin, found - begin)));
+        }
+    }
+    return refs;
+}
+
+}  // namespace
+
+// An element's marks on the page of its first mark are bare MCIDs under the element's /Pg, and its
+// marks on later pages are MCR dictionaries. Pages without marks get no parent tree entry, and a
+// header's outline entry points at the page of its first mark.
+DEF_TEST(SkPDF_tagged_marks_across_pages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_tagged_marks_across_pages, r);
+
+    SkPDF::Metadata metadata;
+    metadata.fOutline = SkPDF::Metadata::Outline::StructureElementHeaders;
+
+    auto root = std::make_unique<PDFTag>();
+    root->fNodeId = 1;
+    root->fTypeString = "Document";
+    for (auto [nodeId, type, alt] : {std::make_tuple(2, "H1", "Title"),
+                                     std::make_tuple(3, "P", "Paragraph"),
+                                     std::make_tuple(4, "H2", "Section")}) {
+        auto child = std::make_unique<PDFTag>();
+        child->fNodeId = nodeId;
+        child->fTypeString = type;
+        child->fAlt = alt;
+        root->fChildVector.push_back(std::move(child));
+    }
+    metadata.fStructureElementTreeRoot = root.get();
+
+    SkDynamicMemoryWStream outputStream;
+    sk_sp<SkDocument> document = SkPDF::MakeDocument(&outputStream, metadata);
+    SkFont font(ToolUtils::DefaultTypeface(), 14);
+    SkPaint paint;
+    auto draw = [&](SkCanvas* canvas, int nodeId, const char* text, float y) {
+        SkPDF::SetNodeId(canvas, nodeId);
+        canvas->drawString(text, 72, y, font, paint);
+    };
+
+    // Page 0: the title, and the start of the paragraph.
+    SkCanvas* canvas = document->beginPage(612, 792);
+    draw(canvas, 2, "Title", 72);
+    draw(canvas, 3, "This paragraph starts on the first page", 144);
+    document->endPage();
+
+    // Page 1: nothing in the structure tree.
+    canvas = document->beginPage(612, 792);
+    draw(canvas, 999, "Not tagged", 72);
+    document->endPage();
+
+    // Page 2: the end of the paragraph, and the start of the section.
+    canvas = document->beginPage(612, 792);
+    draw(canvas, 3, "and ends on the third.", 72);
+    draw(canvas, 4, "Section", 144);
+    document->endPage();
+
+    // Page 3: more of the section, higher up the page than it started.
+    canvas = document->beginPage(612, 792);
+    draw(canvas, 4, "Section, continued", 36);
+    document->endPage();
+
+    // Page 4: blank.
+    document->beginPage(612, 792);
+    document->endPage();
+
+    document->close();
+
+    sk_sp<SkData> data = outputStream.detachAsData();
+    const std::map<int, std::string> objects =
+            pdf_objects(std::string(static_cast<const char*>(data->data()), data->size()));
+
+    int pages[5];
+    for (int i = 0; i < 5; ++i) {
+        pages[i] = find_object(objects, {"/Type /Page", "/StructParents " + std::to_string(i)});
+        REPORTER_ASSERT(r, pages[i], "page %d not found", i);
+    }
+    const int title = find_object(objects, {"/Type /StructElem", "/Alt (Title)"});
+    const int paragraph = find_object(objects, {"/Type /StructElem", "/Alt (Paragraph)"});
+    const int section = find_object(objects, {"/Type /StructElem", "/Alt (Section)"});
+    const int parentTree = find_object(objects, {"/Type /ParentTree"});
+    if (!title || !paragraph || !section || !parentTree) {
+        ERRORF(r, "Missing structure elements or parent tree");
+        return;
+    }
+
+    // Only the pages with marks are in the parent tree, each with the elements marked on it.
+    const std::string& nums = objects.at(parentTree);
+    std::map<int, std::set<int>> pageElements;
+    const char* cursor = strstr(nums.c_str(), "/Nums [");
+    REPORTER_ASSERT(r, cursor);
+    cursor += cursor ? strlen("/Nums [") : 0;
+    int key, arrayRef, consumed;
+    while (cursor && 2 == sscanf(cursor, "%d %d 0 R%n", &key, &arrayRef, &consumed)) {
+        cursor += consumed;
+        REPORTER_ASSERT(r, objects.count(arrayRef));
+        if (objects.count(arrayRef)) {
+            pageElements[key] = refs_in(objects.at(arrayRef));
+        }
+    }
+    REPORTER_ASSERT(r, pageElements.size() == 3);
+    REPORTER_ASSERT(r, (pageElements[0] == std::set<int>{title, paragraph}));
+    REPORTER_ASSERT(r, (pageElements[2] == std::set<int>{paragraph, section}));
+    REPORTER_ASSERT(r, (pageElements[3] == std::set<int>{section}));
+
+    // Marks on an element's first page are bare MCIDs; the others are MCRs naming their page.
+    auto checkElement = [&](const char* name, int element, int firstPage, int laterPage) {
+        const std::string& object = objects.at(element);
+        REPORTER_ASSERT(r, has_entry(object, "/Pg " + ref_string(pages[firstPage])),
+                        "%s is not on page %d", name, firstPage);
+        const std::string kids = kids_of(object);
+        REPORTER_ASSERT(r, kids.size() > 1 && isdigit(kids[1]),
+                        "%s does not start with an MCID: %s", name, kids.c_str());
+        for (int page = 0; page < 5; ++page) {
+            const bool hasMCR = has_entry(kids, "/Type /MCR\n/Pg " + ref_string(pages[page]));
+            REPORTER_ASSERT(r, hasMCR == (page == laterPage),
+                            "%s: %s", name, kids.c_str());
+        }
+    };
+    checkElement("Title", title, 0, -1);
+    checkElement("Paragraph", paragraph, 0, 2);
+    checkElement("Section", section, 2, 3);
+
+    // The outline entries point at the page of each header's first mark, and at the header.
+    const int titleEntry = find_object(objects, {"/Title (Title)"});
+    const int sectionEntry = find_object(objects, {"/Title (Section)"});
+    if (!titleEntry || !sectionEntry) {
+        ERRORF(r, "Missing outline entries");
+        return;
+    }
+    REPORTER_ASSERT(r, objects.at(titleEntry).find("/Dest [" + ref_string(pages[0]) + " /XYZ ") !=
+                       std::string::npos);
+    REPORTER_ASSERT(r, has_entry(objects.at(titleEntry), "/SE " + ref_string(title)));
+    REPORTER_ASSERT(r, objects.at(sectionEntry).find("/Dest [" + ref_string(pages[2]) + " /XYZ ") !=
+                       std::string::npos);
+    REPORTER_ASSERT(r, has_entry(objects.at(sectionEntry), "/SE " + ref_string(section)));
+}
 #endif
@@ -17,8 +17,13 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "tests/Test.h"
 
+#include <cstdint>
+#include <iterator>
+
 static void test_drawBitmap(skiatest::Reporter* reporter) {
     SkBitmap src;
     src.allocN32Pixels(10, 10);
@@ -127,3 +132,40 @@ DEF_TEST(QuickReject_MatrixState, reporter) {
     // quickReject() will assert if the matrix is out of sync.
     canvas.quickReject(SkRect::MakeWH(100.0f, 100.0f));
 }
+
+DEF_TEST(QuickReject_Batched, reporter) {
+    SkCanvas canvas(100, 100);
+    canvas.clipRect(SkRect::MakeLTRB(10, 10, 90, 90));
+
+    // More rects than fit in one word of the mask, including non-finite ones.
+    SkRandom rand;
+    SkRect rects[75];
+    for (SkRect& r : rects) {
+        r.setXYWH(rand.nextRangeScalar(-150, 150), rand.nextRangeScalar(-150, 150),
+                  rand.nextRangeScalar(0, 60), rand.nextRangeScalar(0, 60));
+    }
+    rects[3].fLeft = SK_ScalarNaN;
+    rects[40].fBottom = SK_ScalarInfinity;
+
+    SkMatrix persp = SkMatrix::RotateDeg(20);
+    persp.setPerspX(0.005f);
+    for (const SkMatrix& m : {SkMatrix::I(), SkMatrix::Scale(2, 0.5f), SkMatrix::RotateDeg(30),
+                              persp}) {
+        canvas.setMatrix(m);
+
+        uint32_t visible[3] = {~0u, ~0u, ~0u};
+        const int visibleCount = canvas.quickReject(rects, visible);
+
+        int expectedCount = 0;
+        for (int i = 0; i < (int)std::size(rects); ++i) {
+            const bool expected = !canvas.quickReject(rects[i]);
+            expectedCount += expected;
+            REPORTER_ASSERT(reporter, expected == SkToBool(visible[i >> 5] & (1u << (i & 31))),
+                            "rect %d", i);
+        }
+        REPORTER_ASSERT(reporter, visibleCount == expectedCount);
+        REPORTER_ASSERT(reporter, visibleCount > 0 && visibleCount < (int)std::size(rects));
+        // The unused bits of the last word are cleared.
+        REPORTER_ASSERT(reporter, (visible[2] >> (std::size(rects) & 31)) == 0);
+    }
+}
@@ -584,3 +584,33 @@ DEF_TEST(region_very_large, reporter) {
     REPORTER_ASSERT(reporter, smallRegion.contains(499, 0));
     REPORTER_ASSERT(reporter, smallRegion.contains(499, 499));
 }
+
+DEF_TEST(region_setRects_matches_union, reporter) {
+    SkRandom rand;
+    for (int iter = 0; iter < 500; ++iter) {
+        // Include empty rects, touching rects, and gaps between rows of rects.
+        std::array<SkIRect, 40> rects;
+        const int count = 1 + rand.nextU() % rects.size();
+        for (int i = 0; i < count; ++i) {
+            rects[i] = SkIRect::MakeXYWH(rand.nextU() % 50, rand.nextU() % 50,
+                                         rand.nextU() % 20, rand.nextU() % 20);
+        }
+
+        SkRegion expected;
+        for (int i = 0; i < count; ++i) {
+            Union(&expected, rects[i]);
+        }
+        SkRegion actual;
+        REPORTER_ASSERT(reporter, actual.setRects(rects.data(), count) == !expected.isEmpty());
+        REPORTER_ASSERT(reporter, actual == expected);
+
+        SkRegion base({10, 10, 40, 40});
+        expected = base;
+        for (int i = 0; i < count; ++i) {
+            expected.op(rects[i], SkRegion::kDifference_Op);
+        }
+        actual = base;
+        actual.op(rects.data(), count, SkRegion::kDifference_Op);
+        REPORTER_ASSERT(reporter, actual == expected);
+    }
+}
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
@@ -23,6 +25,9 @@
 #include "src/utils/SkShadowTessellator.h"
 #include "tests/Test.h"
 
+#include <cstdint>
+#include <cstdlib>
+
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 
 enum ExpectVerts {
@@ -219,4 +224,66 @@ DEF_TEST(ShadowBounds, reporter) {
     check_bounds(reporter, path);
 }
 
+// Raster shadows of rects, circles and rrects are drawn analytically unless kGeometricOnly is
+// set. Both ways must agree on what is drawn under the occluder, which is only filled when the
+// occluder is transparent, and should be close everywhere else.
+DEF_TEST(ShadowUtils_AnalyticMatchesGeometric, reporter) {
+    constexpr int kSize = 400;
+    const SkRect occluder = SkRect::MakeLTRB(100, 100, 300, 300);
+    SkPath paths[3];
+    paths[0].addRect(occluder);
+    paths[1].addOval(occluder);
+    paths[2].addRRect(SkRRect::MakeRectXY(occluder, 20, 20));
+    const char* kNames[] = {"rect", "circle", "rrect"};
+
+    for (int shape = 0; shape < 3; ++shape)
+    for (bool transparent : {false, true}) {
+        uint32_t flags = transparent ? SkShadowFlags::kTransparentOccluder_ShadowFlag
+                                     : SkShadowFlags::kNone_ShadowFlag;
+        SkBitmap bitmaps[2];
+        for (int geometric = 0; geometric < 2; ++geometric) {
+            bitmaps[geometric].allocN32Pixels(kSize, kSize);
+            bitmaps[geometric].eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(bitmaps[geometric]);
+            SkShadowUtils::DrawShadow(&canvas, paths[shape], {0, 0, 8}, {150, 100, 600}, 400,
+                                      SkColorSetARGB(0x60, 0, 0, 0), SkColorSetARGB(0x80, 0, 0, 0),
+                                      flags | (geometric ? kGeometricOnly_ShadowFlag : 0));
+        }
+
+        auto alpha = [&](int geometric, int x, int y) {
+            return (int)SkColorGetA(bitmaps[geometric].getColor(x, y));
+        };
+
+        // The middle of the occluder, well away from any band drawn under its edges.
+        const int analyticCenter = alpha(0, 200, 200),
+                  geometricCenter = alpha(1, 200, 200);
+        if (transparent) {
+            REPORTER_ASSERT(reporter, analyticCenter > 0 && geometricCenter > 0 &&
+                                      std::abs(analyticCenter - geometricCenter) <= 8,
+                            "%s: center %d vs %d", kNames[shape], analyticCenter,
+                            geometricCenter);
+        } else {
+            REPORTER_ASSERT(reporter, analyticCenter == 0 && geometricCenter == 0,
+                            "%s: center %d vs %d", kNames[shape], analyticCenter,
+                            geometricCenter);
+        }
+
+        // Outside the occluder, the total coverage should be about the same.
+        int64_t outside[2] = {0, 0};
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                if (!occluder.makeOutset(1, 1).contains(x + 0.5f, y + 0.5f)) {
+                    outside[0] += alpha(0, x, y);
+                    outside[1] += alpha(1, x, y);
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, outside[1] > 0 &&
+                                  std::abs(outside[0] - outside[1]) < outside[1] / 5,
+                        "%s (%s): outside coverage %lld vs %lld", kNames[shape],
+                        transparent ? "transparent" : "opaque",
+                        (long long)outside[0], (long long)outside[1]);
+    }
+}
+
 #endif // !defined(SK_ENABLE_OPTIMIZE_SIZE)
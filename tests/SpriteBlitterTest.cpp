@@ -0,0 +1,109 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cmath>
+
+extern bool gSkForceRasterPipelineBlitter;
+
+static SkBitmap make_bitmap(SkColorType ct, int w, int h, bool opaque) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(w, h, ct, opaque ? kOpaque_SkAlphaType
+                                                      : kPremul_SkAlphaType));
+    SkCanvas canvas(bm);
+    canvas.clear(SK_ColorTRANSPARENT);
+    SkPaint paint;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            paint.setColor(SkColorSetARGB(opaque ? 255 : (x * 37 + y * 11) & 0xff,
+                                          x * 13, y * 29, (x + y) * 7));
+            canvas.drawRect(SkRect::MakeXYWH(x, y, 1, 1), paint);
+        }
+    }
+    return bm;
+}
+
+// The planar sprite blitter should match the raster pipeline it stands in for, up to rounding.
+DEF_TEST(SpriteBlitter_MatchesPipeline, r) {
+    const SkColorType kColorTypes[] = {
+        kAlpha_8_SkColorType,
+        kRGB_565_SkColorType,
+        kN32_SkColorType,
+        kRGBA_1010102_SkColorType,
+        kRGBA_F16_SkColorType,
+    };
+    const SkBlendMode kModes[] = { SkBlendMode::kSrc, SkBlendMode::kSrcOver,
+                                   SkBlendMode::kModulate };
+    const float kGrayscale[20] = { 0.21f, 0.72f, 0.07f, 0, 0,
+                                   0.21f, 0.72f, 0.07f, 0, 0,
+                                   0.21f, 0.72f, 0.07f, 0, 0,
+                                   0,     0,     0,     1, 0 };
+    // Wide enough for a full stripe plus a ragged tail.
+    constexpr int kW = 150, kH = 3;
+
+    for (SkColorType srcCT : kColorTypes)
+    for (SkColorType dstCT : kColorTypes)
+    for (SkBlendMode mode : kModes)
+    for (int variant = 0; variant < 3; ++variant) {
+        SkBitmap src = make_bitmap(srcCT, kW, kH, srcCT == kRGB_565_SkColorType);
+        SkBitmap dst[2];
+
+        SkPaint paint;
+        paint.setBlendMode(mode);
+        paint.setColor(SkColorSetARGB(variant == 1 ? 0x80 : 0xff, 0x20, 0x80, 0xc0));
+        if (variant == 2) {
+            paint.setColorFilter(SkColorFilters::Matrix(kGrayscale));
+        }
+
+        for (int forcePipeline = 0; forcePipeline < 2; ++forcePipeline) {
+            dst[forcePipeline] = make_bitmap(dstCT, kW + 2, kH + 2,
+                                             dstCT == kRGB_565_SkColorType);
+            gSkForceRasterPipelineBlitter = forcePipeline;
+            SkCanvas canvas(dst[forcePipeline]);
+            canvas.drawImage(src.asImage(), 1, 1, SkSamplingOptions(), &paint);
+        }
+        gSkForceRasterPipelineBlitter = false;
+
+        // One step of each destination channel, plus float error. That is 5 bits for red and
+        // blue in 565 and 6 bits for green, 2 bits for alpha in 1010102, and otherwise 8 bits.
+        float tolerance[4] = {1 / 255.f, 1 / 255.f, 1 / 255.f, 1 / 255.f};
+        if (dstCT == kRGB_565_SkColorType) {
+            tolerance[0] = tolerance[2] = 1 / 31.f;
+            tolerance[1] = 1 / 63.f;
+        } else if (dstCT == kRGBA_1010102_SkColorType) {
+            tolerance[3] = 1 / 3.f;
+        }
+        float maxDiff[4] = {0, 0, 0, 0};
+        for (int y = 0; y < kH + 2; ++y) {
+            for (int x = 0; x < kW + 2; ++x) {
+                const SkColor4f a = dst[0].pixmap().getColor4f(x, y),
+                                b = dst[1].pixmap().getColor4f(x, y);
+                for (int c = 0; c < 4; ++c) {
+                    maxDiff[c] = std::max(maxDiff[c], std::fabs(a[c] - b[c]));
+                }
+            }
+        }
+        for (int c = 0; c < 4; ++c) {
+            REPORTER_ASSERT(r, maxDiff[c] <= tolerance[c] + 0.002f,
+                            "src %d, dst %d, mode %d, variant %d: channel %d diff %g",
+                            srcCT, dstCT, (int)mode, variant, c, maxDiff[c]);
+        }
+    }
+}
@@ -308,3 +308,35 @@ DEF_TEST(chartoglyph_cache, reporter) {
         }
     }
 }
+
+DEF_TEST(chartoglyph_pages, reporter) {
+    SkCharToGlyphPages pages;
+    int loads = 0;
+    auto fill = [&](SkUnichar base, SkGlyphID glyphs[]) {
+        REPORTER_ASSERT(reporter, base % SkCharToGlyphPages::kPageSize == 0);
+        for (int i = 0; i < SkCharToGlyphPages::kPageSize; ++i) {
+            glyphs[i] = hash_to_glyph(base + i);
+        }
+        ++loads;
+    };
+
+    SkGlyphID glyph;
+    REPORTER_ASSERT(reporter, !pages.find('A', &glyph));
+    REPORTER_ASSERT(reporter, pages.loadPage('A', fill) == hash_to_glyph('A'));
+    REPORTER_ASSERT(reporter, loads == 1);
+
+    // The whole page came in with 'A', and loading it again does nothing.
+    for (SkUnichar c = 0; c < SkCharToGlyphPages::kPageSize; ++c) {
+        REPORTER_ASSERT(reporter, pages.find(c, &glyph) && glyph == hash_to_glyph(c));
+    }
+    REPORTER_ASSERT(reporter, pages.loadPage('z', fill) == hash_to_glyph('z'));
+    REPORTER_ASSERT(reporter, loads == 1);
+
+    // Other pages are still to be loaded, and beyond the BMP is never covered.
+    REPORTER_ASSERT(reporter, !pages.find(0x4E2D, &glyph));
+    REPORTER_ASSERT(reporter, pages.loadPage(0xFFFF, fill) == hash_to_glyph(0xFFFF));
+    REPORTER_ASSERT(reporter, pages.find(0xFF00, &glyph) && glyph == hash_to_glyph(0xFF00));
+    REPORTER_ASSERT(reporter, !SkCharToGlyphPages::Covers(0x10000));
+    REPORTER_ASSERT(reporter, !pages.find(0x10000, &glyph));
+    REPORTER_ASSERT(reporter, !pages.find(-1, &glyph));
+}
@@ -8,6 +8,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
@@ -22,6 +23,8 @@
 #include "tools/ToolUtils.h"
 
 #include <cstdint>
+#include <iterator>
+#include <vector>
 
 static bool equal(const SkVertices* vert0, const SkVertices* vert1) {
     SkVerticesPriv v0(vert0->priv()), v1(vert1->priv());
@@ -172,3 +175,50 @@ DEF_TEST(Vertices_clipping, reporter) {
         }
     }
 }
+
+// Meshes mix small triangles, which the raster backend fills with its own span walker, and large
+// ones, which go through SkScan. Triangles that share an edge must still cover every pixel once.
+DEF_TEST(Vertices_sharedEdges, reporter) {
+    constexpr int kW = 700, kH = 500;
+    auto surf = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(kW, kH));
+    surf->getCanvas()->clear(SK_ColorTRANSPARENT);
+
+    // Cells range from a fraction of a pixel to several hundred pixels across.
+    const float xs[] = {0.3f, 2.7f, 3.1f, 280.6f, 281.2f, 290.9f, 640.4f, 641.1f, 699.6f};
+    const float ys[] = {0.2f, 1.9f, 260.7f, 262.3f, 271.5f, 499.5f};
+    std::vector<SkPoint> pts;
+    for (size_t j = 0; j + 1 < std::size(ys); ++j) {
+        for (size_t i = 0; i + 1 < std::size(xs); ++i) {
+            const SkPoint tl = {xs[i], ys[j]}, tr = {xs[i + 1], ys[j]},
+                          bl = {xs[i], ys[j + 1]}, br = {xs[i + 1], ys[j + 1]};
+            // Alternate the diagonal so that edges run in both directions.
+            if ((i + j) & 1) {
+                pts.insert(pts.end(), {tl, tr, br, tl, br, bl});
+            } else {
+                pts.insert(pts.end(), {tl, tr, bl, tr, br, bl});
+            }
+        }
+    }
+    auto verts = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, (int)pts.size(),
+                                      pts.data(), nullptr, nullptr);
+
+    // Each hit adds 0x20 to every channel.
+    SkPaint paint;
+    paint.setColor(SkColorSetARGB(0x20, 0xFF, 0xFF, 0xFF));
+    paint.setBlendMode(SkBlendMode::kPlus);
+    surf->getCanvas()->drawVertices(verts, SkBlendMode::kModulate, paint);
+
+    ToolUtils::PixelIter iter(surf.get());
+    SkIPoint loc;
+    int gaps = 0, overlaps = 0;
+    while (void* addr = iter.next(&loc)) {
+        const U8CPU a = SkGetPackedA32(*(SkPMColor*)addr);
+        const bool interior = loc.fX >= 1 && loc.fX < kW - 1 && loc.fY >= 1 && loc.fY < kH - 1;
+        if (a > 0x20) {
+            overlaps++;
+        } else if (a == 0 && interior) {
+            gaps++;
+        }
+    }
+    REPORTER_ASSERT(reporter, gaps == 0 && overlaps == 0, "%d gaps, %d overlaps", gaps, overlaps);
+}
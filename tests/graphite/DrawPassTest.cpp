@@ -7,11 +7,29 @@
 
 #include "tests/Test.h"
 
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkBlender.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkGradientShader.h"
 #include "src/gpu/graphite/ContextPriv.h"
+#include "src/gpu/graphite/ContextUtils.h"
 #include "src/gpu/graphite/DrawList.h"
 #include "src/gpu/graphite/DrawPass.h"
+#include "src/gpu/graphite/PaintParams.h"
+#include "src/gpu/graphite/PaintParamsKey.h"
+#include "src/gpu/graphite/PipelineData.h"
 #include "src/gpu/graphite/RecorderPriv.h"
 #include "src/gpu/graphite/RendererProvider.h"
+#include "src/gpu/graphite/geom/Geometry.h"
+#include "src/gpu/graphite/geom/Shape.h"
+
+#include <tuple>
+#include <vector>
 
 namespace skgpu::graphite {
 
@@ -66,4 +84,72 @@ DEF_GRAPHITE_TEST_FOR_ALL_CONTEXTS(DrawPassTestFailedDstCopy,
     REPORTER_ASSERT(reporter, !drawPass);
 }
 
+
+// Draws in a pass that repeat a paint reuse what was extracted for its first draw. That must be
+// exactly what extracting it again would give, and paints that differ only in a uniform or in how
+// they read the dst must not share an entry.
+DEF_GRAPHITE_TEST_FOR_ALL_CONTEXTS(DrawPassTestPaintDataCache,
+                                   reporter,
+                                   context,
+                                   CtsEnforcement::kNextRelease) {
+    std::unique_ptr<Recorder> recorder = context->makeRecorder();
+    PaintParamsKeyBuilder builder(recorder->priv().shaderCodeDictionary());
+    PipelineDataGatherer gatherer(recorder->priv().caps(), Layout::kStd140);
+    const Geometry geometry(Shape(SkRect::MakeWH(16, 16)));
+    const SkColorInfo targetColorInfo(kRGBA_8888_SkColorType, kPremul_SkAlphaType, nullptr);
+    const SkM44 local2Dev = SkM44::Scale(2, 2);
+
+    sk_sp<SkColorFilter> colorFilter = SkColorFilters::Blend(0x80FF8000, SkBlendMode::kMultiply);
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+    red.setColorFilter(colorFilter);
+    red.setBlendMode(SkBlendMode::kMultiply);
+    SkPaint green = red;
+    green.setColor(SK_ColorGREEN);
+
+    const SkPoint pts[] = {{0, 0}, {16, 16}};
+    const SkColor4f colors[] = {SkColors::kRed, SkColors::kBlue};
+    SkPaint gradient = red;
+    gradient.setShader(SkGradientShader::MakeLinear(pts, colors, /*colorSpace=*/nullptr,
+                                                    /*pos=*/nullptr, 2, SkTileMode::kClamp));
+
+    auto params = [](const SkPaint& paint, DstReadRequirement dstReadReq) {
+        return PaintParams(paint, nullptr, nullptr, dstReadReq, /*skipColorXform=*/false);
+    };
+    const struct {
+        PaintParams fParams;
+        int         fExpectedCount;
+    } kDraws[] = {
+        {params(red,          DstReadRequirement::kNone),             1},
+        {params(SkPaint(red), DstReadRequirement::kNone),             1},  // repeated
+        {params(green,        DstReadRequirement::kNone),             2},  // differs in a uniform
+        {params(red,          DstReadRequirement::kFramebufferFetch), 3},  // differs in dst read
+        {params(gradient,     DstReadRequirement::kNone),             4},
+        {params(red,          DstReadRequirement::kNone),             4},  // repeated
+        {params(gradient,     DstReadRequirement::kNone),             4},  // repeated
+    };
+
+    PaintDataCache cache;
+    std::vector<PaintDataCache::PaintData> results;
+    for (const auto& draw : kDraws) {
+        auto expected = ExtractPaintData(recorder.get(), &gatherer, &builder, Layout::kStd140,
+                                         local2Dev, draw.fParams, geometry, /*dstTexture=*/nullptr,
+                                         /*dstOffset=*/{0, 0}, targetColorInfo);
+        auto actual = cache.extract(recorder.get(), &gatherer, &builder, Layout::kStd140,
+                                    local2Dev, draw.fParams, geometry, /*dstTexture=*/nullptr,
+                                    /*dstOffset=*/{0, 0}, targetColorInfo);
+        REPORTER_ASSERT(reporter, std::get<0>(actual).isValid());
+        REPORTER_ASSERT(reporter, actual == expected);
+        REPORTER_ASSERT(reporter, cache.count() == draw.fExpectedCount,
+                        "%d paints cached, expected %d", cache.count(), draw.fExpectedCount);
+        results.push_back(actual);
+    }
+
+    // Same program, different uniforms.
+    REPORTER_ASSERT(reporter, std::get<0>(results[0]) == std::get<0>(results[2]));
+    REPORTER_ASSERT(reporter, std::get<1>(results[0]) != std::get<1>(results[2]));
+    // Reading the dst needs a different program.
+    REPORTER_ASSERT(reporter, std::get<0>(results[0]) != std::get<0>(results[3]));
+}
+
 }  // namespace skgpu::graphite
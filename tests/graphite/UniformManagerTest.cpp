@@ -885,3 +885,63 @@ DEF_GRAPHITE_TEST(UniformManagerStd430MatrixLayoutContents, r, CtsEnforcement::k
         mgr.reset();
     }
 }
+
+DEF_GRAPHITE_TEST(UniformManagerWriteUniformList, r, CtsEnforcement::kNextRelease) {
+    // Writing a tightly packed list of uniforms at once must produce the same block as writing
+    // them one at a time, whether or not they can be coalesced into a single copy.
+    static constexpr Uniform kUniforms[] = {
+            {"m",  SkSLType::kFloat4x4},
+            {"a",  SkSLType::kFloat4},
+            {"b",  SkSLType::kFloat2},
+            {"c",  SkSLType::kFloat},
+            {"d",  SkSLType::kInt},
+            {"e",  SkSLType::kFloat3},
+            {"f",  SkSLType::kHalf4},
+            {"g",  SkSLType::kFloat2, 3},
+            {"h",  SkSLType::kHalf},
+            {"i",  SkSLType::kFloat3x3},
+            {"j",  SkSLType::kInt4},
+            {"k",  SkSLType::kFloat2x2},
+    };
+    float values[16 + 4 + 2 + 1 + 1 + 3 + 4 + 6 + 1 + 9 + 4 + 4];
+    for (size_t i = 0; i < std::size(values); ++i) {
+        values[i] = static_cast<float>(i + 1);
+    }
+
+    for (Layout layout : kLayouts) {
+        for (size_t start = 0; start < std::size(kUniforms); ++start) {
+            SkSpan<const Uniform> uniforms = SkSpan(kUniforms).subspan(start);
+            const float* src = values;
+            for (size_t i = 0; i < start; ++i) {
+                const int matrixSize = SkSLTypeMatrixSize(kUniforms[i].type());
+                src += (matrixSize > 0 ? matrixSize * matrixSize
+                                       : SkSLTypeVecLength(kUniforms[i].type())) *
+                       std::max(kUniforms[i].count(), 1);
+            }
+
+            UniformManager oneAtATime(layout);
+            SkDEBUGCODE(oneAtATime.setExpectedUniforms(uniforms);)
+            const float* uniformSrc = src;
+            for (const Uniform& u : uniforms) {
+                oneAtATime.write(u, uniformSrc);
+                const int matrixSize = SkSLTypeMatrixSize(u.type());
+                uniformSrc += (matrixSize > 0 ? matrixSize * matrixSize
+                                              : SkSLTypeVecLength(u.type())) *
+                              std::max(u.count(), 1);
+            }
+            SkDEBUGCODE(oneAtATime.doneWithExpectedUniforms();)
+
+            UniformManager all(layout);
+            SkDEBUGCODE(all.setExpectedUniforms(uniforms);)
+            all.write(uniforms, src);
+            SkDEBUGCODE(all.doneWithExpectedUniforms();)
+
+            const UniformDataBlock expected = oneAtATime.finishUniformDataBlock();
+            const UniformDataBlock actual = all.finishUniformDataBlock();
+            REPORTER_ASSERT(r, expected == actual, "Layout: %s - First uniform: %zu",
+                            LayoutString(layout), start);
+            REPORTER_ASSERT(r, actual.hash() == UniformDataBlock(SkSpan(actual.data(),
+                                                                        actual.size())).hash());
+        }
+    }
+}
@@ -37,8 +37,10 @@ CORE_TESTS = [
     "DataRefTest.cpp",
     "DequeTest.cpp",
     "DescriptorTest.cpp",
+    "DistanceFieldGenTest.cpp",
     "DrawBitmapRectTest.cpp",
     "DrawPathTest.cpp",
+    "DrawRRectSetTest.cpp",
     "EmptyPathTest.cpp",
     "F16StagesTest.cpp",
     "FillPathTest.cpp",
@@ -135,6 +137,7 @@ CORE_TESTS = [
     "SkVxTest.cpp",
     "SkXmpTest.cpp",
     "SortTest.cpp",
+    "SpriteBlitterTest.cpp",
     "SrcOverTest.cpp",
     "StreamTest.cpp",
     "StringTest.cpp",
@@ -165,6 +168,11 @@ FONT_TESTS = [
     "SkStrikeTest.cpp",
 ]
 
+GANESH_TESTS = [
+    "DiskProgramCacheTest.cpp",
+    "GrProgramDescTest.cpp",
+]
+
 JSON_TESTS = [
     "JSONTest.cpp",
 ]
@@ -271,6 +271,18 @@ protected:
                                                                         constraint);
     }
 
+    void onDrawRRectSet(const SkRRect rrects[],
+                        const SkColor4f colors[],
+                        int count,
+                        const SkMatrix preViewMatrices[],
+                        const SkPaint& paint) override {
+        fRecorder.getRecordingCanvas()->experimental_DrawRRectSet(rrects,
+                                                                  colors,
+                                                                  count,
+                                                                  preViewMatrices,
+                                                                  paint);
+    }
+
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     void onDrawEdgeAAQuad(const SkRect& rect,
                           const SkPoint clip[4],
@@ -618,6 +618,26 @@ void DebugCanvas::onDrawEdgeAAImageSet2(const ImageSetEntry set[],
             set, count, dstClips, preViewMatrices, sampling, paint, constraint));
 }
 
+void DebugCanvas::onDrawRRectSet(const SkRRect   rrects[],
+                                 const SkColor4f colors[],
+                                 int             count,
+                                 const SkMatrix  preViewMatrices[],
+                                 const SkPaint&  paint) {
+    // There is no dedicated command; record the set as the individual draws it stands for.
+    SkPaint entryPaint(paint);
+    for (int i = 0; i < count; ++i) {
+        entryPaint.setColor(colors[i]);
+        if (preViewMatrices) {
+            this->save();
+            this->concat(preViewMatrices[i]);
+        }
+        this->drawRRect(rrects[i], entryPaint);
+        if (preViewMatrices) {
+            this->restore();
+        }
+    }
+}
+
 void DebugCanvas::willRestore() {
     this->addDrawCommand(new RestoreCommand());
     this->INHERITED::willRestore();
@@ -221,6 +221,11 @@ protected:
                                const SkSamplingOptions&,
                                const SkPaint*,
                                SrcRectConstraint) override;
+    void onDrawRRectSet(const SkRRect[],
+                        const SkColor4f[],
+                        int count,
+                        const SkMatrix[],
+                        const SkPaint&) override;
 
 private:
     SkTDArray<DrawCommand*> fCommandVector;
@@ -0,0 +1,501 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "tools/gpu/DiskProgramCache.h"
+
+#include "include/core/SkStream.h"
+#include "src/base/SkTime.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/utils/SkOSPath.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace skia_private;
+
+namespace sk_gpu_test {
+
+static constexpr uint32_t kIndexMagic = SkSetFourByteTag('S', 'K', 'P', 'C');
+static constexpr uint32_t kIndexVersion = 1;
+static constexpr char kIndexName[] = "index.skpc";
+static constexpr char kBlobSuffix[] = ".skpc";
+static constexpr char kTempSuffix[] = ".tmp";
+
+// Writes the file next to 'path' and then renames it into place, so that a crash or a full disk
+// never leaves a truncated index or blob under the real name.
+static bool write_file_atomically(const SkString& path, const void* data, size_t size) {
+    SkString tempPath = path;
+    tempPath.append(kTempSuffix);
+    bool ok;
+    {
+        SkFILEWStream out(tempPath.c_str());
+        ok = out.isValid() && out.write(data, size);
+        if (ok) {
+            out.fsync();
+        }
+    }
+    if (ok && rename(tempPath.c_str(), path.c_str()) != 0) {
+        // Windows won't rename over an existing file.
+        remove(path.c_str());
+        ok = rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+    if (!ok) {
+        remove(tempPath.c_str());
+    }
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compression
+//
+// Programs (SkSL, GLSL, SPIR-V and their metadata) are full of repeated identifiers and
+// boilerplate, so a simple LZ77 block format in the style of LZ4 compresses them well and
+// decompresses at memcpy-like speeds. A block is the uncompressed size (u32) followed by sequences
+// of:
+//    token:    high nibble is the literal count, low nibble is the match length - 4. A nibble of
+//              15 means the count continues in following bytes, each adding up to 255.
+//    literals
+//    offset:   u16, distance back to the start of the match
+// The final sequence has only literals and ends the block.
+
+static constexpr int kMinMatch = 4;
+static constexpr int kHashBits = 12;
+static constexpr size_t kMaxOffset = 0xFFFF;
+
+static uint32_t read_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void write_length(SkWStream* out, size_t length) {
+    while (length >= 255) {
+        out->write8(255);
+        length -= 255;
+    }
+    out->write8(SkToU8(length));
+}
+
+static void write_sequence(SkWStream* out, const uint8_t* literals, size_t literalCount,
+                           size_t offset, size_t matchLength) {
+    const size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+    out->write8(SkToU8((std::min<size_t>(literalCount, 15) << 4) |
+                        std::min<size_t>(matchCode, 15)));
+    if (literalCount >= 15) {
+        write_length(out, literalCount - 15);
+    }
+    out->write(literals, literalCount);
+    if (matchLength) {
+        out->write16(SkToU16(offset));
+        if (matchCode >= 15) {
+            write_length(out, matchCode - 15);
+        }
+    }
+}
+
+sk_sp<SkData> DiskProgramCache::Compress(const void* data, size_t size) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    SkDynamicMemoryWStream out;
+    out.write32(SkToU32(size));
+
+    int32_t table[1 << kHashBits];
+    std::fill(std::begin(table), std::end(table), -1);
+
+    size_t anchor = 0;
+    for (size_t pos = 0; pos + kMinMatch <= size;) {
+        const uint32_t seq = read_u32(src + pos);
+        const uint32_t slot = (seq * 2654435761u) >> (32 - kHashBits);
+        const int32_t candidate = table[slot];
+        table[slot] = SkToS32(pos);
+
+        if (candidate < 0 || pos - candidate > kMaxOffset || read_u32(src + candidate) != seq) {
+            ++pos;
+            continue;
+        }
+
+        size_t length = kMinMatch;
+        while (pos + length < size && src[candidate + length] == src[pos + length]) {
+            ++length;
+        }
+        write_sequence(&out, src + anchor, pos - anchor, pos - candidate, length);
+        pos += length;
+        anchor = pos;
+    }
+    write_sequence(&out, src + anchor, size - anchor, 0, 0);
+
+    return out.detachAsData();
+}
+
+sk_sp<SkData> DiskProgramCache::Decompress(const void* data, size_t size) {
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = in + size;
+    if (size < sizeof(uint32_t)) {
+        return nullptr;
+    }
+    const size_t dstSize = read_u32(in);
+    in += sizeof(uint32_t);
+    // Each input byte can expand to at most 255 output bytes, so reject sizes a corrupt header
+    // might claim before allocating for them.
+    if (dstSize > (size - sizeof(uint32_t)) * 255) {
+        return nullptr;
+    }
+
+    sk_sp<SkData> result = SkData::MakeUninitialized(dstSize);
+    uint8_t* const dst = static_cast<uint8_t*>(result->writable_data());
+    size_t written = 0;
+
+    auto readLength = [&](size_t* length) {
+        uint8_t b;
+        do {
+            if (in >= end) {
+                return false;
+            }
+            b = *in++;
+            *length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (in < end) {
+        const uint8_t token = *in++;
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(&literalCount)) {
+            return nullptr;
+        }
+        if (literalCount > SkToSizeT(end - in) || literalCount > dstSize - written) {
+            return nullptr;
+        }
+        memcpy(dst + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+
+        if (in == end) {
+            break;  // The final sequence has no match.
+        }
+        if (end - in < 2) {
+            return nullptr;
+        }
+        const size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(&matchLength)) {
+            return nullptr;
+        }
+        matchLength += kMinMatch;
+        if (offset == 0 || offset > written || matchLength > dstSize - written) {
+            return nullptr;
+        }
+        // Matches may overlap the bytes they produce, so copy forwards one byte at a time.
+        for (size_t i = 0; i < matchLength; ++i, ++written) {
+            dst[written] = dst[written - offset];
+        }
+    }
+
+    return written == dstSize ? result : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+DiskProgramCache::DiskProgramCache(const char* directory, SkExecutor* prefetchExecutor)
+        : fDirectory(directory) {
+    if (!sk_isdir(directory)) {
+        sk_mkdir(directory);
+    }
+
+    const double start = SkTime::GetMSecs();
+    this->readIndex();
+    this->removeUnreferencedFiles();
+    fStats.fIndexLoadMs = SkTime::GetMSecs() - start;
+
+    if (prefetchExecutor && !fEntries.empty()) {
+        fPrefetchTasks = std::make_unique<SkTaskGroup>(*prefetchExecutor);
+        fPrefetchTasks->add([this] { this->prefetch(); });
+    }
+}
+
+DiskProgramCache::~DiskProgramCache() {
+    this->waitForPrefetch();
+    if (fIndexDirty) {
+        this->flush();
+    }
+}
+
+SkString DiskProgramCache::blobPath(const SkMD5::Digest& digest) const {
+    SkString name = digest.toLowercaseHexString();
+    name.append(kBlobSuffix);
+    return SkOSPath::Join(fDirectory.c_str(), name.c_str());
+}
+
+void DiskProgramCache::removeUnreferencedFiles() {
+    THashSet<SkString> blobNames;
+    fBlobs.foreach([&](const SkMD5::Digest& digest, const std::pair<size_t, size_t>&) {
+        SkString name = digest.toLowercaseHexString();
+        name.append(kBlobSuffix);
+        blobNames.add(std::move(name));
+    });
+
+    // Blobs that the index doesn't mention, and temporary files left by an interrupted write.
+    SkString name;
+    SkOSFile::Iter blobs(fDirectory.c_str(), kBlobSuffix);
+    while (blobs.next(&name)) {
+        if (!name.equals(kIndexName) && !blobNames.contains(name)) {
+            remove(SkOSPath::Join(fDirectory.c_str(), name.c_str()).c_str());
+        }
+    }
+    SkOSFile::Iter temps(fDirectory.c_str(), kTempSuffix);
+    while (temps.next(&name)) {
+        remove(SkOSPath::Join(fDirectory.c_str(), name.c_str()).c_str());
+    }
+}
+
+void DiskProgramCache::releaseBlob(const SkMD5::Digest& digest) {
+    for (const Entry& entry : fEntries) {
+        if (entry.fDigest == digest) {
+            return;
+        }
+    }
+    fBlobs.remove(digest);
+    remove(this->blobPath(digest).c_str());
+}
+
+bool DiskProgramCache::readIndex() {
+    SkString path = SkOSPath::Join(fDirectory.c_str(), kIndexName);
+    sk_sp<SkData> indexData = SkData::MakeFromFileName(path.c_str());
+    if (!indexData) {
+        return false;
+    }
+
+    SkMemoryStream stream(std::move(indexData));
+    uint32_t magic, version, count;
+    if (!stream.readU32(&magic) || magic != kIndexMagic ||
+        !stream.readU32(&version) || version != kIndexVersion ||
+        !stream.readU32(&count) || count > stream.getLength()) {
+        return false;
+    }
+
+    TArray<Entry> entries;
+    THashMap<SkMD5::Digest, std::pair<size_t, size_t>, DigestHash> blobs;
+    entries.reserve_exact(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Entry entry;
+        uint32_t keySize, descriptionSize, hitCount, dataSize, diskSize;
+        if (!stream.readU32(&keySize) || keySize > stream.getLength()) {
+            return false;
+        }
+        sk_sp<SkData> key = SkData::MakeUninitialized(keySize);
+        if (stream.read(key->writable_data(), keySize) != keySize ||
+            stream.read(entry.fDigest.data, sizeof(entry.fDigest.data)) !=
+                    sizeof(entry.fDigest.data) ||
+            !stream.readU32(&hitCount) ||
+            !stream.readU32(&dataSize) ||
+            !stream.readU32(&diskSize) ||
+            !stream.readU32(&descriptionSize) || descriptionSize > stream.getLength()) {
+            return false;
+        }
+        entry.fDescription.resize(descriptionSize);
+        if (stream.read(entry.fDescription.data(), descriptionSize) != descriptionSize) {
+            return false;
+        }
+        entry.fKey = std::move(key);
+        entry.fHitCount = SkToInt(hitCount);
+        blobs.set(entry.fDigest, {dataSize, diskSize});
+        entries.push_back(std::move(entry));
+    }
+
+    // Rank by usage so that the prefetch (and foreach) visit the hottest programs first.
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.fHitCount > b.fHitCount;
+    });
+    fEntries = std::move(entries);
+    fBlobs = std::move(blobs);
+    for (int i = 0; i < fEntries.size(); ++i) {
+        fKeyToEntry.set(KeyRef{fEntries[i].fKey.get()}, i);
+    }
+    return true;
+}
+
+bool DiskProgramCache::flush() {
+    // Entries whose blob couldn't be read are left out until they're stored again.
+    int count = 0;
+    for (const Entry& entry : fEntries) {
+        count += fBlobs.find(entry.fDigest) ? 1 : 0;
+    }
+
+    SkDynamicMemoryWStream out;
+    bool ok = out.write32(kIndexMagic) &&
+              out.write32(kIndexVersion) &&
+              out.write32(SkToU32(count));
+    for (const Entry& entry : fEntries) {
+        const std::pair<size_t, size_t>* sizes = fBlobs.find(entry.fDigest);
+        if (!sizes) {
+            continue;
+        }
+        ok = ok &&
+             out.write32(SkToU32(entry.fKey->size())) &&
+             out.write(entry.fKey->data(), entry.fKey->size()) &&
+             out.write(entry.fDigest.data, sizeof(entry.fDigest.data)) &&
+             out.write32(SkToU32(entry.fHitCount)) &&
+             out.write32(SkToU32(sizes->first)) &&
+             out.write32(SkToU32(sizes->second)) &&
+             out.write32(SkToU32(entry.fDescription.size())) &&
+             out.write(entry.fDescription.c_str(), entry.fDescription.size());
+    }
+    sk_sp<SkData> index = out.detachAsData();
+    ok = ok && write_file_atomically(SkOSPath::Join(fDirectory.c_str(), kIndexName),
+                                     index->data(), index->size());
+    if (ok) {
+        fIndexDirty = false;
+    }
+    return ok;
+}
+
+sk_sp<SkData> DiskProgramCache::readBlob(const SkMD5::Digest& digest, size_t* diskSize) const {
+    sk_sp<SkData> compressed = SkData::MakeFromFileName(this->blobPath(digest).c_str());
+    if (!compressed) {
+        return nullptr;
+    }
+    if (diskSize) {
+        *diskSize = compressed->size();
+    }
+    return Decompress(compressed->data(), compressed->size());
+}
+
+void DiskProgramCache::prefetch() {
+    const double start = SkTime::GetMSecs();
+
+    // Snapshot the digests so that store() can append entries while this runs.
+    TArray<SkMD5::Digest> digests;
+    {
+        SkAutoMutexExclusive lock(fDataMutex);
+        digests.reserve_exact(fEntries.size());
+        for (const Entry& entry : fEntries) {
+            digests.push_back(entry.fDigest);
+        }
+    }
+
+    THashMap<SkMD5::Digest, sk_sp<SkData>, DigestHash> loaded;
+    for (int i = 0; i < digests.size(); ++i) {
+        {
+            SkAutoMutexExclusive lock(fDataMutex);
+            if (fEntries[i].fData) {
+                continue;  // Already loaded on demand.
+            }
+        }
+        // Entries sharing a blob share its data.
+        sk_sp<SkData>* data = loaded.find(digests[i]);
+        if (!data) {
+            data = loaded.set(digests[i], this->readBlob(digests[i], nullptr));
+        }
+
+        SkAutoMutexExclusive lock(fDataMutex);
+        if (!fEntries[i].fData) {
+            fEntries[i].fData = *data;
+        }
+    }
+
+    SkAutoMutexExclusive lock(fDataMutex);
+    fStats.fPrefetchMs = SkTime::GetMSecs() - start;
+}
+
+void DiskProgramCache::waitForPrefetch() {
+    if (fPrefetchTasks) {
+        fPrefetchTasks->wait();
+    }
+}
+
+sk_sp<SkData> DiskProgramCache::entryData(int index) {
+    {
+        SkAutoMutexExclusive lock(fDataMutex);
+        if (fEntries[index].fData) {
+            ++fStats.fPrefetchHits;
+            return fEntries[index].fData;
+        }
+    }
+    sk_sp<SkData> data = this->readBlob(fEntries[index].fDigest, nullptr);
+
+    SkAutoMutexExclusive lock(fDataMutex);
+    ++fStats.fDiskLoads;
+    if (!fEntries[index].fData) {
+        fEntries[index].fData = data;
+    }
+    return fEntries[index].fData;
+}
+
+sk_sp<SkData> DiskProgramCache::load(const SkData& key) {
+    const int* index = fKeyToEntry.find(KeyRef{&key});
+    if (!index) {
+        SkAutoMutexExclusive lock(fDataMutex);
+        ++fStats.fMisses;
+        return nullptr;
+    }
+
+    sk_sp<SkData> data = this->entryData(*index);
+    if (!data) {
+        // The blob is missing or corrupt; treat it as a miss and forget the blob, so that the
+        // program's store() writes it again rather than assuming it's already on disk.
+        SkAutoMutexExclusive lock(fDataMutex);
+        ++fStats.fMisses;
+        fBlobs.remove(fEntries[*index].fDigest);
+        return nullptr;
+    }
+    fEntries[*index].fHitCount++;
+    fIndexDirty = true;
+    return data;
+}
+
+void DiskProgramCache::store(const SkData& key, const SkData& data, const SkString& description) {
+    SkMD5 md5;
+    md5.write(data.data(), data.size());
+    const SkMD5::Digest digest = md5.finish();
+
+    if (!fBlobs.find(digest)) {
+        sk_sp<SkData> compressed = Compress(data.data(), data.size());
+        if (!write_file_atomically(this->blobPath(digest), compressed->data(),
+                                   compressed->size())) {
+            return;
+        }
+        fBlobs.set(digest, {data.size(), compressed->size()});
+    }
+
+    sk_sp<SkData> dataCopy = SkData::MakeWithCopy(data.data(), data.size());
+    SkAutoMutexExclusive lock(fDataMutex);
+    ++fStats.fStores;
+    if (const int* index = fKeyToEntry.find(KeyRef{&key})) {
+        Entry& entry = fEntries[*index];
+        const SkMD5::Digest oldDigest = entry.fDigest;
+        entry.fDigest = digest;
+        entry.fDescription = description;
+        entry.fData = std::move(dataCopy);
+        if (oldDigest != digest) {
+            this->releaseBlob(oldDigest);
+        }
+    } else {
+        Entry& entry = fEntries.push_back();
+        entry.fKey = SkData::MakeWithCopy(key.data(), key.size());
+        entry.fDigest = digest;
+        entry.fDescription = description;
+        entry.fData = std::move(dataCopy);
+        // The map keys point at the entries' SkData, which doesn't move when fEntries grows.
+        fKeyToEntry.set(KeyRef{entry.fKey.get()}, fEntries.size() - 1);
+    }
+    fIndexDirty = true;
+}
+
+DiskProgramCache::Stats DiskProgramCache::stats() const {
+    SkAutoMutexExclusive lock(fDataMutex);
+    Stats stats = fStats;
+    stats.fEntries = fEntries.size();
+    stats.fBlobs = fBlobs.count();
+    fBlobs.foreach([&](const SkMD5::Digest&, const std::pair<size_t, size_t>& sizes) {
+        stats.fDataBytes += sizes.first;
+        stats.fDiskBytes += sizes.second;
+    });
+    return stats;
+}
+
+}  // namespace sk_gpu_test
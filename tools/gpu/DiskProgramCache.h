@@ -0,0 +1,145 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef DiskProgramCache_DEFINED
+#define DiskProgramCache_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkString.h"
+#include "include/gpu/GrContextOptions.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTArray.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkTHash.h"
+
+#include <memory>
+
+class SkExecutor;
+class SkTaskGroup;
+
+namespace sk_gpu_test {
+
+/**
+ * A GrContextOptions::PersistentCache that keeps programs in a directory across runs.
+ *
+ * Program data is content-addressed: each distinct blob is compressed and written once to
+ * "<dir>/<md5 of the data>.skpc", no matter how many keys map to it. An index file records the
+ * keys, the blob each one uses and how often it was loaded. When a cache is opened the entries are
+ * ranked by that count, and if an executor is provided, the blobs are read and decompressed on it
+ * in rank order so that the hottest programs are in memory before the GrContext asks for them.
+ *
+ * Like MemoryCache, a DiskProgramCache should only be shared by GrContexts with the same options
+ * and caps. Stores go to disk immediately; the index is written by flush() and on destruction.
+ * Blobs and the index are written to a temporary file and renamed into place, and blobs that no
+ * entry refers to any more are deleted.
+ *
+ * This is a test tool, not part of the library: it lives in tools/gpu next to MemoryCache, so dm,
+ * viewer and the tests can use it, but applications that link only Skia can't. They still supply
+ * their own PersistentCache and may use this one as a model.
+ */
+class DiskProgramCache : public GrContextOptions::PersistentCache {
+public:
+    struct Stats {
+        int    fEntries = 0;            // keys in the index
+        int    fBlobs = 0;              // distinct program blobs on disk
+        size_t fDataBytes = 0;          // uncompressed size of the blobs
+        size_t fDiskBytes = 0;          // compressed size of the blobs
+        double fIndexLoadMs = 0;        // time to read and rank the index when opening
+        double fPrefetchMs = 0;         // time for the background prefetch to load every blob
+        int    fPrefetchHits = 0;       // loads that found their data already prefetched
+        int    fDiskLoads = 0;          // loads that had to read and decompress the blob
+        int    fMisses = 0;
+        int    fStores = 0;
+    };
+
+    // Opens (creating if needed) the cache in 'directory'. If 'prefetchExecutor' is not null, blobs
+    // are loaded on it in usage order; it must outlive this cache.
+    DiskProgramCache(const char* directory, SkExecutor* prefetchExecutor = nullptr);
+    ~DiskProgramCache() override;
+
+    DiskProgramCache(const DiskProgramCache&) = delete;
+    DiskProgramCache& operator=(const DiskProgramCache&) = delete;
+
+    sk_sp<SkData> load(const SkData& key) override;
+    void store(const SkData& key, const SkData& data, const SkString& description) override;
+
+    // Writes the index, including the current load counts. Returns false if it couldn't be written.
+    bool flush();
+
+    // Blocks until the background prefetch (if any) has finished.
+    void waitForPrefetch();
+
+    Stats stats() const;
+
+    // Calls fn(key, data, description, hitCount) for every entry, hottest first. Entries that
+    // haven't been loaded into memory yet are read from disk.
+    template <typename Fn>
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fEntries.size(); ++i) {
+            sk_sp<SkData> data = this->entryData(i);
+            fn(fEntries[i].fKey, data, fEntries[i].fDescription, fEntries[i].fHitCount);
+        }
+    }
+
+    // Exposed for testing: the LZ-style block compression used for the blobs on disk.
+    static sk_sp<SkData> Compress(const void* data, size_t size);
+    static sk_sp<SkData> Decompress(const void* data, size_t size);
+
+private:
+    struct Entry {
+        sk_sp<const SkData> fKey;
+        SkMD5::Digest       fDigest;
+        SkString            fDescription;
+        int                 fHitCount = 0;
+        sk_sp<SkData>       fData;      // null until loaded; guarded by fDataMutex
+    };
+
+    struct KeyRef {
+        const SkData* fKey;
+        bool operator==(const KeyRef& that) const { return fKey->equals(that.fKey); }
+    };
+    struct KeyHash {
+        uint32_t operator()(const KeyRef& key) const {
+            return SkChecksum::Hash32(key.fKey->data(), key.fKey->size());
+        }
+    };
+    struct DigestHash {
+        uint32_t operator()(const SkMD5::Digest& digest) const {
+            return SkChecksum::Hash32(digest.data, sizeof(digest.data));
+        }
+    };
+
+    SkString blobPath(const SkMD5::Digest&) const;
+    // Deletes blobs that the index doesn't refer to and temporary files left by failed writes.
+    void removeUnreferencedFiles();
+    // Deletes the blob and forgets its sizes if no entry refers to it.
+    void releaseBlob(const SkMD5::Digest&);
+    bool readIndex();
+    void prefetch();
+    sk_sp<SkData> readBlob(const SkMD5::Digest&, size_t* diskSize) const;
+    sk_sp<SkData> entryData(int index);
+
+    const SkString fDirectory;
+
+    // Entries are sorted by fHitCount when the index is read; new ones are appended.
+    skia_private::TArray<Entry> fEntries;
+    skia_private::THashMap<KeyRef, int, KeyHash> fKeyToEntry;
+    // Uncompressed and on-disk sizes of every blob in the directory that an entry refers to. Blobs
+    // that couldn't be read are removed, so that storing their program writes them again.
+    skia_private::THashMap<SkMD5::Digest, std::pair<size_t, size_t>, DigestHash> fBlobs;
+
+    mutable SkMutex fDataMutex;
+    std::unique_ptr<SkTaskGroup> fPrefetchTasks;
+    bool fIndexDirty = false;
+
+    Stats fStats;
+};
+
+}  // namespace sk_gpu_test
+
+#endif
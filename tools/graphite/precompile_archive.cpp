@@ -0,0 +1,359 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Expands PaintOptions into every PaintParamsKey and RenderStep pairing Precompile() would build,
+// generates the SkSL for each and translates it for the backend, and writes the distinct shaders
+// to an archive, so that an app can ship them rather than generate them on the device.
+//
+// A Context for the chosen backend supplies the Caps, shader dictionary and RenderSteps, since
+// they depend on the backend, but no pipelines are created and nothing is submitted to the GPU.
+//
+// Archive layout, all integers little-endian uint32:
+//   "SKSA", version, backend (the shader language as a 4 byte tag: "SPRV", "WGSL" or "MSL ")
+//   shader count, then per shader: byte length, bytes (padded to 4)
+//   pipeline count, then per pipeline:
+//       vertex shader index, fragment shader index (~0 if the step does no shading),
+//       render step name, paint key description (each as length + bytes, padded to 4)
+
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/gpu/graphite/Context.h"
+#include "include/gpu/graphite/GraphiteTypes.h"
+#include "include/gpu/graphite/precompile/PaintOptions.h"
+#include "include/gpu/graphite/precompile/PrecompileShader.h"
+#include "include/private/base/SkAlign.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkTHash.h"
+#include "src/gpu/PipelineUtils.h"
+#include "src/gpu/Swizzle.h"
+#include "src/gpu/graphite/Caps.h"
+#include "src/gpu/graphite/ContextPriv.h"
+#include "src/gpu/graphite/ContextUtils.h"
+#include "src/gpu/graphite/KeyContext.h"
+#include "src/gpu/graphite/PaintParamsKey.h"
+#include "src/gpu/graphite/PipelineData.h"
+#include "src/gpu/graphite/PrecompileInternal.h"
+#include "src/gpu/graphite/Renderer.h"
+#include "src/gpu/graphite/RendererProvider.h"
+#include "src/gpu/graphite/RuntimeEffectDictionary.h"
+#include "src/gpu/graphite/ShaderCodeDictionary.h"
+#include "src/gpu/graphite/UniquePaintParamsID.h"
+#include "src/gpu/graphite/precompile/PaintOptionsPriv.h"
+#include "src/sksl/SkSLProgramKind.h"
+#include "src/sksl/SkSLProgramSettings.h"
+#include "src/sksl/codegen/SkSLMetalCodeGenerator.h"
+#include "src/sksl/codegen/SkSLSPIRVCodeGenerator.h"
+#include "src/sksl/codegen/SkSLWGSLCodeGenerator.h"
+#include "src/sksl/ir/SkSLProgram.h"
+#include "tools/flags/CommandLineFlags.h"
+#include "tools/gpu/ContextType.h"
+#include "tools/graphite/ContextFactory.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace skgpu::graphite;
+
+static DEFINE_string(config, "vk",
+                     "Backend to generate shaders for: vk (SPIR-V), mtl (MSL), or "
+                     "dawn_vk, dawn_mtl, dawn_d3d11, dawn_d3d12 (WGSL).");
+static DEFINE_string(presets, "solid image gradients blends",
+                     "PaintOptions to expand: any of solid, image, gradients and blends.");
+static DEFINE_string2(out, o, "precompile.sksa", "Path of the shader archive to write.");
+static DEFINE_bool2(verbose, v, false, "Print each pipeline as it's generated.");
+
+namespace {
+
+struct Backend {
+    const char*         fConfig;
+    skgpu::ContextType  fContextType;
+    const char*         fTag;
+    bool (*fToBackend)(SkSL::Program&, const SkSL::ShaderCaps*, std::string*);
+    const char*         fLabel;
+};
+
+const Backend kBackends[] = {
+    {"vk",         skgpu::ContextType::kVulkan,      "SPRV", &SkSL::ToSPIRV, nullptr},
+    {"mtl",        skgpu::ContextType::kMetal,       "MSL ", &SkSL::ToMetal, "MSL"},
+    {"dawn_vk",    skgpu::ContextType::kDawn_Vulkan, "WGSL", &SkSL::ToWGSL,  "WGSL"},
+    {"dawn_mtl",   skgpu::ContextType::kDawn_Metal,  "WGSL", &SkSL::ToWGSL,  "WGSL"},
+    {"dawn_d3d11", skgpu::ContextType::kDawn_D3D11,  "WGSL", &SkSL::ToWGSL,  "WGSL"},
+    {"dawn_d3d12", skgpu::ContextType::kDawn_D3D12,  "WGSL", &SkSL::ToWGSL,  "WGSL"},
+};
+
+bool make_preset(const char* name, PaintOptions* options) {
+    if (!strcmp(name, "solid")) {
+        options->setShaders({ PrecompileShaders::Color() });
+        options->setBlendModes({ SkBlendMode::kSrcOver, SkBlendMode::kSrc });
+    } else if (!strcmp(name, "image")) {
+        options->setShaders({ PrecompileShaders::Image() });
+        options->setBlendModes({ SkBlendMode::kSrcOver });
+    } else if (!strcmp(name, "gradients")) {
+        options->setShaders({ PrecompileShaders::LinearGradient(),
+                              PrecompileShaders::RadialGradient(),
+                              PrecompileShaders::SweepGradient(),
+                              PrecompileShaders::TwoPointConicalGradient() });
+        options->setBlendModes({ SkBlendMode::kSrcOver });
+    } else if (!strcmp(name, "blends")) {
+        options->setShaders({ PrecompileShaders::Color() });
+        options->setBlendModes({ SkBlendMode::kSrcOver, SkBlendMode::kSrc, SkBlendMode::kDstIn,
+                                 SkBlendMode::kPlus, SkBlendMode::kMultiply,
+                                 SkBlendMode::kScreen, SkBlendMode::kOverlay });
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// A RenderStep paired with the paint it shades with; the unit a pipeline is built from.
+struct PipelineKey {
+    uint32_t fRenderStepID;
+    uint32_t fPaintID;
+
+    bool operator==(const PipelineKey& that) const {
+        return fRenderStepID == that.fRenderStepID && fPaintID == that.fPaintID;
+    }
+};
+
+struct Pipeline {
+    const RenderStep*  fStep;
+    UniquePaintParamsID fPaintID;
+    uint32_t fVertexShader = 0;
+    uint32_t fFragmentShader = ~0u;
+};
+
+constexpr uint32_t kArchiveVersion = 1;
+
+// Holds each distinct translated shader once, however many pipelines share it.
+class ShaderTable {
+public:
+    uint32_t add(std::string shader) {
+        if (const uint32_t* index = fIndices.find(shader)) {
+            return *index;
+        }
+        const uint32_t index = SkToU32(fShaders.size());
+        fIndices.set(shader, index);
+        fShaders.push_back(std::move(shader));
+        return index;
+    }
+
+    const std::vector<std::string>& shaders() const { return fShaders; }
+
+private:
+    struct Hash {
+        uint32_t operator()(const std::string& s) const {
+            return SkChecksum::Hash32(s.data(), s.size());
+        }
+    };
+
+    skia_private::THashMap<std::string, uint32_t, Hash> fIndices;
+    std::vector<std::string> fShaders;
+};
+
+void write_padded(SkWStream* out, const void* data, size_t length) {
+    out->write32(SkToU32(length));
+    out->write(data, length);
+    static constexpr char kZeros[4] = {};
+    out->write(kZeros, SkAlign4(length) - length);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    CommandLineFlags::SetUsage(
+            "Writes the translated shaders for a set of PaintOptions to a shader archive.");
+    CommandLineFlags::Parse(argc, argv);
+
+    const Backend* backend = nullptr;
+    for (const Backend& b : kBackends) {
+        if (!strcmp(FLAGS_config[0], b.fConfig)) {
+            backend = &b;
+        }
+    }
+    if (!backend) {
+        SkDebugf("Unknown config '%s'.\n", FLAGS_config[0]);
+        return 1;
+    }
+
+    std::vector<PaintOptions> paintOptions;
+    for (int i = 0; i < FLAGS_presets.size(); ++i) {
+        PaintOptions options;
+        if (!make_preset(FLAGS_presets[i], &options)) {
+            SkDebugf("Unknown preset '%s'.\n", FLAGS_presets[i]);
+            return 1;
+        }
+        paintOptions.push_back(std::move(options));
+    }
+
+    skiatest::graphite::ContextFactory factory;
+    Context* context = factory.getContextInfo(backend->fContextType).fContext;
+    if (!context) {
+        SkDebugf("Could not make a %s context to source the caps from.\n",
+                 skgpu::ContextTypeName(backend->fContextType));
+        return 1;
+    }
+    const Caps* caps = context->priv().caps();
+    ShaderCodeDictionary* dict = context->priv().shaderCodeDictionary();
+    const RendererProvider* renderers = context->priv().rendererProvider();
+    auto rtEffectDict = std::make_unique<RuntimeEffectDictionary>();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Expand the PaintOptions just as Precompile() does, but gather the pipelines rather than
+    // creating them.
+    SkColorInfo ci(kRGBA_8888_SkColorType, kPremul_SkAlphaType, nullptr);
+    KeyContext keyContext(caps, dict, rtEffectDict.get(), ci,
+                          /* dstTexture= */ nullptr, /* dstOffset= */ {0, 0});
+    PipelineDataGatherer gatherer(caps, Layout::kMetal);
+
+    struct PipelineKeyHash {
+        uint32_t operator()(const PipelineKey& k) const {
+            return SkChecksum::Hash32(&k, sizeof(k));
+        }
+    };
+    skia_private::THashSet<PipelineKey, PipelineKeyHash> seen;
+    std::vector<Pipeline> pipelines;
+    int combinations = 0;
+
+    auto gather = [&](UniquePaintParamsID paintID, DrawTypeFlags drawTypes,
+                      bool withPrimitiveBlender, Coverage coverage) {
+        ++combinations;
+        for (const Renderer* r : renderers->renderers()) {
+            if (!(r->drawTypes() & drawTypes) ||
+                r->emitsPrimitiveColor() != withPrimitiveBlender ||
+                r->coverage() != coverage) {
+                continue;
+            }
+            for (const RenderStep* step : r->steps()) {
+                const UniquePaintParamsID stepPaintID = step->performsShading()
+                        ? paintID : UniquePaintParamsID::InvalidID();
+                const PipelineKey key{step->uniqueID(), stepPaintID.asUInt()};
+                if (!seen.contains(key)) {
+                    seen.add(key);
+                    pipelines.push_back({step, stepPaintID});
+                }
+            }
+        }
+    };
+
+    for (const PaintOptions& options : paintOptions) {
+        for (Coverage coverage : { Coverage::kNone, Coverage::kSingleChannel, Coverage::kLCD }) {
+            options.priv().buildCombinations(
+                    keyContext, &gatherer,
+                    static_cast<DrawTypeFlags>(DrawTypeFlags::kAll & ~DrawTypeFlags::kDrawVertices),
+                    /* withPrimitiveBlender= */ false, coverage, gather);
+            for (bool withPrimitiveBlender : { true, false }) {
+                options.priv().buildCombinations(keyContext, &gatherer,
+                                                 DrawTypeFlags::kDrawVertices,
+                                                 withPrimitiveBlender, coverage, gather);
+            }
+        }
+    }
+
+    const auto enumerated = std::chrono::steady_clock::now();
+
+    // Generate and translate each pipeline's shaders, keeping only the distinct outputs.
+    SkSL::ProgramSettings settings;
+    settings.fForceNoRTFlip = true;
+    const bool useStorageBuffers = caps->storageBufferPreferred();
+    ShaderTable shaders;
+    size_t skslBytes = 0;
+    int failures = 0;
+
+    auto translate = [&](const std::string& sksl, SkSL::ProgramKind kind, uint32_t* index) {
+        std::string translated;
+        SkSL::ProgramInterface interface;
+        skslBytes += sksl.size();
+        if (!skgpu::SkSLToBackend(caps->shaderCaps(), backend->fToBackend, backend->fLabel,
+                                  sksl, kind, settings, &translated, &interface,
+                                  caps->shaderErrorHandler())) {
+            return false;
+        }
+        *index = shaders.add(std::move(translated));
+        return true;
+    };
+
+    for (Pipeline& pipeline : pipelines) {
+        FragSkSLInfo fsInfo = BuildFragmentSkSL(caps, dict, rtEffectDict.get(), pipeline.fStep,
+                                                pipeline.fPaintID, useStorageBuffers,
+                                                skgpu::Swizzle::RGBA());
+        bool ok = fsInfo.fSkSL.empty() ||
+                  translate(fsInfo.fSkSL, SkSL::ProgramKind::kGraphiteFragment,
+                            &pipeline.fFragmentShader);
+
+        VertSkSLInfo vsInfo = BuildVertexSkSL(caps->resourceBindingRequirements(),
+                                              pipeline.fStep, useStorageBuffers,
+                                              fsInfo.fRequiresLocalCoords);
+        ok = ok && translate(vsInfo.fSkSL, SkSL::ProgramKind::kGraphiteVertex,
+                             &pipeline.fVertexShader);
+        if (!ok) {
+            ++failures;
+            pipeline.fStep = nullptr;
+            continue;
+        }
+        if (FLAGS_verbose) {
+            SkDebugf("%s + %s\n", pipeline.fStep->name(),
+                     dict->lookup(pipeline.fPaintID).toString(dict).c_str());
+        }
+    }
+
+    const auto generated = std::chrono::steady_clock::now();
+
+    SkFILEWStream out(FLAGS_out[0]);
+    if (!out.isValid()) {
+        SkDebugf("Could not open '%s' for writing.\n", FLAGS_out[0]);
+        return 1;
+    }
+    out.write("SKSA", 4);
+    out.write32(kArchiveVersion);
+    out.write(backend->fTag, 4);
+    out.write32(SkToU32(shaders.shaders().size()));
+    for (const std::string& shader : shaders.shaders()) {
+        write_padded(&out, shader.data(), shader.size());
+    }
+    out.write32(SkToU32(pipelines.size() - failures));
+    for (const Pipeline& pipeline : pipelines) {
+        if (!pipeline.fStep) {
+            continue;
+        }
+        out.write32(pipeline.fVertexShader);
+        out.write32(pipeline.fFragmentShader);
+        const char* stepName = pipeline.fStep->name();
+        write_padded(&out, stepName, strlen(stepName));
+        const SkString paintName = pipeline.fPaintID.isValid()
+                ? dict->lookup(pipeline.fPaintID).toString(dict) : SkString();
+        write_padded(&out, paintName.c_str(), paintName.size());
+    }
+    out.flush();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    const double enumerateMs = ms(enumerated - start).count(),
+                 generateMs  = ms(generated - enumerated).count();
+    size_t shaderBytes = 0;
+    for (const std::string& shader : shaders.shaders()) {
+        shaderBytes += shader.size();
+    }
+
+    SkDebugf("%d paint combinations -> %zu pipelines in %.1f ms\n",
+             combinations, pipelines.size(), enumerateMs);
+    SkDebugf("generated %zu pipelines (%d failed) in %.1f ms: %.0f pipelines/s, %.1f MB/s of SkSL\n",
+             pipelines.size() - failures, failures, generateMs,
+             (pipelines.size() - failures) / (generateMs / 1000),
+             skslBytes / (generateMs / 1000) / (1 << 20));
+    SkDebugf("%zu distinct %s shaders, %zu bytes; archive '%s' is %zu bytes\n",
+             shaders.shaders().size(), backend->fConfig, shaderBytes, FLAGS_out[0],
+             out.bytesWritten());
+    return failures ? 1 : 0;
+}